@@ -0,0 +1,246 @@
+################ READ ME ################
+#
+# Compile-throughput benchmark. Generates
+# programs of increasing size for several
+# workloads, compiles each with
+# `./lang --time-report=json` and reports
+# lines per second for every phase and the
+# peak memory. Run with 'make bench' or
+# 'python3 benchmark.py --help'.
+#
+# Every run is appended to bench_output.txt
+# (one JSON object per line) and compared
+# with the previous run in that file.
+
+from argparse import ArgumentParser
+from datetime import datetime
+from json import dumps, loads
+from os import path, remove
+from subprocess import Popen, PIPE
+from tempfile import NamedTemporaryFile
+
+PHASES = ["parse", "typecheck", "codegen", "output"]
+
+# Each workload generates a program of about size lines, except
+# for inheritance: every class holds all of its inherited members,
+# so its cost grows with the square of the depth, and the depth is
+# the square root of the size instead.
+
+def manyClasses(size):
+	lines = []
+	for i in range(max(size // 15, 1)):
+		lines += [
+			"C%d {" % i,
+			"	integer value;",
+			"	boolean flag;",
+			"	C%d(integer start) -> none {" % i,
+			"		value = start;",
+			"		flag = start > %d;" % i,
+			"	}",
+			"	get() -> integer {",
+			"		return value * %d + 1;" % (i % 7),
+			"	}",
+			"	set(integer v, boolean f) -> none {",
+			"		value = v;",
+			"		flag = f;",
+			"	}",
+			"}",
+		]
+	lines += ["Main {", "	main() -> none {", "		C0 c;", "		c = new C0(1);", "		print c.get();", "	}", "}"]
+	return lines
+
+def deepInheritance(size):
+	depth = max(int(size ** 0.5), 2)
+	lines = ["C0 {", "	integer m0;", "	f0() -> integer {", "		return m0;", "	}", "}"]
+	for i in range(1, depth):
+		lines += [
+			"C%d extends C%d {" % (i, i - 1),
+			"	integer m%d;" % i,
+			"	f%d() -> integer {" % i,
+			"		m%d = m0 + %d;" % (i, i),
+			"		return f0() + m%d;" % i,
+			"	}",
+			"}",
+		]
+	last = depth - 1
+	lines += [
+		"Main {",
+		"	main() -> none {",
+		"		C%d c;" % last,
+		"		c = new C%d();" % last,
+		"		print c.f%d();" % last,
+		"		print c.f0();",
+		"	}",
+		"}",
+	]
+	return lines
+
+def hugeMethodBody(size):
+	lines = ["Main {", "	main() -> none {", "		integer a, b, i;", "		boolean p;", "		a = 0;", "		b = 1;"]
+	for i in range(max(size // 11, 1)):
+		lines += [
+			"		a = a + b * %d;" % (i % 13),
+			"		if a > %d {" % (i * 3),
+			"			b = b - 1;",
+			"		} else {",
+			"			p = a equals b;",
+			"		}",
+			"		i = 0;",
+			"		while %d > i {" % (i % 5 + 1),
+			"			i = i + 1;",
+			"		}",
+			"		print a;",
+		]
+	lines += ["	}", "}"]
+	return lines
+
+def longExpressions(size):
+	lines = ["Main {", "	main() -> none {", "		integer a, b, c;", "		a = 1;", "		b = 2;", "		c = 3;"]
+	for statement in range(10):
+		lines.append("		a = a")
+		operators = ["+", "-", "*", "+"]
+		for i in range(size // 10):
+			lines.append("			%s %s" % (operators[i % 4], ["a", "b", "c", str(i % 97)][i % 4]))
+		lines[-1] += ";"
+	lines += ["		print a;", "	}", "}"]
+	return lines
+
+def manyLocals(size):
+	lines = ["Main {", "	main() -> none {"]
+	for i in range(size // 2):
+		lines.append("		%s v%d;" % ("integer" if i % 3 else "boolean", i))
+	for i in range(size // 2):
+		if i % 3:
+			previous = i - 1 if (i - 1) % 3 else i
+			lines.append("		v%d = v%d + %d;" % (i, previous, i))
+		else:
+			lines.append("		v%d = true;" % i)
+	lines += ["		print v1;", "	}", "}"]
+	return lines
+
+WORKLOADS = [
+	("classes", manyClasses),
+	("inheritance", deepInheritance),
+	("body", hugeMethodBody),
+	("expression", longExpressions),
+	("locals", manyLocals),
+]
+
+def compileOnce(lang, source):
+	with open(source, "r") as infile:
+		p = Popen([lang, "--time-report=json"], stdin=infile, stdout=PIPE, stderr=PIPE)
+		(out, err) = p.communicate()
+	err = err.decode("utf-8")
+	start = err.find("{")
+	if p.returncode != 0 or start < 0:
+		raise RuntimeError(err.strip())
+	return loads(err[start:])
+
+def measure(lang, workload, generate, size, repeats):
+	lines = generate(size)
+	with NamedTemporaryFile("w", suffix=".lang", delete=False) as source:
+		source.write("\n".join(lines) + "\n")
+	try:
+		reports = [compileOnce(lang, source.name) for i in range(repeats)]
+	finally:
+		remove(source.name)
+
+	# the fastest of the runs is the one least disturbed by noise
+	phases = {}
+	for name in PHASES:
+		runs = [[p for p in r["phases"] if p["name"] == name][0] for r in reports]
+		wall = min(run["wall_ms"] for run in runs)
+		phases[name] = {
+			"wall_ms": wall,
+			"cpu_ms": min(run["cpu_ms"] for run in runs),
+			"lines_per_second": len(lines) / (wall / 1000.0) if wall > 0 else 0,
+			"allocations": runs[0]["allocations"],
+			"symbol_lookups": runs[0]["symbol_lookups"],
+		}
+
+	return {
+		"workload": workload,
+		"size": size,
+		"lines": len(lines),
+		"phases": phases,
+		"total_ms": sum(phases[name]["wall_ms"] for name in PHASES),
+		"peak_rss_kb": max(p["peak_rss_kb"] for r in reports for p in r["phases"]),
+		"ast_nodes": sum(reports[0]["ast_nodes"].values()),
+		"instructions": sum(reports[0]["instructions"].values()),
+	}
+
+def revision():
+	p = Popen(["git", "describe", "--always", "--dirty"], stdout=PIPE, stderr=PIPE, cwd=path.dirname(path.abspath(__file__)))
+	(out, err) = p.communicate()
+	return out.decode("utf-8").strip() if p.returncode == 0 else "unknown"
+
+def previousRun(output):
+	if not path.isfile(output):
+		return None
+	with open(output, "r") as f:
+		runs = [line for line in f if line.strip()]
+	return loads(runs[-1]) if runs else None
+
+def printResult(result, previous):
+	row = "%-12s %7d %8d" % (result["workload"], result["size"], result["lines"])
+	for name in PHASES:
+		row += " %11.1f" % (result["phases"][name]["lines_per_second"] / 1000.0)
+	row += " %10.2f %8.1f" % (result["total_ms"], result["peak_rss_kb"] / 1024.0)
+	if previous:
+		change = (result["total_ms"] - previous["total_ms"]) / previous["total_ms"] * 100 if previous["total_ms"] else 0
+		row += " %+7.1f%%" % change
+	print(row)
+
+def main():
+	parser = ArgumentParser(description="Measure the compiler's throughput on generated programs.")
+	parser.add_argument("--lang", default="./lang", help="the compiler to measure")
+	parser.add_argument("--sizes", default="1000,4000,16000,64000", help="comma separated program sizes")
+	parser.add_argument("--workloads", default=",".join(w[0] for w in WORKLOADS), help="comma separated workloads")
+	parser.add_argument("--repeats", type=int, default=3, help="compilations per program (the fastest is kept)")
+	parser.add_argument("--output", default="bench_output.txt", help="file the results are appended to")
+	parser.add_argument("--no-record", action="store_true", help="do not append the results to the output file")
+	args = parser.parse_args()
+
+	if not path.isfile(args.lang):
+		print("No `" + args.lang + "` executable.")
+		return 1
+
+	sizes = [int(s) for s in args.sizes.split(",")]
+	selected = args.workloads.split(",")
+	unknown = [w for w in selected if w not in dict(WORKLOADS)]
+	if unknown:
+		print("Unknown workloads: " + ", ".join(unknown))
+		return 1
+
+	previous = previousRun(args.output)
+	previousResults = {}
+	if previous:
+		print("Comparing with " + previous["revision"] + " (" + previous["date"] + ")")
+		for r in previous["results"]:
+			previousResults[(r["workload"], r["size"])] = r
+
+	header = "%-12s %7s %8s" % ("workload", "size", "lines")
+	for name in PHASES:
+		header += " %11s" % (name + " kl/s")
+	header += " %10s %8s" % ("total ms", "peak MB")
+	if previous:
+		header += " %8s" % "change"
+	print(header)
+
+	results = []
+	for (workload, generate) in WORKLOADS:
+		if workload not in selected:
+			continue
+		for size in sizes:
+			result = measure(args.lang, workload, generate, size, args.repeats)
+			printResult(result, previousResults.get((workload, size)))
+			results.append(result)
+
+	if not args.no_record:
+		run = {"revision": revision(), "date": datetime.now().isoformat(), "repeats": args.repeats, "results": results}
+		with open(args.output, "a") as f:
+			f.write(dumps(run) + "\n")
+	return 0
+
+if __name__ == "__main__":
+	exit(main())
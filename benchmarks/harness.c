@@ -0,0 +1,378 @@
+// Runtime benchmark harness for the generated code.
+//
+// Usage: benchmarks/harness [-n RUNS] [--no-build] [--baseline FILE]
+//                           [--save-baseline] [NAME...]
+//
+// Builds every benchmarks/NAME.lang (or just the ones named) with
+// `make benchmarks/NAME`, runs each program RUNS times and reports
+// the median wall time and hardware counters (instructions retired,
+// cycles, branch misses and cache misses, read with perf_event_open)
+// next to the change from the stored baseline. The output of the
+// first run must match benchmarks/NAME.expected if that file exists.
+//
+// --save-baseline stores the results as the new baseline. The exit
+// status is 1 if a benchmark failed to build, crashed or printed the
+// wrong output.
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#define MAX_BENCHMARKS 256
+#define MAX_RUNS 101
+#define NUM_COUNTERS 4
+
+static const char* counterNames[NUM_COUNTERS] = { "instructions", "cycles", "branch-misses", "cache-misses" };
+
+// Defines the measurements for one benchmark; a counter is -1 if it
+// could not be read.
+struct result {
+  char name[128];
+  double wall;
+  int64_t counters[NUM_COUNTERS];
+};
+
+// The error from the last perf_event_open that failed, if any
+static int counterError = 0;
+
+static double now() {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1000.0 + t.tv_nsec / 1000000.0;
+}
+
+// Opens a counter for the (not yet executed) process pid, which
+// starts counting when the process calls exec.
+static int openCounter(pid_t pid, int counter) {
+#ifdef __linux__
+  static const uint64_t configs[NUM_COUNTERS] = {
+    PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_MISSES
+  };
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = configs[counter];
+  attr.disabled = 1;
+  attr.enable_on_exec = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  int fd = syscall(__NR_perf_event_open, &attr, pid, -1, -1, 0);
+  if (fd < 0) {
+    counterError = errno;
+  }
+  return fd;
+#else
+  counterError = ENOSYS;
+  return -1;
+#endif
+}
+
+// Reads a counter, scaling it up if it was multiplexed with others.
+static int64_t readCounter(int fd) {
+  uint64_t values[3];
+  if (fd < 0 || read(fd, values, sizeof(values)) != sizeof(values) || values[2] == 0) {
+    return -1;
+  }
+  return (int64_t)((double)values[0] * values[1] / values[2]);
+}
+
+// Runs a program once, writing its output to the file output.
+// Returns 0 if it ran and exited with status 0.
+static int runOnce(const char* program, const char* output, struct result* sample) {
+  int go[2];
+  if (pipe(go) < 0) {
+    return -1;
+  }
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    return -1;
+  }
+  if (pid == 0) {
+    // wait until the counters are attached before running the program
+    char c;
+    int fd = open(output, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    close(go[1]);
+    if (fd < 0 || dup2(fd, 1) < 0 || read(go[0], &c, 1) != 1) {
+      _exit(127);
+    }
+    execl(program, program, (char*)NULL);
+    _exit(127);
+  }
+
+  close(go[0]);
+  int fds[NUM_COUNTERS];
+  for (int i = 0; i < NUM_COUNTERS; i++) {
+    fds[i] = openCounter(pid, i);
+  }
+
+  int status;
+  double start = now();
+  if (write(go[1], "x", 1) != 1) {
+    kill(pid, SIGKILL);
+  }
+  close(go[1]);
+  waitpid(pid, &status, 0);
+  sample->wall = now() - start;
+
+  for (int i = 0; i < NUM_COUNTERS; i++) {
+    sample->counters[i] = readCounter(fds[i]);
+    if (fds[i] >= 0) {
+      close(fds[i]);
+    }
+  }
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : -1;
+}
+
+static int compareDoubles(const void* a, const void* b) {
+  double x = *(const double*)a, y = *(const double*)b;
+  return x < y ? -1 : x > y;
+}
+
+static int compareInts(const void* a, const void* b) {
+  int64_t x = *(const int64_t*)a, y = *(const int64_t*)b;
+  return x < y ? -1 : x > y;
+}
+
+static int compareNames(const void* a, const void* b) {
+  return strcmp((const char*)a, (const char*)b);
+}
+
+// Returns 1 if the two files have the same contents.
+static int sameContents(const char* a, const char* b) {
+  FILE* f = fopen(a, "r");
+  FILE* g = fopen(b, "r");
+  int same = f && g;
+  while (same) {
+    int c = fgetc(f), d = fgetc(g);
+    same = c == d;
+    if (c == EOF) {
+      break;
+    }
+  }
+  if (f) fclose(f);
+  if (g) fclose(g);
+  return same;
+}
+
+// Builds and measures one benchmark. Returns 0 on success.
+static int measure(const char* name, int runs, int build, struct result* r) {
+  char command[512], program[256], expected[256], output[] = "/tmp/harness-XXXXXX";
+
+  snprintf(program, sizeof(program), "benchmarks/%s", name);
+  snprintf(expected, sizeof(expected), "benchmarks/%s.expected", name);
+  if (build) {
+    snprintf(command, sizeof(command), "make -s %s", program);
+    if (system(command) != 0) {
+      fprintf(stderr, "%s: build failed\n", name);
+      return -1;
+    }
+  }
+
+  int fd = mkstemp(output);
+  if (fd < 0) {
+    return -1;
+  }
+  close(fd);
+
+  double walls[MAX_RUNS];
+  int64_t counters[NUM_COUNTERS][MAX_RUNS];
+  int failed = 0;
+  for (int i = 0; i < runs && !failed; i++) {
+    struct result sample = { "", 0, { -1, -1, -1, -1 } };
+    if (runOnce(program, i == 0 ? output : "/dev/null", &sample) != 0) {
+      fprintf(stderr, "%s: exited with an error\n", name);
+      failed = 1;
+    } else if (i == 0 && access(expected, R_OK) == 0 && !sameContents(output, expected)) {
+      fprintf(stderr, "%s: output differs from %s\n", name, expected);
+      failed = 1;
+    }
+    walls[i] = sample.wall;
+    for (int c = 0; c < NUM_COUNTERS; c++) {
+      counters[c][i] = sample.counters[c];
+    }
+  }
+  unlink(output);
+  if (failed) {
+    return -1;
+  }
+
+  // the median is not thrown off by a single disturbed run
+  strncpy(r->name, name, sizeof(r->name) - 1);
+  qsort(walls, runs, sizeof(double), compareDoubles);
+  r->wall = walls[runs / 2];
+  for (int c = 0; c < NUM_COUNTERS; c++) {
+    qsort(counters[c], runs, sizeof(int64_t), compareInts);
+    r->counters[c] = counters[c][runs / 2];
+  }
+  return 0;
+}
+
+static int loadBaseline(const char* path, struct result* baseline) {
+  FILE* f = fopen(path, "r");
+  if (!f) {
+    return 0;
+  }
+  int n = 0;
+  char line[512];
+  while (n < MAX_BENCHMARKS && fgets(line, sizeof(line), f)) {
+    struct result* r = &baseline[n];
+    memset(r, 0, sizeof(*r));
+    if (line[0] != '#' && sscanf(line, "%127s %lf %lld %lld %lld %lld", r->name, &r->wall,
+        (long long*)&r->counters[0], (long long*)&r->counters[1], (long long*)&r->counters[2], (long long*)&r->counters[3]) == 6) {
+      n++;
+    }
+  }
+  fclose(f);
+  return n;
+}
+
+// Writes the results into the baseline, keeping the entries of the
+// benchmarks that were not run.
+static int saveBaseline(const char* path, struct result* results, int count, struct result* baseline, int baselineCount) {
+  FILE* f = fopen(path, "w");
+  if (!f) {
+    perror(path);
+    return -1;
+  }
+  fprintf(f, "# name wall_ms instructions cycles branch_misses cache_misses\n");
+  for (int i = 0; i < baselineCount; i++) {
+    int replaced = 0;
+    for (int j = 0; j < count; j++) {
+      replaced = replaced || !strcmp(baseline[i].name, results[j].name);
+    }
+    if (!replaced) {
+      results[count++] = baseline[i];
+    }
+  }
+  qsort(results, count, sizeof(struct result), compareNames);
+  for (int i = 0; i < count; i++) {
+    struct result* r = &results[i];
+    fprintf(f, "%s %.3f %lld %lld %lld %lld\n", r->name, r->wall, (long long)r->counters[0],
+            (long long)r->counters[1], (long long)r->counters[2], (long long)r->counters[3]);
+  }
+  fclose(f);
+  return 0;
+}
+
+static void printCount(int64_t value, int width) {
+  if (value < 0) {
+    printf(" %*s", width, "-");
+  } else {
+    printf(" %*lld", width, (long long)value);
+  }
+}
+
+static void printChange(double value, double base) {
+  if (value < 0 || base <= 0) {
+    printf(" %8s", "");
+  } else {
+    printf(" %+7.1f%%", (value - base) / base * 100);
+  }
+}
+
+int main(int argc, char** argv) {
+  int runs = 5, build = 1, save = 0;
+  const char* baselinePath = "benchmarks/baseline.txt";
+  static char names[MAX_BENCHMARKS][128];
+  int count = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+      runs = atoi(argv[++i]);
+      if (runs < 1 || runs > MAX_RUNS) {
+        fprintf(stderr, "The number of runs must be between 1 and %d\n", MAX_RUNS);
+        return 2;
+      }
+    } else if (!strcmp(argv[i], "--no-build")) {
+      build = 0;
+    } else if (!strcmp(argv[i], "--baseline") && i + 1 < argc) {
+      baselinePath = argv[++i];
+    } else if (!strcmp(argv[i], "--save-baseline")) {
+      save = 1;
+    } else if (argv[i][0] != '-' && count < MAX_BENCHMARKS) {
+      strncpy(names[count++], argv[i], 127);
+    } else {
+      fprintf(stderr, "Unknown option: %s\n", argv[i]);
+      return 2;
+    }
+  }
+
+  if (count == 0) {
+    DIR* dir = opendir("benchmarks");
+    struct dirent* entry;
+    while (dir && (entry = readdir(dir)) && count < MAX_BENCHMARKS) {
+      size_t length = strlen(entry->d_name);
+      if (length > 5 && length < 128 && !strcmp(entry->d_name + length - 5, ".lang")) {
+        memcpy(names[count], entry->d_name, length - 5);
+        names[count++][length - 5] = '\0';
+      }
+    }
+    if (dir) {
+      closedir(dir);
+    }
+    qsort(names, count, sizeof(names[0]), compareNames);
+  }
+
+  static struct result baseline[MAX_BENCHMARKS], results[2 * MAX_BENCHMARKS];
+  int baselineCount = loadBaseline(baselinePath, baseline);
+
+  printf("%-12s %10s %14s %14s %6s %12s %12s", "benchmark", "wall ms", counterNames[0], counterNames[1], "IPC", counterNames[2], counterNames[3]);
+  printf(baselineCount ? " %8s %8s\n" : "\n", "wall", "instr");
+
+  int measured = 0, status = 0;
+  for (int i = 0; i < count; i++) {
+    struct result* r = &results[measured];
+    if (measure(names[i], runs, build, r) != 0) {
+      status = 1;
+      continue;
+    }
+    measured++;
+
+    printf("%-12s %10.2f", r->name, r->wall);
+    printCount(r->counters[0], 14);
+    printCount(r->counters[1], 14);
+    if (r->counters[0] > 0 && r->counters[1] > 0) {
+      printf(" %6.2f", (double)r->counters[0] / r->counters[1]);
+    } else {
+      printf(" %6s", "-");
+    }
+    printCount(r->counters[2], 12);
+    printCount(r->counters[3], 12);
+    for (int b = 0; b < baselineCount; b++) {
+      if (!strcmp(baseline[b].name, r->name)) {
+        printChange(r->wall, baseline[b].wall);
+        printChange(r->counters[0], baseline[b].counters[0]);
+      }
+    }
+    printf("\n");
+  }
+
+  if (counterError) {
+    printf("Hardware counters are unavailable: perf_event_open: %s\n", strerror(counterError));
+  }
+  if (baselineCount == 0 && !save) {
+    printf("No baseline in %s (store one with --save-baseline)\n", baselinePath);
+  }
+  if (save && saveBaseline(baselinePath, results, measured, baseline, baselineCount) == 0) {
+    printf("Saved the baseline in %s\n", baselinePath);
+  }
+  return status;
+}
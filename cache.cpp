@@ -0,0 +1,292 @@
+#include "cache.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Bump this whenever the entry format or the generated code changes.
+static const char* cacheVersion = "lang-cache 11";
+
+// Options that change the generated code must be added here.
+static std::string optionsKey(const CompileOptions& options) {
+  std::ostringstream key;
+  key << "options profile=" << options.codegen.profile << " time=" << options.codegen.profileTime
+      << " unroll=" << options.codegen.unroll << " regcall=" << options.codegen.registerCalls;
+  if (options.codegen.profileData) {
+    key << std::endl << "use-profile" << std::endl << options.codegen.profileData->text;
+  }
+  return key.str();
+}
+
+// The ClassHasher visitor writes a canonical text form of a class's
+// AST (used as part of the cache key) and collects the names of all
+// classes the class refers to.
+class ClassHasher : public Visitor {
+public:
+  std::ostringstream text;
+  std::set<std::string> referencedClasses;
+  // Profiled code contains source lines, so they are part of the key
+  bool lines;
+
+  ClassHasher() : lines(false) {}
+
+  void line(ASTNode* node) {
+    if (lines && node->lineno) {
+      text << "@" << node->lineno;
+    }
+  }
+
+  void open(const char* kind, ASTNode* node) {
+    text << kind;
+    line(node);
+    text << "(";
+    node->visit_children(this);
+    text << ")";
+  }
+
+  void visitStatements(std::list<StatementNode*>* statements) {
+    text << "[";
+    if (statements) {
+      for (std::list<StatementNode*>::iterator it = statements->begin(); it != statements->end(); it++) {
+        (*it)->accept(this);
+      }
+    }
+    text << "]";
+  }
+
+  virtual void visitProgramNode(ProgramNode* node) { open("Program", node); }
+  virtual void visitClassNode(ClassNode* node) {
+    if (node->identifier_2) {
+      referencedClasses.insert(node->identifier_2->name);
+    }
+    open("Class", node);
+  }
+  virtual void visitMethodNode(MethodNode* node) { open("Method", node); }
+  virtual void visitMethodBodyNode(MethodBodyNode* node) { open("MethodBody", node); }
+  virtual void visitParameterNode(ParameterNode* node) { open("Parameter", node); }
+  virtual void visitDeclarationNode(DeclarationNode* node) { open("Declaration", node); }
+  virtual void visitReturnStatementNode(ReturnStatementNode* node) { open("Return", node); }
+  virtual void visitAssignmentNode(AssignmentNode* node) { open("Assignment", node); }
+  virtual void visitCallNode(CallNode* node) { open("Call", node); }
+  // The only node with two lists of the same kind of child
+  virtual void visitIfElseNode(IfElseNode* node) {
+    text << "IfElse";
+    line(node);
+    text << "(";
+    node->expression->accept(this);
+    visitStatements(node->statement_list_1);
+    visitStatements(node->statement_list_2);
+    text << ")";
+  }
+  virtual void visitWhileNode(WhileNode* node) { open("While", node); }
+  virtual void visitDoWhileNode(DoWhileNode* node) { open("DoWhile", node); }
+  virtual void visitPrintNode(PrintNode* node) { open("Print", node); }
+  virtual void visitPlusNode(PlusNode* node) { open("Plus", node); }
+  virtual void visitMinusNode(MinusNode* node) { open("Minus", node); }
+  virtual void visitTimesNode(TimesNode* node) { open("Times", node); }
+  virtual void visitDivideNode(DivideNode* node) { open("Divide", node); }
+  virtual void visitGreaterNode(GreaterNode* node) { open("Greater", node); }
+  virtual void visitGreaterEqualNode(GreaterEqualNode* node) { open("GreaterEqual", node); }
+  virtual void visitEqualNode(EqualNode* node) { open("Equal", node); }
+  virtual void visitAndNode(AndNode* node) { open("And", node); }
+  virtual void visitOrNode(OrNode* node) { open("Or", node); }
+  virtual void visitNotNode(NotNode* node) { open("Not", node); }
+  virtual void visitNegationNode(NegationNode* node) { open("Negation", node); }
+  virtual void visitMethodCallNode(MethodCallNode* node) { open("MethodCall", node); }
+  virtual void visitMemberAccessNode(MemberAccessNode* node) { open("MemberAccess", node); }
+  virtual void visitVariableNode(VariableNode* node) { open("Variable", node); }
+  virtual void visitIntegerLiteralNode(IntegerLiteralNode* node) { open("IntegerLiteral", node); }
+  virtual void visitBooleanLiteralNode(BooleanLiteralNode* node) { open("BooleanLiteral", node); }
+  virtual void visitNewNode(NewNode* node) {
+    referencedClasses.insert(node->identifier->name);
+    open("New", node);
+  }
+  virtual void visitIntegerTypeNode(IntegerTypeNode* node) { text << "Integer"; }
+  virtual void visitBooleanTypeNode(BooleanTypeNode* node) { text << "Boolean"; }
+  virtual void visitObjectTypeNode(ObjectTypeNode* node) {
+    referencedClasses.insert(node->identifier->name);
+    open("Object", node);
+  }
+  virtual void visitNoneNode(NoneNode* node) { text << "None"; }
+  virtual void visitIdentifierNode(IdentifierNode* node) { text << "'" << node->name << "'"; }
+  virtual void visitIntegerNode(IntegerNode* node) { text << node->value; }
+};
+
+// 64 bit FNV-1a hash
+static unsigned long long hash(const std::string& data, unsigned long long seed) {
+  unsigned long long h = seed;
+  for (size_t i = 0; i < data.size(); i++) {
+    h ^= (unsigned char)data[i];
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+// Returns the file name of the cache entry for a class, given the
+// class table built from all earlier classes.
+static std::string entryName(ClassNode* node, ClassTable* classTable, const CompileOptions& options) {
+  ClassHasher hasher;
+  hasher.lines = options.codegen.profile;
+  node->accept(&hasher);
+
+  std::ostringstream key;
+  key << cacheVersion << std::endl << optionsKey(options) << std::endl << hasher.text.str() << std::endl;
+
+  std::string className = node->identifier_1->name;
+  for (std::set<std::string>::iterator it = hasher.referencedClasses.begin(); it != hasher.referencedClasses.end(); it++) {
+    std::string name = *it;
+    while (name != "" && name != className) {
+      if (!classTable->count(name)) {
+        key << "missing " << name << std::endl;
+        break;
+      }
+      writeClassInfo(key, name, classTable->at(name), false);
+      name = classTable->at(name).superClassName;
+    }
+  }
+
+  // two differently seeded hashes make a 128 bit key
+  std::ostringstream fileName;
+  fileName << std::hex << std::setfill('0') << std::setw(16) << hash(key.str(), 14695981039346656037ULL)
+           << std::setw(16) << hash(key.str(), 0x9e3779b97f4a7c15ULL) << ".cls";
+  return fileName.str();
+}
+
+static bool loadEntry(const std::string& path, const std::string& className, ClassTable* classTable, std::string& assembly, double& compileTime) {
+  std::ifstream in(path.c_str(), std::ios::binary);
+  if (!in) {
+    return false;
+  }
+
+  std::string version;
+  std::string word;
+  std::getline(in, version);
+  if (version != cacheVersion || !(in >> word >> compileTime) || word != "time") {
+    return false;
+  }
+
+  std::string name;
+  ClassInfo info;
+  if (!readClassInfo(in, name, info)) {
+    return false;
+  }
+
+  // the entry's tables are handed to the class table only once the
+  // whole entry has been read
+  ClassTable* loaded = new ClassTable();
+  loaded->insert(std::pair<std::string, ClassInfo>(name, info));
+
+  size_t size;
+  if (name != className || !(in >> word >> size) || word != "asm" || in.get() != '\n') {
+    deleteClassTable(loaded);
+    return false;
+  }
+  assembly.resize(size);
+  in.read(&assembly[0], size);
+  if ((size_t)in.gcount() != size) {
+    deleteClassTable(loaded);
+    return false;
+  }
+
+  delete loaded;
+  classTable->insert(std::pair<std::string, ClassInfo>(name, info));
+  return true;
+}
+
+static void storeEntry(const std::string& path, const std::string& className, const ClassInfo& info, const std::string& assembly, double compileTime) {
+  // write to a temporary file first so readers never see a partial
+  // entry (the server may store entries from several threads)
+  std::ostringstream temporary;
+  temporary << path << ".tmp" << getpid() << "." << std::this_thread::get_id();
+  {
+    std::ofstream out(temporary.str().c_str(), std::ios::binary);
+    if (!out) {
+      return;
+    }
+    out << cacheVersion << std::endl;
+    out << "time " << compileTime << std::endl;
+    writeClassInfo(out, className, info, true);
+    out << "asm " << assembly.size() << std::endl;
+    out << assembly;
+  }
+  if (rename(temporary.str().c_str(), path.c_str()) != 0) {
+    unlink(temporary.str().c_str());
+  }
+}
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void compileCached(ProgramNode* program, const CompileOptions& options, std::ostream& out, CacheStats& stats) {
+  mkdir(options.cacheDirectory.c_str(), 0777);
+
+  TypeCheck typecheck;
+  typecheck.beginProgram();
+
+  CodeGenerator codegen;
+  codegen.classTable = typecheck.classTable;
+  codegen.methodLabels = true;
+  codegen.options = options.codegen;
+  codegen.out = &out;
+  codegen.genProgramPrologue();
+
+  for (std::list<ClassNode*>::iterator it = program->class_list->begin(); it != program->class_list->end(); it++) {
+    std::string className = (*it)->identifier_1->name;
+    std::string path = options.cacheDirectory + "/" + entryName(*it, typecheck.classTable, options);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::string assembly;
+    double compileTime;
+    if (!typecheck.classTable->count(className) && loadEntry(path, className, typecheck.classTable, assembly, compileTime)) {
+      out << assembly;
+      stats.hits++;
+      stats.compileTimeOfHits += compileTime;
+      stats.loadTime += millisecondsSince(start);
+      continue;
+    }
+
+    try {
+      typecheck.visitClassNode(*it);
+    } catch (TypeErrorException&) {
+      deleteClassTable(typecheck.classTable);
+      throw;
+    }
+    std::ostringstream buffer;
+    codegen.out = &buffer;
+    (*it)->accept(&codegen);
+    codegen.out = &out;
+
+    out << buffer.str();
+    stats.misses++;
+    storeEntry(path, className, typecheck.classTable->at(className), buffer.str(), millisecondsSince(start));
+  }
+
+  try {
+    typecheck.endProgram();
+  } catch (TypeErrorException&) {
+    deleteClassTable(typecheck.classTable);
+    throw;
+  }
+  codegen.genProgramEpilogue();
+  deleteClassTable(typecheck.classTable);
+}
+
+void referencedClasses(ClassNode* node, std::set<std::string>& names) {
+  ClassHasher hasher;
+  node->accept(&hasher);
+  names.insert(hasher.referencedClasses.begin(), hasher.referencedClasses.end());
+}
+
+void printCacheStats(const CacheStats& stats, std::ostream& out) {
+  int total = stats.hits + stats.misses;
+  out << "cache: " << stats.hits << "/" << total << " classes hit ("
+      << std::fixed << std::setprecision(0) << (total ? 100.0 * stats.hits / total : 0.0) << "%), saved "
+      << std::setprecision(2) << (stats.compileTimeOfHits - stats.loadTime) << " ms" << std::endl;
+}
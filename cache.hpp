@@ -0,0 +1,45 @@
+#ifndef __CACHE_HPP
+#define __CACHE_HPP
+
+#include "compiler.hpp"
+
+#include <set>
+#include <string>
+
+// This file defines the incremental compilation cache. Every class
+// is cached separately in a directory, keyed by a hash of:
+//   - the class's AST (so formatting and comments do not matter),
+//   - the class table entries of its superclasses and of every class
+//     it refers to (and their superclasses), which is everything that
+//     type checking and generating the class depends on, and
+//   - the options that change the generated code.
+// An entry holds the class's class table entry and its assembly, so
+// a class that hits the cache is neither type checked nor generated.
+// Cached code uses per-method labels (see CodeGenerator) so code
+// from different compilations can be put together.
+
+// Defines the statistics reported for a cached compilation.
+struct CacheStats {
+  int hits;
+  int misses;
+  // The time it originally took to compile the classes that hit the
+  // cache, and the time it took to load them instead (milliseconds).
+  double compileTimeOfHits;
+  double loadTime;
+
+  CacheStats() : hits(0), misses(0), compileTimeOfHits(0), loadTime(0) {}
+};
+
+// Type checks and generates the program class by class, taking every
+// class found in the cache directory from the cache and adding every
+// other class to it. Throws a TypeErrorException on type errors.
+void compileCached(ProgramNode* program, const CompileOptions& options, std::ostream& out, CacheStats& stats);
+
+// Adds the names of the classes a class refers to (its superclass
+// and every class named in a type or a new expression) to names.
+void referencedClasses(ClassNode* node, std::set<std::string>& names);
+
+// Prints the one line cache summary (hit rate and time saved).
+void printCacheStats(const CacheStats& stats, std::ostream& out);
+
+#endif
@@ -0,0 +1,83 @@
+// langc: a small client for the compile server (lang --serve).
+//
+// Usage: langc SOCKET < program.lang > program.s
+//
+// Sends the program on stdin to the server listening on SOCKET and
+// writes the assembly to stdout, or the errors to stderr (exiting
+// with status 1).
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static bool writeAll(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    ssize_t n = write(fd, data, size);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    fprintf(stderr, "Usage: %s SOCKET < program.lang\n", argv[0]);
+    return 2;
+  }
+
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, argv[1], sizeof(address.sun_path) - 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0 || connect(fd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+    fprintf(stderr, "%s: %s\n", argv[1], strerror(errno));
+    return 2;
+  }
+
+  char buffer[65536];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), stdin)) > 0) {
+    if (!writeAll(fd, buffer, n)) {
+      fprintf(stderr, "%s: %s\n", argv[1], strerror(errno));
+      return 2;
+    }
+  }
+  shutdown(fd, SHUT_WR);
+
+  std::string response;
+  ssize_t r;
+  while ((r = read(fd, buffer, sizeof(buffer))) != 0) {
+    if (r < 0 && errno == EINTR) {
+      continue;
+    }
+    if (r < 0) {
+      fprintf(stderr, "%s: %s\n", argv[1], strerror(errno));
+      return 2;
+    }
+    response.append(buffer, r);
+  }
+  close(fd);
+
+  size_t newline = response.find('\n');
+  std::string status = response.substr(0, newline);
+  std::string body = newline == std::string::npos ? "" : response.substr(newline + 1);
+  if (status == "OK") {
+    fwrite(body.data(), 1, body.size(), stdout);
+    return 0;
+  }
+  fwrite(body.data(), 1, body.size(), stderr);
+  return 1;
+}
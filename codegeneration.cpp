@@ -1,20 +1,706 @@
 #include "codegeneration.hpp"
 
-void gen(std::string str) {
-	std::cout << str << std::endl;
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+void CodeGenerator::gen(std::string str) {
+	*out << str << std::endl;
+
+	// count every line that is not a comment, a directive or a label
+	if (instructionCounts && !instructionCounts->empty() && !str.empty()) {
+		size_t first = str.find_first_not_of(" \t");
+		if (first != std::string::npos && str[first] != '#' && str[first] != '.' && str[str.size() - 1] != ':') {
+			instructionCounts->back().second++;
+		}
+	}
+}
+
+// Profiling: every counter is a record in the lang_profile section,
+// which the linker gathers from all methods into one array that
+// tester.c writes out at exit. A record is
+//   count (64 bit), cycles (64 bit), method name, line, kind
+// and incrementing it costs two instructions and no registers.
+std::string CodeGenerator::genCounter(ProfileCounterKind kind, int line) {
+	std::string label = "prof_" + currentClassName + "_" + currentMethodName + "_" + std::to_string(profileCounters.size());
+	profileCounters.push_back(std::make_pair(kind, line));
+	gen(
+		"addl $1, " + label,
+		"adcl $0, " + label + "+4"
+	);
+	return label;
+}
+
+void CodeGenerator::genProfileCounters() {
+	std::string name = "prof_" + currentClassName + "_" + currentMethodName;
+	gen(
+		".data",
+		name + ": .asciz \"" + currentClassName + "_" + currentMethodName + "\"",
+		".section lang_profile, \"aw\"",
+		".align 4"
+	);
+	for (size_t i = 0; i < profileCounters.size(); i++) {
+		gen(
+			name + "_" + std::to_string(i) + ":",
+			".long 0, 0, 0, 0, " + name + ", " + std::to_string(profileCounters[i].second) + ", " + std::to_string(profileCounters[i].first)
+		);
+	}
+	gen(".text");
+	profileCounters.clear();
+}
+
+// Profile-guided optimization (see CodeGenOptions::profileData): the
+// generator keeps the count of the block it is in, so every statement
+// knows how hot it is.
+long long CodeGenerator::profileCount(int line, ProfileCounterKind kind) {
+	if (!options.profileData) {
+		return -1;
+	}
+	return options.profileData->blockCount(currentClassName + "_" + currentMethodName, line, kind);
+}
+
+void CodeGenerator::genStatements(std::list<StatementNode*>* statements, long long count) {
+	long long outerCount = blockCount;
+	if (count >= 0) {
+		blockCount = count;
+	}
+	if (statements) {
+		for (std::list<StatementNode*>::iterator iter = statements->begin(); iter != statements->end(); iter++) {
+			(*iter)->accept(this);
+		}
+	}
+	blockCount = outerCount;
+}
+
+// Counts the statements of a block, including nested blocks.
+static int statementCount(std::list<StatementNode*>* statements) {
+	int count = 0;
+	if (statements) {
+		for (std::list<StatementNode*>::iterator iter = statements->begin(); iter != statements->end(); iter++) {
+			count++;
+			if (IfElseNode* ifElse = dynamic_cast<IfElseNode*>(*iter)) {
+				count += statementCount(ifElse->statement_list_1) + statementCount(ifElse->statement_list_2);
+			} else if (WhileNode* loop = dynamic_cast<WhileNode*>(*iter)) {
+				count += statementCount(loop->statement_list);
+			} else if (DoWhileNode* loop = dynamic_cast<DoWhileNode*>(*iter)) {
+				count += statementCount(loop->statement_list);
+			}
+		}
+	}
+	return count;
+}
+
+// A call is inlined if it is in a block that ran at least 1% as often
+// as the hottest block of the profile, and it calls a small method
+// other than the one being generated (inlined methods are not inlined
+// into, which also rules out recursion). Instrumented code is never
+// inlined, so its counters stay in their own methods.
+bool CodeGenerator::shouldInline(MethodNode* callee, const std::string& className) {
+	if (!methodNodes || !options.profileData || options.profile || inlining) {
+		return false;
+	}
+	if (blockCount <= 0 || blockCount * 100 < options.profileData->hottest) {
+		return false;
+	}
+	std::string methodName = callee->identifier->name;
+	if (methodName == className || (className == currentClassName && methodName == currentMethodName)) {
+		return false;
+	}
+	return statementCount(callee->methodbody->statement_list) <= 8;
+}
+
+// Garbage collection: the collector in tester.c finds the object
+// pointers on the stack by walking the frames from the allocation and
+// looking up every return address in the lang_stackmaps section. Each
+// record there points to the list of frame offsets holding objects:
+// `this`, parameters and locals of object types, and the values on
+// the operand stack that are objects. The operand stack starts below
+// the saved registers (and the time stamp of --profile=time).
+void CodeGenerator::genOperands(ExpressionNode* left, ExpressionNode* right) {
+	left->accept(this);
+	operandTypes.push_back(left->basetype == bt_object);
+	right->accept(this);
+	operandTypes.pop_back();
+}
+
+std::string CodeGenerator::genStackMap() {
+	std::string label = "gcret" + nextLabel();
+	std::vector<int> offsets;
+
+	// Main has no members, so its `this` is never an object
+	if (currentClassName != "Main") {
+		offsets.push_back(thisOffset);
+	}
+	for (VariableTable::iterator it = currentMethodInfo.variables->begin(); it != currentMethodInfo.variables->end(); it++) {
+		if (it->second.type.baseType == bt_object) {
+			offsets.push_back(it->second.offset);
+		}
+	}
+	for (std::map<std::string, StackObject>::iterator it = escapes.objects.begin(); it != escapes.objects.end(); it++) {
+		VariableTable* members = classTable->at(it->second.className).members;
+		for (VariableTable::iterator member = members->begin(); member != members->end(); member++) {
+			if (member->second.type.baseType == bt_object) {
+				offsets.push_back(it->second.offset + member->second.offset);
+			}
+		}
+	}
+	int operandBase = -currentMethodInfo.localsSize - 12 - (options.profile && options.profileTime ? 8 : 0);
+	for (size_t i = 0; i < operandTypes.size(); i++) {
+		if (operandTypes[i]) {
+			offsets.push_back(operandBase - 4 * (int)(i + 1));
+		}
+	}
+
+	stackMaps.push_back(std::make_pair(label, offsets));
+	return label;
+}
+
+void CodeGenerator::genStackMaps() {
+	gen(".data");
+	for (size_t i = 0; i < stackMaps.size(); i++) {
+		std::string offsets;
+		for (size_t j = 0; j < stackMaps[i].second.size(); j++) {
+			offsets += ", " + std::to_string(stackMaps[i].second[j]);
+		}
+		gen(stackMaps[i].first + "_map:", ".long " + std::to_string(stackMaps[i].second.size()) + offsets);
+	}
+	gen(".section lang_stackmaps, \"aw\"");
+	for (size_t i = 0; i < stackMaps.size(); i++) {
+		gen(".long " + stackMaps[i].first + ", " + stackMaps[i].first + "_map");
+	}
+	gen(".text");
+	stackMaps.clear();
+}
+
+void CodeGenerator::genClassDescriptor(const std::string& className) {
+	ClassInfo& info = classTable->at(className);
+	int count = 0;
+	std::string offsets;
+	for (VariableTable::iterator it = info.members->begin(); it != info.members->end(); it++) {
+		if (it->second.type.baseType == bt_object) {
+			offsets += ", " + std::to_string(it->second.offset);
+			count++;
+		}
+	}
+
+	std::string methods;
+	std::vector<std::pair<std::string, std::string> > vtable = vtableMethods(classTable, className);
+	for (size_t i = 0; i < vtable.size(); i++) {
+		bool reachable = !reachableMethods || reachableMethods->count(vtable[i].second);
+		methods += (i ? ", " : ".long ") + (reachable ? methodLabel(vtable[i].second) : "0");
+	}
+
+	gen(".data", ".align 4");
+	if (exportMethods) {
+		gen(".globl vtable_" + className);
+	}
+	gen(
+		"vtable_" + className + ":",
+		".long " + std::to_string(info.membersSize) + ", vtable_" + className + "_pointers"
+	);
+	if (!methods.empty()) {
+		gen(methods);
+	}
+	gen(
+		"vtable_" + className + "_pointers:",
+		".long " + std::to_string(count) + offsets,
+		".text"
+	);
+}
+
+std::string CodeGenerator::thisAddress() {
+	return std::to_string(thisOffset) + "(%ebp)";
+}
+
+// Main_main is tester.c's entry point, so under the register calling
+// convention the method itself gets another label.
+std::string CodeGenerator::methodLabel(const std::string& name) {
+	return options.registerCalls && name == "Main_main" ? "Main_main.body" : name;
+}
+
+// The register arguments are computed last, straight into registers,
+// when the selector covers them (and they save no value a later
+// argument reuses); the others are pushed and popped into them. The
+// arguments still run from last to first, as pushed ones do, so an
+// argument computed before a pushed one is pushed too.
+int CodeGenerator::genRegisterArguments(std::list<ExpressionNode*>* arguments) {
+	std::vector<ExpressionNode*> args;
+	if (arguments) {
+		args.assign(arguments->begin(), arguments->end());
+	}
+	for (int i = args.size() - 1; i >= 2; i--) {
+		args[i]->accept(this);
+		operandTypes.push_back(args[i]->basetype == bt_object);
+	}
+
+	static const char* const targets[] = {"%edx", "%ecx"};
+	static const char* const holds[] = {"%esi", "%edi"};
+	bool pushed[2] = {false, false};
+	int numRegisters = std::min((int)args.size(), 2);
+	for (int i = numRegisters - 1; i >= 0; i--) {
+		for (int j = i; j >= 0 && !pushed[i]; j--) {
+			InstructionSelector isel = selector();
+			pushed[i] = !isel.selectable(args[j], nt_reg, 4) || isel.saves(args[j]);
+		}
+		if (pushed[i]) {
+			args[i]->accept(this);
+			operandTypes.push_back(args[i]->basetype == bt_object);
+		}
+	}
+	std::string values[2];
+	for (int i = numRegisters - 1; i >= 0; i--) {
+		if (!pushed[i]) {
+			InstructionSelector isel = selector();
+			Nonterminal goal = isel.selectable(args[i], nt_imm) ? nt_imm : nt_reg;
+			gen(" # Selected Argument");
+			values[i] = isel.reduce(args[i], goal, 4);
+			if (goal == nt_reg) {
+				gen("mov " + values[i] + ", " + holds[i]);
+				values[i] = holds[i];
+			}
+		}
+	}
+	for (int i = 0; i < numRegisters; i++) {
+		if (pushed[i]) {
+			gen(std::string("pop ") + targets[i]);
+			operandTypes.pop_back();
+		}
+	}
+	for (int i = 0; i < numRegisters; i++) {
+		if (!pushed[i]) {
+			gen("mov " + values[i] + ", " + targets[i]);
+		}
+	}
+	return args.size() - numRegisters;
+}
+
+int CodeGenerator::genPopRegisterArguments(int numArgs) {
+	if (numArgs > 0) {
+		gen("pop %edx");
+	}
+	if (numArgs > 1) {
+		gen("pop %ecx");
+	}
+	operandTypes.resize(operandTypes.size() - std::min(numArgs, 2));
+	return std::max(numArgs - 2, 0);
+}
+
+// Memoization: a pure method's entry is found by hashing its arguments
+// (a single argument indexes the table directly).
+static const int memoEntries = 1024;
+
+void CodeGenerator::genMemoEntry() {
+	gen("mov " + std::to_string(memoKeys[0]) + "(%ebp), %ebx");
+	for (size_t i = 1; i < memoKeys.size(); i++) {
+		gen(
+			"imul $31, %ebx",
+			"add " + std::to_string(memoKeys[i]) + "(%ebp), %ebx"
+		);
+	}
+	gen(
+		"and $" + std::to_string(memoEntries - 1) + ", %ebx",
+		"imul $" + std::to_string(4 * (memoKeys.size() + 2)) + ", %ebx",
+		"add $" + memoTable + ", %ebx"
+	);
 }
 
-template<typename... Args>
-void gen(std::string str, Args... args) {
-	gen(str);
-	gen(args...);
+// Compile-time evaluation (see evaluate.hpp): the output is one line
+// of data per line printed. Under the register calling convention,
+// Main's vtable slot gets the same code.
+void CodeGenerator::genEvaluatedMain() {
+	gen(
+		" # Begin Method Node: main (evaluated)",
+		".data",
+		"evaluated_output:"
+	);
+	for (size_t start = 0, end; (end = evaluatedOutput->find('\n', start)) != std::string::npos; start = end + 1) {
+		gen(".ascii \"" + evaluatedOutput->substr(start, end - start) + "\\n\"");
+	}
+	gen(
+		".byte 0",
+		".text"
+	);
+	if (methodLabel("Main_main") != "Main_main") {
+		gen(methodLabel("Main_main") + ":");
+	}
+	gen(
+		"Main_main:",
+		"push $evaluated_output",
+		"call printf",
+		"add $4, %esp",
+		"ret",
+		" # End Method Node: main"
+	);
+}
+
+void CodeGenerator::genObject(const std::string& name, const std::string& reg) {
+	if (currentMethodInfo.variables->count(name)) {
+		gen("mov " + std::to_string(currentMethodInfo.variables->at(name).offset) + "(%ebp), " + reg);
+	} else {
+		gen(
+			"mov " + thisAddress() + ", " + reg,
+			"mov " + std::to_string(currentClassInfo.members->at(name).offset) + "(" + reg + "), " + reg
+		);
+	}
+}
+
+void CodeGenerator::genLoad(const std::string& address, int size) {
+	if (size == 1) {
+		gen(
+			"movzbl " + address + ", %eax",
+			"push %eax"
+		);
+	} else {
+		gen("push " + address);
+	}
+}
+
+void CodeGenerator::genStore(const std::string& address, int size) {
+	gen((size == 1 ? "movb %al, " : "mov %eax, ") + address);
+}
+
+// Escape analysis: an object that never leaves the method creating it
+// lives in the method's frame, below its locals. Every new of it zeroes
+// the members in place (after evaluating the constructor's arguments,
+// which may read them), and its members are read and written directly
+// at their frame offsets. The variable holds the object's address only
+// if it is needed, for calls and arguments.
+const StackObject* CodeGenerator::stackObject(const std::string& name) {
+	std::map<std::string, StackObject>::iterator it = escapes.objects.find(name);
+	return it == escapes.objects.end() ? NULL : &it->second;
+}
+
+void CodeGenerator::genStackNew(NewNode* node, const std::string& variable, const StackObject& object) {
+	std::string className = node->identifier->name;
+	gen(" # Begin New Node: " + className + " (in the frame)");
+
+	int numArgs = 0;
+	if (node->expression_list) {
+		numArgs = node->expression_list->size();
+		for (std::list<ExpressionNode*>::reverse_iterator iter = node->expression_list->rbegin(); iter != node->expression_list->rend(); iter++) {
+			(*iter)->accept(this);
+			operandTypes.push_back((*iter)->basetype == bt_object);
+		}
+	}
+
+	for (int offset = 0; offset < classTable->at(className).membersSize; offset += 4) {
+		gen("movl $0, " + std::to_string(object.offset + offset) + "(%ebp)");
+	}
+	// the header word in front of the object points to the vtable,
+	// as it does for objects from gc_alloc
+	if (!object.scalar) {
+		gen("movl $vtable_" + className + ", " + std::to_string(object.offset - 4) + "(%ebp)");
+	}
+
+	if (classTable->at(className).methods->count(className) && options.registerCalls) {
+		gen("lea " + std::to_string(object.offset) + "(%ebp), %eax");
+		numArgs = genPopRegisterArguments(numArgs);
+		gen(
+			"call " + className + "_" + className,
+			genStackMap() + ":"
+		);
+		if (numArgs) {
+			gen("add $" + std::to_string(4 * numArgs) + ", %esp");
+		}
+	} else if (classTable->at(className).methods->count(className)) {
+		gen(
+			"lea " + std::to_string(object.offset) + "(%ebp), %eax",
+			"push %eax",
+			"call " + className + "_" + className,
+			genStackMap() + ":",
+			"add $" + std::to_string(4 * (numArgs + 1)) + ", %esp"
+		);
+	} else if (numArgs) {
+		gen("add $" + std::to_string(4 * numArgs) + ", %esp");
+	}
+	operandTypes.resize(operandTypes.size() - numArgs);
+
+	if (!object.scalar) {
+		gen(
+			"lea " + std::to_string(object.offset) + "(%ebp), %eax",
+			"mov %eax, " + std::to_string(currentMethodInfo.variables->at(variable).offset) + "(%ebp)"
+		);
+	}
+	gen(" # End New Node");
+}
+
+// Common subexpression elimination: the first expression computing a
+// value that is reused later in its block copies it from the operand
+// stack to a temporary below the frame objects, and the expressions
+// reusing it push the temporary instead of computing it again.
+bool CodeGenerator::genReused(ExpressionNode* node) {
+	std::map<ExpressionNode*, int>::iterator it = values.reused.find(node);
+	if (it == values.reused.end()) {
+		return false;
+	}
+	gen(
+		" # Reused Value",
+		"push " + std::to_string(it->second) + "(%ebp)"
+	);
+	return true;
+}
+
+void CodeGenerator::genSaved(ExpressionNode* node) {
+	std::map<ExpressionNode*, int>::iterator it = values.saved.find(node);
+	if (it != values.saved.end()) {
+		gen(
+			"mov (%esp), %eax",
+			"mov %eax, " + std::to_string(it->second) + "(%ebp)"
+		);
+	}
+}
+
+// Counting loops (see loops.hpp): the products of a loop's induction
+// variable live in temporaries below the values of the method, which
+// follow the variable through every increment.
+const CountingLoop* CodeGenerator::countingLoop(StatementNode* node) {
+	std::map<StatementNode*, CountingLoop>::iterator it = loops.loops.find(node);
+	return it == loops.loops.end() ? NULL : &it->second;
+}
+
+void CodeGenerator::genStartProducts(const CountingLoop& loop) {
+	std::string variable = std::to_string(currentMethodInfo.variables->at(loop.variable).offset) + "(%ebp)";
+	for (size_t i = 0; i < loop.products.size(); i++) {
+		const ReducedProduct& product = loop.products[i];
+		std::string factor = product.factorVariable.empty() ? "$" + std::to_string(product.factor)
+			: std::to_string(currentMethodInfo.variables->at(product.factorVariable).offset) + "(%ebp)";
+		gen(
+			"mov " + variable + ", %eax",
+			"imul " + factor + ", %eax",
+			"mov %eax, " + std::to_string(product.offset) + "(%ebp)"
+		);
+	}
+}
+
+void CodeGenerator::genStepProducts(AssignmentNode* node) {
+	std::map<AssignmentNode*, StatementNode*>::iterator it = loops.increments.find(node);
+	if (it == loops.increments.end()) {
+		return;
+	}
+	const CountingLoop& loop = loops.loops.at(it->second);
+	for (size_t i = 0; i < loop.products.size(); i++) {
+		const ReducedProduct& product = loop.products[i];
+		std::string temporary = std::to_string(product.offset) + "(%ebp)";
+		if (product.factorVariable.empty()) {
+			// the product wraps around like the multiplication would
+			int step = (int)((unsigned)loop.step * (unsigned)product.factor);
+			gen("addl $" + std::to_string(step) + ", " + temporary);
+			continue;
+		}
+		gen("mov " + std::to_string(currentMethodInfo.variables->at(product.factorVariable).offset) + "(%ebp), %eax");
+		if (loop.step != 1) {
+			gen("imul $" + std::to_string(loop.step) + ", %eax");
+		}
+		gen("add %eax, " + temporary);
+	}
+}
+
+// Loop unrolling: while the condition would still hold after another
+// unroll - 1 steps of the induction variable, the body runs unroll
+// times without testing it in between. The loop itself then runs the
+// iterations that are left. If adding the steps overflows, the loop
+// runs them all. Only bodies of up to 8 statements are unrolled.
+void CodeGenerator::genUnrolled(const CountingLoop& loop, std::list<StatementNode*>* statements, long long count) {
+	long long span = (long long)loop.step * (options.unroll - 1);
+	if (options.unroll < 2 || options.profile || span > 0x7fffffff || statementCount(statements) > 8) {
+		return;
+	}
+
+	std::string currentLabel = nextLabel();
+	std::string bound = loop.boundVariable.empty() ? "$" + std::to_string(loop.bound)
+		: std::to_string(currentMethodInfo.variables->at(loop.boundVariable).offset) + "(%ebp)";
+	gen(
+		" # Begin Unrolled Loop",
+		"unrolled" + currentLabel + ":",
+		"mov " + std::to_string(currentMethodInfo.variables->at(loop.variable).offset) + "(%ebp), %eax",
+		"add $" + std::to_string(span) + ", %eax",
+		"jo unrolledend" + currentLabel,
+		"cmp " + bound + ", %eax",
+		std::string(loop.inclusive ? "jg" : "jge") + " unrolledend" + currentLabel
+	);
+	for (int i = 0; i < options.unroll; i++) {
+		genStatements(statements, count);
+	}
+	gen(
+		"jmp unrolled" + currentLabel,
+		"unrolledend" + currentLabel + ":",
+		" # End Unrolled Loop"
+	);
+}
+
+// Instruction selection (see isel.hpp): the leaves of a selected tree
+// are literals, words in the frame (locals, members of frame objects,
+// and the temporaries of reused values and reduced products) and
+// members loaded through an object.
+InstructionSelector CodeGenerator::selector() {
+	return InstructionSelector(
+		[this](ExpressionNode* node) { return selectionInfo(node); },
+		[this](const std::string& line) { gen(line); }
+	);
+}
+
+SelectionInfo CodeGenerator::selectionInfo(ExpressionNode* node) {
+	SelectionInfo info;
+	std::map<ExpressionNode*, int>::iterator reused = values.reused.find(node);
+	std::map<ExpressionNode*, int>::iterator reduced = loops.reduced.find(node);
+	if (reused != values.reused.end() || reduced != loops.reduced.end()) {
+		info.op = op_frame;
+		info.value = reused != values.reused.end() ? reused->second : reduced->second;
+		info.reused = reused != values.reused.end();
+	}
+	std::map<ExpressionNode*, int>::iterator saved = values.saved.find(node);
+	if (saved != values.saved.end()) {
+		info.saved = saved->second;
+	}
+	if (info.op != op_none) {
+		return info;
+	}
+
+	// a member at an address, loaded after the instructions in load
+	std::string address;
+	int size = 4;
+	if (IntegerLiteralNode* literal = dynamic_cast<IntegerLiteralNode*>(node)) {
+		info.op = op_constant;
+		info.value = literal->integer->value;
+	} else if (BooleanLiteralNode* literal = dynamic_cast<BooleanLiteralNode*>(node)) {
+		info.op = op_constant;
+		info.value = literal->integer->value;
+	} else if (VariableNode* variable = dynamic_cast<VariableNode*>(node)) {
+		if (currentMethodInfo.variables->count(variable->identifier->name)) {
+			info.op = op_frame;
+			info.value = currentMethodInfo.variables->at(variable->identifier->name).offset;
+		} else {
+			VariableInfo& member = currentClassInfo.members->at(variable->identifier->name);
+			info.load.push_back("mov " + thisAddress() + ", %r");
+			address = std::to_string(member.offset) + "(%r)";
+			size = member.size;
+		}
+	} else if (MemberAccessNode* access = dynamic_cast<MemberAccessNode*>(node)) {
+		VariableInfo& member = classTable->at(access->identifier_1->objectClassName).members->at(access->identifier_2->name);
+		const StackObject* object = stackObject(access->identifier_1->name);
+		size = member.size;
+		if (object && member.size == 4) {
+			info.op = op_frame;
+			info.value = object->offset + member.offset;
+		} else if (object) {
+			address = std::to_string(object->offset + member.offset) + "(%ebp)";
+		} else if (currentMethodInfo.variables->count(access->identifier_1->name)) {
+			info.load.push_back("mov " + std::to_string(currentMethodInfo.variables->at(access->identifier_1->name).offset) + "(%ebp), %r");
+			address = std::to_string(member.offset) + "(%r)";
+		} else {
+			info.load.push_back("mov " + thisAddress() + ", %r");
+			info.load.push_back("mov " + std::to_string(currentClassInfo.members->at(access->identifier_1->name).offset) + "(%r), %r");
+			address = std::to_string(member.offset) + "(%r)";
+		}
+	}
+
+	if (!address.empty()) {
+		info.op = op_load;
+		info.load.push_back((size == 1 ? "movzbl " : "mov ") + address + ", %r");
+		info.loadCost = 2 * info.load.size();
+	}
+	return info;
+}
+
+std::string CodeGenerator::genSelected(ExpressionNode* node) {
+	InstructionSelector isel = selector();
+	Nonterminal goal = isel.selectable(node, nt_imm) ? nt_imm : nt_reg;
+	if (!isel.selectable(node, goal)) {
+		return "";
+	}
+	gen(" # Selected Expression");
+	return isel.reduce(node, goal);
+}
+
+bool CodeGenerator::genPushSelected(ExpressionNode* node) {
+	std::string operand = genSelected(node);
+	if (operand.empty()) {
+		return false;
+	}
+	gen("push " + operand);
+	return true;
+}
+
+// A condition the selector covers is compared (or tested, against
+// zero) and jumped on directly, instead of computing a boolean first.
+void CodeGenerator::genBranch(ExpressionNode* condition, bool when, const std::string& label) {
+	InstructionSelector isel = selector();
+	if (isel.selectable(condition, nt_cc)) {
+		gen(" # Selected Condition");
+		std::string cc = isel.reduce(condition, nt_cc);
+		gen("j" + (when ? cc : negateCondition(cc)) + " " + label);
+		return;
+	}
+
+	condition->accept(this);
+	gen(
+		"pop %eax",
+		"test %eax, %eax",
+		(when ? "jne " : "je ") + label
+	);
+}
+
+// Returns the assignment to a local that is the only statement of an
+// arm, or NULL.
+static AssignmentNode* onlyAssignment(std::list<StatementNode*>* statements) {
+	if (!statements || statements->size() != 1) {
+		return NULL;
+	}
+	AssignmentNode* assignment = dynamic_cast<AssignmentNode*>(statements->front());
+	return assignment && !assignment->identifier_2 ? assignment : NULL;
+}
+
+// An if whose arms each assign the same local (or whose else arm is
+// empty) computes both values and picks one with cmov, so a condition
+// that depends on the data costs no mispredicted branches. Both values
+// are computed whatever the condition is, so neither may load through
+// an object (which might not exist).
+bool CodeGenerator::genConditionalMove(IfElseNode* node) {
+	AssignmentNode* thenAssignment = onlyAssignment(node->statement_list_1);
+	AssignmentNode* elseAssignment = onlyAssignment(node->statement_list_2);
+	if (options.profile || !thenAssignment || (node->statement_list_2 && !node->statement_list_2->empty() && !elseAssignment)) {
+		return false;
+	}
+	std::string name = thenAssignment->identifier_1->name;
+	if ((elseAssignment && elseAssignment->identifier_1->name != name) || !currentMethodInfo.variables->count(name) ||
+			stackObject(name) || loops.increments.count(thenAssignment) || (elseAssignment && loops.increments.count(elseAssignment))) {
+		return false;
+	}
+
+	// the value of the then arm is kept in %edi and the other in %esi
+	// while the condition is compared
+	InstructionSelector thenValue = selector();
+	InstructionSelector elseValue = selector();
+	InstructionSelector condition = selector();
+	if (!thenValue.selectable(thenAssignment->expression, nt_reg) || !thenValue.speculable(thenAssignment->expression) ||
+			(elseAssignment && (!elseValue.selectable(elseAssignment->expression, nt_reg, 5) || !elseValue.speculable(elseAssignment->expression))) ||
+			!condition.selectable(node->expression, nt_cc, 4)) {
+		return false;
+	}
+
+	std::string variable = std::to_string(currentMethodInfo.variables->at(name).offset) + "(%ebp)";
+	gen(" # Begin If Else Node (conditional move)");
+	gen("mov " + thenValue.reduce(thenAssignment->expression, nt_reg) + ", %edi");
+	if (elseAssignment) {
+		gen("mov " + elseValue.reduce(elseAssignment->expression, nt_reg, 5) + ", %esi");
+	} else {
+		gen("mov " + variable + ", %esi");
+	}
+	gen(
+		"cmov" + condition.reduce(node->expression, nt_cc, 4) + " %edi, %esi",
+		"mov %esi, " + variable,
+		" # End If Else Node"
+	);
+	return true;
 }
 
 // CodeGenerator Visitor Functions: These are the functions
 // you will complete to generate the x86 assembly code. Not
 // all functions must have code, many may be left empty.
 
-void CodeGenerator::visitProgramNode(ProgramNode* node) {
+void CodeGenerator::genProgramPrologue() {
 	gen(
 		".data",
 		"printstr: .asciz \"%d\\n\"",
@@ -23,14 +709,76 @@ void CodeGenerator::visitProgramNode(ProgramNode* node) {
 		"",
 		" # Begin Program Node"
 	);
+}
 
-	node->visit_children(this);
-
+void CodeGenerator::genProgramEpilogue() {
 	gen(
 		" # End Program Node"
 	);
 }
 
+void CodeGenerator::visitProgramNode(ProgramNode* node) {
+	genProgramPrologue();
+
+	// dead code is removed first, so every analysis sees what is left
+	// (and all of it is, when the program was evaluated)
+	std::string output;
+	std::set<std::string> reachable;
+	if (!reachableMethods) {
+		if (options.evaluate.steps && !options.profile && evaluateProgram(node, classTable, options.evaluate, output)) {
+			reachable.insert("Main_main");
+			evaluatedOutput = &output;
+		} else {
+			propagateConstants(node, classTable);
+			eliminateDeadCode(node, classTable, reachable, NULL);
+		}
+		reachableMethods = &reachable;
+	}
+	std::map<std::string, MethodNode*> methods;
+	if (options.profileData && !methodNodes) {
+		collectMethods(node, methods);
+		methodNodes = &methods;
+	}
+	std::set<std::string> parameters;
+	if (!nonEscapingParameters) {
+		findNonEscapingParameters(node, classTable, parameters);
+		nonEscapingParameters = &parameters;
+	}
+	std::set<std::string> overridden;
+	if (!overriddenMethods) {
+		findOverriddenMethods(classTable, overridden);
+		overriddenMethods = &overridden;
+	}
+	std::set<std::string> pure;
+	if (!pureMethods) {
+		findPureMethods(node, classTable, *overriddenMethods, pure);
+		pureMethods = &pure;
+	}
+
+	node->visit_children(this);
+
+	if (methodNodes == &methods) {
+		methodNodes = NULL;
+	}
+	if (nonEscapingParameters == &parameters) {
+		nonEscapingParameters = NULL;
+	}
+	if (overriddenMethods == &overridden) {
+		overriddenMethods = NULL;
+	}
+	if (pureMethods == &pure) {
+		pureMethods = NULL;
+	}
+	if (reachableMethods == &reachable) {
+		reachableMethods = NULL;
+	}
+	if (evaluatedOutput == &output) {
+		evaluatedOutput = NULL;
+	}
+
+	genProgramEpilogue();
+}
+
 void CodeGenerator::visitClassNode(ClassNode* node) {
 	gen(
 		" # Begin Class Node: " + node->identifier_1->name
@@ -38,6 +786,7 @@ void CodeGenerator::visitClassNode(ClassNode* node) {
 
 	currentClassName = node->identifier_1->name;
 	currentClassInfo = classTable->at(currentClassName);
+	genClassDescriptor(currentClassName);
 	node->visit_children(this);
 
 	gen(
@@ -47,15 +796,120 @@ void CodeGenerator::visitClassNode(ClassNode* node) {
 
 void CodeGenerator::visitMethodNode(MethodNode* node) {
     currentMethodName = node->identifier->name;
+    if (reachableMethods && !reachableMethods->count(currentClassName + "_" + currentMethodName)) {
+    	gen(" # Unreachable Method: " + currentMethodName);
+    	return;
+    }
+    if (evaluatedOutput) {
+    	if (instructionCounts) {
+    		instructionCounts->push_back(std::make_pair(currentClassName + "_" + currentMethodName, 0));
+    	}
+    	genEvaluatedMain();
+    	return;
+    }
+    eliminateDeadCode(node, currentClassName, classTable, NULL);
     currentMethodInfo = classTable->at(currentClassName).methods->at(currentMethodName);
+    escapes = findStackObjects(node, currentClassName, classTable, nonEscapingParameters);
+    currentMethodInfo.localsSize += escapes.frameSize;
+    values = numberValues(node, currentClassName, classTable, escapes, currentMethodInfo.localsSize, pureMethods);
+    currentMethodInfo.localsSize += values.frameSize;
+    loops = findCountingLoops(node, currentClassName, classTable, currentMethodInfo.localsSize);
+    currentMethodInfo.localsSize += loops.frameSize;
+
+    // Under the register calling convention, `this` and the first two
+    // parameters are stored below the rest of the frame on entry, and
+    // the other parameters are pushed without `this` in front of them.
+    thisOffset = 8;
+    registerHomes.clear();
+    if (options.registerCalls) {
+    	registerVariables = *currentMethodInfo.variables;
+    	currentMethodInfo.variables = &registerVariables;
+    	currentMethodInfo.localsSize += 4;
+    	thisOffset = -currentMethodInfo.localsSize;
+    	registerHomes.push_back(thisOffset);
+    	int numRegisters = std::min((int)currentMethodInfo.parameters->size(), 2);
+    	for (int index = 0; index < numRegisters; index++) {
+    		currentMethodInfo.localsSize += 4;
+    		registerHomes.push_back(-currentMethodInfo.localsSize);
+    	}
+    	// parameter i was at 12 + 4 * i
+    	for (VariableTable::iterator it = registerVariables.begin(); it != registerVariables.end(); it++) {
+    		int index = (it->second.offset - 12) / 4;
+    		if (it->second.offset > 0) {
+    			it->second.offset = index < 2 ? registerHomes[index + 1] : it->second.offset - 12;
+    		}
+    	}
+    }
+
+    memoTable.clear();
+    memoKeys.clear();
+    std::string name = currentClassName + "_" + currentMethodName;
+    if (options.memoize && !options.profile && pureMethods && pureMethods->count(name) && worthMemoizing(node, currentClassName, classTable)) {
+    	memoTable = "memo_" + name;
+    	for (std::list<ParameterNode*>::iterator it = node->parameter_list->begin(); it != node->parameter_list->end(); it++) {
+    		memoKeys.push_back(currentMethodInfo.variables->at((*it)->identifier->name).offset);
+    	}
+    }
+
+    if (methodLabels) {
+    	labelPrefix = "_" + currentClassName + "_" + currentMethodName + "_";
+    	currentLabel = 0;
+    }
+    if (instructionCounts) {
+    	instructionCounts->push_back(std::make_pair(currentClassName + "_" + currentMethodName, 0));
+    }
+    if (exportMethods) {
+    	gen(".globl " + currentClassName + "_" + currentMethodName);
+    }
+
+    // methods the profile saw, but never saw called, are kept away
+    // from the hot code
+    blockCount = -1;
+    bool cold = false;
+    if (options.profileData) {
+    	blockCount = options.profileData->methodCount(currentClassName + "_" + currentMethodName);
+    	cold = blockCount == 0;
+    }
+    if (cold) {
+    	gen(".section .text.unlikely, \"ax\"");
+    }
 
+    if (!memoTable.empty()) {
+    	gen(".lcomm " + memoTable + ", " + std::to_string(memoEntries * 4 * (memoKeys.size() + 2)));
+    }
+    std::string label = methodLabel(currentClassName + "_" + currentMethodName);
+    if (label != currentClassName + "_" + currentMethodName) {
+    	// the cdecl thunk tester.c calls: main takes no parameters, and
+    	// Main's `this` is not an object
+    	if (exportMethods) {
+    		gen(".globl " + label);
+    	}
+    	gen(
+    		currentClassName + "_" + currentMethodName + ":",
+    		"mov 4(%esp), %eax",
+    		"jmp " + label
+    	);
+    }
     gen(
     	" # Begin Method Node: " + currentMethodName,
-    	currentClassName + "_" + currentMethodName + ":"
+    	label + ":"
     );
 
+    // the method's first counter counts its calls (and its cycles)
+    if (options.profile) {
+    	genCounter(pc_method, node->lineno);
+    }
+
     node->visit_children(this);
 
+    genStackMaps();
+    if (options.profile) {
+    	genProfileCounters();
+    }
+    if (cold) {
+    	gen(".text");
+    }
+
     gen(
     	" # End Method Node: " + currentMethodName
     );
@@ -72,12 +926,102 @@ void CodeGenerator::visitMethodBodyNode(MethodBodyNode* node) {
     	"push %edi"
     );
 
+    // the register calling convention's `this` and first arguments
+    // (an inlined body gets them pushed, and has no homes)
+    static const char* const registers[] = {"%eax", "%edx", "%ecx"};
+    for (size_t i = 0; i < registerHomes.size(); i++) {
+    	gen(std::string("mov ") + registers[i] + ", " + std::to_string(registerHomes[i]) + "(%ebp)");
+    }
+
+    // object locals start out null, so the collector never sees
+    // whatever the stack held before (the homes of arguments are
+    // already stored)
+    for (VariableTable::iterator it = currentMethodInfo.variables->begin(); it != currentMethodInfo.variables->end(); it++) {
+    	if (it->second.offset < 0 && it->second.type.baseType == bt_object
+    			&& std::find(registerHomes.begin(), registerHomes.end(), it->second.offset) == registerHomes.end()) {
+    		gen("movl $0, " + std::to_string(it->second.offset) + "(%ebp)");
+    	}
+    }
+    for (std::map<std::string, StackObject>::iterator it = escapes.objects.begin(); it != escapes.objects.end(); it++) {
+    	VariableTable* members = classTable->at(it->second.className).members;
+    	for (VariableTable::iterator member = members->begin(); member != members->end(); member++) {
+    		if (member->second.type.baseType == bt_object) {
+    			gen("movl $0, " + std::to_string(it->second.offset + member->second.offset) + "(%ebp)");
+    		}
+    	}
+    }
+
+    // the time stamp at entry is kept on the stack below the saved
+    // registers (statements leave the stack as they found it)
+    bool timed = options.profile && options.profileTime;
+    if (timed) {
+    	gen(
+    		"rdtsc",
+    		"push %edx",
+    		"push %eax"
+    	);
+    }
+
+    // a memoized method returns the value in its entry if the entry
+    // holds its arguments, and fills the entry otherwise
+    std::string memoLabel;
+    if (!memoTable.empty()) {
+    	memoLabel = nextLabel();
+    	gen(" # Memo Lookup");
+    	genMemoEntry();
+    	gen(
+    		"cmpl $0, (%ebx)",
+    		"je memomiss" + memoLabel
+    	);
+    	for (size_t i = 0; i < memoKeys.size(); i++) {
+    		gen(
+    			"mov " + std::to_string(memoKeys[i]) + "(%ebp), %ecx",
+    			"cmp " + std::to_string(4 * (i + 1)) + "(%ebx), %ecx",
+    			"jne memomiss" + memoLabel
+    		);
+    	}
+    	gen(
+    		"mov " + std::to_string(4 * (memoKeys.size() + 1)) + "(%ebx), %eax",
+    		"jmp memodone" + memoLabel,
+    		"memomiss" + memoLabel + ":"
+    	);
+    }
 
     node->visit_children(this);
 
+    if (!memoTable.empty()) {
+    	gen(" # Memo Store");
+    	genMemoEntry();
+    	gen("movl $1, (%ebx)");
+    	for (size_t i = 0; i < memoKeys.size(); i++) {
+    		gen(
+    			"mov " + std::to_string(memoKeys[i]) + "(%ebp), %ecx",
+    			"mov %ecx, " + std::to_string(4 * (i + 1)) + "(%ebx)"
+    		);
+    	}
+    	gen(
+    		"mov %eax, " + std::to_string(4 * (memoKeys.size() + 1)) + "(%ebx)",
+    		"memodone" + memoLabel + ":"
+    	);
+    }
+
     if (currentMethodName == currentClassName) {
     	gen(
-    		"mov 8(%ebp), %eax"
+    		"mov " + thisAddress() + ", %eax"
+    	);
+    }
+
+    if (timed) {
+    	std::string counter = "prof_" + currentClassName + "_" + currentMethodName + "_0";
+    	gen(
+    		"mov %eax, %esi",
+    		"rdtsc",
+    		"sub (%esp), %eax",
+    		"sbb 4(%esp), %edx",
+    		"add %eax, " + counter + "+8",
+    		"adc %edx, " + counter + "+12",
+    		"add $8, %esp",
+    		"mov %esi, %eax"
     	);
     }
 
@@ -86,10 +1030,13 @@ void CodeGenerator::visitMethodBodyNode(MethodBodyNode* node) {
     	"pop %esi",
     	"pop %ebx",
     	"mov %ebp, %esp",
-    	"pop %ebp",
-    	"ret",
-    	" # End Method Body Node"
+    	"pop %ebp"
     );
+    // an inlined body falls through to the code after the call
+    if (!inlining) {
+    	gen("ret");
+    }
+    gen(" # End Method Body Node");
 
 
 }
@@ -103,78 +1050,131 @@ void CodeGenerator::visitDeclarationNode(DeclarationNode* node) {
 }
 
 void CodeGenerator::visitReturnStatementNode(ReturnStatementNode* node) {
-	node->visit_children(this);
+	std::string value = genSelected(node->expression);
+	if (value.empty()) {
+		node->visit_children(this);
+	}
 
-	gen(
-		" # Return Statement Node",
-		"pop %eax"
-	);
+	gen(" # Return Statement Node");
+	if (value.empty()) {
+		gen("pop %eax");
+	} else if (value != "%eax") {
+		gen("mov " + value + ", %eax");
+	}
 }
 
 void CodeGenerator::visitAssignmentNode(AssignmentNode* node) {
-    node->visit_children(this);
+    // the escape analysis only gives frame objects to variables that
+    // are assigned nothing but new objects
+    const StackObject* object = stackObject(node->identifier_1->name);
+    if (object && !node->identifier_2) {
+    	genStackNew((NewNode*)node->expression, node->identifier_1->name, *object);
+    	return;
+    }
 
-    std::cout << " # Begin Assignment Node: ";
+    std::string value = genSelected(node->expression);
+    if (value.empty()) {
+    	node->visit_children(this);
+    }
+
+    *out << " # Begin Assignment Node: ";
     if (!node->identifier_2) {
-    	std::cout << node->identifier_1->name << std::endl;
+    	*out << node->identifier_1->name << std::endl;
     } else {
-    	std::cout << node->identifier_1->name + "(" + node->identifier_1->objectClassName + ")." + node->identifier_2->name << std::endl;
+    	*out << node->identifier_1->name + "(" + node->identifier_1->objectClassName + ")." + node->identifier_2->name << std::endl;
     }
 
-    int offset = 0;
+    if (value.empty()) {
+    	gen("pop %eax");
+    } else if (value != "%eax") {
+    	gen("mov " + value + ", %eax");
+    }
     if (node->identifier_2) {
-    	offset = classTable->at(node->identifier_1->objectClassName).members->at(node->identifier_2->name).offset;  	
+    	// a member of the object held by a variable
+    	VariableInfo& member = classTable->at(node->identifier_1->objectClassName).members->at(node->identifier_2->name);
+    	if (object) {
+    		genStore(std::to_string(object->offset + member.offset) + "(%ebp)", member.size);
+    	} else {
+    		genObject(node->identifier_1->name, "%ebx");
+    		genStore(std::to_string(member.offset) + "(%ebx)", member.size);
+    	}
+    } else if (currentMethodInfo.variables->count(node->identifier_1->name)) {
+    	gen("mov %eax, " + std::to_string(currentMethodInfo.variables->at(node->identifier_1->name).offset) + "(%ebp)");
+    } else {
+    	// a member of `this`
+    	VariableInfo& member = currentClassInfo.members->at(node->identifier_1->name);
+    	gen("mov " + thisAddress() + ", %ebx");
+    	genStore(std::to_string(member.offset) + "(%ebx)", member.size);
     }
 
-    if (currentMethodInfo.variables->count(node->identifier_1->name)) {
-		offset += currentMethodInfo.variables->at(node->identifier_1->name).offset;
-	} else {
-		offset += 8 + currentClassInfo.members->at(node->identifier_1->name).offset;
-	}
+	gen(" # End Assignment Node");
 
-	gen(
-		"pop %eax",
-		"mov %eax, " + std::to_string(offset) + "(%ebp)",
-		" # End Assignment Node"
-	);
+	genStepProducts(node);
 }
 
 void CodeGenerator::visitCallNode(CallNode* node) {
     node->visit_children(this);
+
+    // discard the value of the call
+    gen("add $4, %esp");
 }
 
 void CodeGenerator::visitIfElseNode(IfElseNode* node) {
-    node->expression->accept(this);
+    if (genConditionalMove(node)) {
+    	return;
+    }
+    std::string currentLabel = nextLabel();
 
-    std::string currentLabel = std::to_string(nextLabel());
+    // the arm that ran more often in the profile falls through (an
+    // empty else arm already costs a single taken branch)
+    long long thenCount = profileCount(node->lineno, pc_then);
+    long long elseCount = profileCount(node->lineno, pc_else);
+    if (thenCount >= 0 && elseCount > thenCount && node->statement_list_2) {
+    	gen(" # Begin If Else Node (else arm first)");
+    	genBranch(node->expression, true, "then" + currentLabel);
 
-    gen(
-    	" # Begin If Else Node"
-		"pop %eax",
-		"cmp $0, %eax",
-		"je else" + currentLabel
-	);
+    	if (options.profile) {
+    		genCounter(pc_else, node->lineno);
+    	}
+    	genStatements(node->statement_list_2, elseCount);
 
-	if (node->statement_list_1) {
-		for(std::list<StatementNode*>::iterator iter = node->statement_list_1->begin();
-			iter != node->statement_list_1->end(); iter++) {
-			(*iter)->accept(this);
-		}
+    	gen(
+    		"jmp end" + currentLabel,
+    		"then" + currentLabel + ":"
+    	);
+
+    	if (options.profile) {
+    		genCounter(pc_then, node->lineno);
+    	}
+    	genStatements(node->statement_list_1, thenCount);
+
+    	gen(
+    		"end" + currentLabel + ":",
+    		" # End If Else Node"
+    	);
+    	return;
+    }
+
+    gen(" # Begin If Else Node");
+    genBranch(node->expression, false, "else" + currentLabel);
+
+	if (options.profile) {
+		genCounter(pc_then, node->lineno);
 	}
+
+	genStatements(node->statement_list_1, thenCount);
 	
 	gen(
 		"jmp end" + currentLabel,
 		"else" + currentLabel + ":"
 	);
 
-
-	if (node->statement_list_2) {
-		for(std::list<StatementNode*>::iterator iter = node->statement_list_2->begin();
-			iter != node->statement_list_2->end(); iter++) {
-			(*iter)->accept(this);
-		}
+	if (options.profile) {
+		genCounter(pc_else, node->lineno);
 	}
 
+	genStatements(node->statement_list_2, elseCount);
+
 	gen(
 		"end" + currentLabel + ":",
 		" # End If Else Node"
@@ -182,27 +1182,48 @@ void CodeGenerator::visitIfElseNode(IfElseNode* node) {
 }
 
 void CodeGenerator::visitWhileNode(WhileNode* node) {
-    std::string currentLabel = std::to_string(nextLabel());
+    std::string currentLabel = nextLabel();
+
+    // A loop that ran at least once per entry in the profile is
+    // rotated: the condition moves to the bottom, so every iteration
+    // takes one branch instead of two.
+    long long count = profileCount(node->lineno, pc_loop);
+    const CountingLoop* loop = countingLoop(node);
+    if (loop) {
+    	genStartProducts(*loop);
+    	genUnrolled(*loop, node->statement_list, count);
+    }
+    if (count > 0 && count >= blockCount) {
+    	gen(
+    		" # Begin While Node (rotated)",
+    		"jmp loopcond" + currentLabel,
+    		"loopstart" + currentLabel + ":"
+    	);
+
+    	if (options.profile) {
+    		genCounter(pc_loop, node->lineno);
+    	}
+    	genStatements(node->statement_list, count);
+
+    	gen("loopcond" + currentLabel + ":");
+    	genBranch(node->expression, true, "loopstart" + currentLabel);
+    	gen(" # End While Node");
+    	return;
+    }
+
 	gen(
 		" # Begin While Node",
 		"loopstart" + currentLabel + ":"
  	);
 
-	node->expression->accept(this);
+	genBranch(node->expression, false, "loopend" + currentLabel);
 
-	gen(
-		"pop %eax",
-		"cmp $0, %eax",
-		"je loopend" + currentLabel		
-	);
-
-	if (node->statement_list) {
-		for(std::list<StatementNode*>::iterator iter = node->statement_list->begin();
-			iter != node->statement_list->end(); iter++) {
-			(*iter)->accept(this);
-		}
+	if (options.profile) {
+		genCounter(pc_loop, node->lineno);
 	}
 
+	genStatements(node->statement_list, count);
+
 	gen(
 		"jmp loopstart" + currentLabel,
 		"loopend" + currentLabel + ":",
@@ -223,24 +1244,43 @@ void CodeGenerator::visitPrintNode(PrintNode* node) {
 }
 
 void CodeGenerator::visitDoWhileNode(DoWhileNode* node) {
-	std::string currentLabel = std::to_string(nextLabel());
+	std::string currentLabel = nextLabel();
+	const CountingLoop* loop = countingLoop(node);
+	if (loop) {
+		genStartProducts(*loop);
+	}
 	gen(
 		" # Begin Do While Node",
 		"loopstart" + currentLabel + ":"
  	);
 
-	node->visit_children(this);
+	if (options.profile) {
+		genCounter(pc_loop, node->lineno);
+	}
 
-	gen(
-		"pop %eax",
-		"cmp $1, %eax",
-		"je loopstart" + currentLabel,
-		" # End Do While Node"		
-	);
+	long long outerCount = blockCount;
+	long long count = profileCount(node->lineno, pc_loop);
+	if (count >= 0) {
+		blockCount = count;
+	}
+	genStatements(node->statement_list, -1);
+	if (loop) {
+		genUnrolled(*loop, node->statement_list, -1);
+	}
+	genBranch(node->expression, true, "loopstart" + currentLabel);
+	blockCount = outerCount;
+
+	gen(" # End Do While Node");
 }
 
 void CodeGenerator::visitPlusNode(PlusNode* node) {
-    node->visit_children(this);
+    if (genReused(node)) {
+        return;
+    }
+    if (genPushSelected(node)) {
+        return;
+    }
+    genOperands(node->expression_1, node->expression_2);
 
 	gen(
 		" # Begin Plus Node",
@@ -250,10 +1290,18 @@ void CodeGenerator::visitPlusNode(PlusNode* node) {
 		"push %eax",
 		" # End Plus Node"
 	);
+
+	genSaved(node);
 }
 
 void CodeGenerator::visitMinusNode(MinusNode* node) {
-	node->visit_children(this);
+	if (genReused(node)) {
+		return;
+	}
+	if (genPushSelected(node)) {
+		return;
+	}
+	genOperands(node->expression_1, node->expression_2);
 
 	gen(
 		" # Begin Minus Node",
@@ -263,10 +1311,27 @@ void CodeGenerator::visitMinusNode(MinusNode* node) {
 		"push %eax",
 		" # End Minus Node"
 	);
+
+	genSaved(node);
 }
 
 void CodeGenerator::visitTimesNode(TimesNode* node) {
-	node->visit_children(this);
+	if (genReused(node)) {
+		return;
+	}
+	std::map<ExpressionNode*, int>::iterator reduced = loops.reduced.find(node);
+	if (reduced != loops.reduced.end()) {
+		gen(
+			" # Reduced Product",
+			"push " + std::to_string(reduced->second) + "(%ebp)"
+		);
+		genSaved(node);
+		return;
+	}
+	if (genPushSelected(node)) {
+		return;
+	}
+	genOperands(node->expression_1, node->expression_2);
 
 	gen(
 		" # Begin Times Node",
@@ -276,10 +1341,15 @@ void CodeGenerator::visitTimesNode(TimesNode* node) {
 		"push %eax",
 		" # End Times Node"
 	);
+
+	genSaved(node);
 }
 
 void CodeGenerator::visitDivideNode(DivideNode* node) {
-	node->visit_children(this);
+	if (genReused(node)) {
+		return;
+	}
+	genOperands(node->expression_1, node->expression_2);
 
 	gen(
 		" # Begin Divide Node",
@@ -290,70 +1360,87 @@ void CodeGenerator::visitDivideNode(DivideNode* node) {
 		"push %eax",
 		" # End Divide Node"
 	);
+
+	genSaved(node);
 }
 
 void CodeGenerator::visitGreaterNode(GreaterNode* node) {
-	node->visit_children(this);
+	if (genReused(node)) {
+		return;
+	}
+	if (genPushSelected(node)) {
+		return;
+	}
+	genOperands(node->expression_1, node->expression_2);
 
-	std::string currentLabel = std::to_string(nextLabel());
 	gen(
 		" # Begin Greater Node",
 		"pop %ebx",
 		"pop %eax",
 		"cmp %ebx, %eax",
-		"jg greater" + currentLabel,
-		"mov $0, %eax",
-		"jmp done" + currentLabel,
-		"greater" + currentLabel + ":",
-		"mov $1, %eax",
-		"done" + currentLabel + ":",
+		"setg %al",
+		"movzbl %al, %eax",
 		"push %eax",
 		" # End Greater Node"
 	);
+
+	genSaved(node);
 }
 
 void CodeGenerator::visitGreaterEqualNode(GreaterEqualNode* node) {
-	node->visit_children(this);
+	if (genReused(node)) {
+		return;
+	}
+	if (genPushSelected(node)) {
+		return;
+	}
+	genOperands(node->expression_1, node->expression_2);
 
-	std::string currentLabel = std::to_string(nextLabel());
 	gen(
 		" # Begin Greater Equal Node",
 		"pop %ebx",
 		"pop %eax",
 		"cmp %ebx, %eax",
-		"jge greaterequal" + currentLabel,
-		"mov $0, %eax",
-		"jmp done" + currentLabel,
-		"greaterequal" + currentLabel + ":",
-		"mov $1, %eax",
-		"done" + currentLabel + ":",
+		"setge %al",
+		"movzbl %al, %eax",
 		"push %eax",
 		" # End Greater Equal Node"
 	);
+
+	genSaved(node);
 }
 
 void CodeGenerator::visitEqualNode(EqualNode* node) {
-	node->visit_children(this);
+	if (genReused(node)) {
+		return;
+	}
+	if (genPushSelected(node)) {
+		return;
+	}
+	genOperands(node->expression_1, node->expression_2);
 
-	std::string currentLabel = std::to_string(nextLabel());
 	gen(
 		" # Begin Equal Node",
 		"pop %eax",
 		"pop %ebx",
 		"cmp %ebx, %eax",
-		"je equal" + currentLabel,
-		"mov $0, %eax",
-		"jmp done" + currentLabel,
-		"equal" + currentLabel + ":",
-		"mov $1, %eax",
-		"done" + currentLabel + ":",
+		"sete %al",
+		"movzbl %al, %eax",
 		"push %eax",
 		" # End Equal Node"
 	);
+
+	genSaved(node);
 }
 
 void CodeGenerator::visitAndNode(AndNode* node) {
-	node->visit_children(this);
+	if (genReused(node)) {
+		return;
+	}
+	if (genPushSelected(node)) {
+		return;
+	}
+	genOperands(node->expression_1, node->expression_2);
 
 	gen(
 		" # Begin And Node",
@@ -363,10 +1450,18 @@ void CodeGenerator::visitAndNode(AndNode* node) {
 		"push %eax",
 		" # End And Node"
 	);
+
+	genSaved(node);
 }
 
 void CodeGenerator::visitOrNode(OrNode* node) {
-	node->visit_children(this);
+	if (genReused(node)) {
+		return;
+	}
+	if (genPushSelected(node)) {
+		return;
+	}
+	genOperands(node->expression_1, node->expression_2);
 
 	gen(
 		" # Begin Or Node",
@@ -376,9 +1471,17 @@ void CodeGenerator::visitOrNode(OrNode* node) {
 		"push %eax",
 		" # End Or Node"
 	);
+
+	genSaved(node);
 }
 
 void CodeGenerator::visitNotNode(NotNode* node) {
+	if (genReused(node)) {
+		return;
+	}
+	if (genPushSelected(node)) {
+		return;
+	}
 	node->visit_children(this);
 
 	gen(
@@ -389,9 +1492,17 @@ void CodeGenerator::visitNotNode(NotNode* node) {
 		"push %eax",
 		" # End Not Node"
 	);
+
+	genSaved(node);
 }
 
 void CodeGenerator::visitNegationNode(NegationNode* node) {
+	if (genReused(node)) {
+		return;
+	}
+	if (genPushSelected(node)) {
+		return;
+	}
 	node->visit_children(this);
 
 	gen(
@@ -401,89 +1512,242 @@ void CodeGenerator::visitNegationNode(NegationNode* node) {
 		"push %eax",
 		" # End Negation Node"
 	);
+
+	genSaved(node);
 }
 
 void CodeGenerator::visitMethodCallNode(MethodCallNode* node) {
-    std::cout << " # Begin Method Call Node: ";
+    // only calls of pure methods are reused (see cse.hpp)
+    if (genReused(node)) {
+    	return;
+    }
+    *out << " # Begin Method Call Node: ";
     if (!node->identifier_2) {
-    	std::cout << node->identifier_1->name << std::endl;
+    	*out << node->identifier_1->name << std::endl;
     } else {
-    	std::cout << node->identifier_1->name + "(" + node->identifier_1->objectClassName + ")." + node->identifier_2->name << std::endl;
+    	*out << node->identifier_1->name + "(" + node->identifier_1->objectClassName + ")." + node->identifier_2->name << std::endl;
     }
 
+	std::string className = "";
+	std::string methodName = "";
+	bool direct = false;
+
+	if (!node->identifier_2) {
+		methodName = node->identifier_1->name;
+		className = currentClassName;
+		// Main's `this` is not an object (tester.c calls Main_main
+		// without one)
+		direct = className == "Main";
+	} else {
+		methodName = node->identifier_2->name;
+		className = node->identifier_1->objectClassName;
+	}
+	// A call runs the method the receiver's static class defines or
+	// inherits, unless a subclass overrides it: then it is dispatched
+	// through the receiver's vtable.
+	if (overriddenMethods && !overriddenMethods->count(className + "_" + methodName)) {
+		direct = true;
+	}
+	int slot = 0;
+	if (!direct) {
+		std::vector<std::pair<std::string, std::string> > vtable = vtableMethods(classTable, className);
+		while (vtable[slot].first != methodName) {
+			slot++;
+		}
+	}
+	while(!classTable->at(className).methods->count(methodName)) {
+			className = classTable->at(className).superClassName;
+	}
+	std::map<std::string, MethodNode*>::const_iterator callee;
+	bool inlined = direct && methodNodes && (callee = methodNodes->find(className + "_" + methodName)) != methodNodes->end()
+		&& shouldInline(callee->second, className);
+
+	// The register convention passes `this` in %eax and the first two
+	// arguments in %edx and %ecx; the callee stores them to its frame
+	// (see visitMethodBodyNode). Nothing else is live in a register
+	// across a call, so none is saved.
+	if (options.registerCalls && !inlined) {
+		int numArgs = genRegisterArguments(node->expression_list);
+		if (node->identifier_2) {
+			genObject(node->identifier_1->name, "%eax");
+		} else {
+			gen("mov " + thisAddress() + ", %eax");
+		}
+		if (!direct) {
+			std::string label = nextLabel();
+			gen(
+				"test %eax, %eax",
+				"jz nullcall" + label,
+				"mov -4(%eax), %ebx",
+				"call *" + std::to_string(8 + 4 * slot) + "(%ebx)",
+				genStackMap() + ":",
+				"jmp called" + label,
+				"nullcall" + label + ":",
+				"call " + methodLabel(className + "_" + methodName),
+				genStackMap() + ":",
+				"called" + label + ":"
+			);
+		} else {
+			gen(
+				"call " + methodLabel(className + "_" + methodName),
+				genStackMap() + ":"
+			);
+		}
+		operandTypes.resize(operandTypes.size() - numArgs);
+		if (numArgs) {
+			gen("add $" + std::to_string(4 * numArgs) + ", %esp");
+		}
+		gen(
+			"push %eax",
+			" # End Method Call Node"
+		);
+		genSaved(node);
+		return;
+	}
 
     gen(
     	"push %eax",
     	"push %ecx",
     	"push %edx"
     );
+    operandTypes.insert(operandTypes.end(), 3, false);
 
     int numArgs = 0;
     if (node->expression_list) {
    		numArgs = node->expression_list->size();
    		for (std::list<ExpressionNode*>::reverse_iterator iter = node->expression_list->rbegin(); iter != node->expression_list->rend(); iter++) {
    			(*iter)->accept(this);
+   			operandTypes.push_back((*iter)->basetype == bt_object);
    		}
 	}
 
-	int offset = 0;
-	std::string className = "";
-	std::string methodName = "";
+	if (node->identifier_2) {
+		genObject(node->identifier_1->name, "%eax");
+		gen("push %eax");
+	} else {
+		gen("push " + thisAddress());
+	}
 
-	if (!node->identifier_2) {
-		methodName = node->identifier_1->name;
-		className = currentClassName;
+	if (!direct) {
+		// The descriptor pointer is the word in front of the object,
+		// and the vtable starts two words into the descriptor. A null
+		// receiver has no vtable; it runs the static class's method,
+		// as a direct call would.
+		std::string label = nextLabel();
+		gen(
+			"mov (%esp), %eax",
+			"test %eax, %eax",
+			"jz nullcall" + label,
+			"mov -4(%eax), %eax",
+			"call *" + std::to_string(8 + 4 * slot) + "(%eax)",
+			genStackMap() + ":",
+			"jmp called" + label,
+			"nullcall" + label + ":",
+			"call " + methodLabel(className + "_" + methodName),
+			genStackMap() + ":",
+			"called" + label + ":"
+		);
+	} else if (inlined) {
+		// The inlined body builds the same frame the call would have
+		// (with a dummy return address), so it runs unchanged in the
+		// callee's context. Its labels come from this method.
+		std::string returnLabel = genStackMap();
+		std::string callerClassName = currentClassName;
+		std::string callerMethodName = currentMethodName;
+		int callerThisOffset = thisOffset;
+		std::vector<int> callerRegisterHomes;
+		callerRegisterHomes.swap(registerHomes);
+		std::string callerMemoTable;
+		callerMemoTable.swap(memoTable);
+		ClassInfo callerClassInfo = currentClassInfo;
+		MethodInfo callerMethodInfo = currentMethodInfo;
+		std::vector<bool> callerOperandTypes;
+		callerOperandTypes.swap(operandTypes);
+		MethodEscapes callerEscapes = escapes;
+		MethodValues callerValues = values;
+		MethodLoops callerLoops = loops;
+		currentClassName = className;
+		currentMethodName = methodName;
+		currentClassInfo = classTable->at(className);
+		currentMethodInfo = currentClassInfo.methods->at(methodName);
+		escapes = findStackObjects(callee->second, className, classTable, nonEscapingParameters);
+		currentMethodInfo.localsSize += escapes.frameSize;
+		values = numberValues(callee->second, className, classTable, escapes, currentMethodInfo.localsSize, pureMethods);
+		currentMethodInfo.localsSize += values.frameSize;
+		loops = findCountingLoops(callee->second, className, classTable, currentMethodInfo.localsSize);
+		currentMethodInfo.localsSize += loops.frameSize;
+		thisOffset = 8;
+		inlining = true;
 
-		offset += 8;
-	} else {
-		methodName = node->identifier_2->name;
-		className = node->identifier_1->objectClassName;
+		gen(
+			" # Begin Inlined Method: " + className + "_" + methodName,
+			"push $" + returnLabel
+		);
+		callee->second->methodbody->accept(this);
+		gen(
+			returnLabel + ":",
+			"add $4, %esp",
+			" # End Inlined Method: " + className + "_" + methodName
+		);
 
-		if (currentMethodInfo.variables->count(node->identifier_1->name)) {
-			offset += currentMethodInfo.variables->at(node->identifier_1->name).offset;
-		} 
-		else {
-			offset += 8 + currentClassInfo.members->at(node->identifier_1->name).offset;
-		}
-	}
-	while(!classTable->at(className).methods->count(methodName)) {
-			className = classTable->at(className).superClassName;
+		inlining = false;
+		operandTypes.swap(callerOperandTypes);
+		escapes = callerEscapes;
+		values = callerValues;
+		loops = callerLoops;
+		currentClassName = callerClassName;
+		currentMethodName = callerMethodName;
+		thisOffset = callerThisOffset;
+		registerHomes.swap(callerRegisterHomes);
+		memoTable.swap(callerMemoTable);
+		currentClassInfo = callerClassInfo;
+		currentMethodInfo = callerMethodInfo;
+	} else {
+		gen(
+			"call " + methodLabel(className + "_" + methodName),
+			genStackMap() + ":"
+		);
 	}
+	operandTypes.resize(operandTypes.size() - 3 - numArgs);
 
 	gen(
-		"push " + std::to_string(offset) + "(%ebp)",
-		"call " + className + "_" + methodName,
 		"add $" + std::to_string(4 * (numArgs + 1)) + ", %esp",
 		"mov %eax, %edi",
 		"pop %edx",
     	"pop %ecx",
     	"pop %eax",
-    	"mov %edi, %eax",
+    	"push %edi",
     	" # End Method Call Node"
 	);
+	genSaved(node);
 }
 
 void CodeGenerator::visitMemberAccessNode(MemberAccessNode* node) {
+    if (genReused(node)) {
+        return;
+    }
     node->visit_children(this);
 
     gen(" # Begin Member Access Node: " + node->identifier_1->name + "(" + node->identifier_1->objectClassName + ")." + node->identifier_2->name);
 
-    int variableOffset = classTable->at(node->identifier_1->objectClassName).members->at(node->identifier_2->name).offset;
-    int memberOffset = 0;
-    if (currentMethodInfo.variables->count(node->identifier_1->name)) {
-    	memberOffset += currentMethodInfo.variables->at(node->identifier_1->name).offset;
+    VariableInfo& member = classTable->at(node->identifier_1->objectClassName).members->at(node->identifier_2->name);
+    const StackObject* object = stackObject(node->identifier_1->name);
+    if (object) {
+    	genLoad(std::to_string(object->offset + member.offset) + "(%ebp)", member.size);
     } else {
-    	memberOffset += 8 + currentClassInfo.members->at(node->identifier_1->name).offset;
+    	genObject(node->identifier_1->name, "%eax");
+    	genLoad(std::to_string(member.offset) + "(%eax)", member.size);
     }
 
-    gen(
-    	"mov " + std::to_string(memberOffset) + "(%ebp), %eax",
-    	"push " + std::to_string(variableOffset) + "(%eax)",
-    	" # End Member Access"
-    );
+    gen(" # End Member Access");
+
+    genSaved(node);
 }
 
 void CodeGenerator::visitVariableNode(VariableNode* node) {
+    if (genReused(node)) {
+        return;
+    }
     node->visit_children(this);
 
     gen(" # Begin Variable Node: " + node->identifier->name);
@@ -495,15 +1759,15 @@ void CodeGenerator::visitVariableNode(VariableNode* node) {
     			at(node->identifier->name).offset) + "(%ebp)"
     	);
     } else {
-    	// member variable
-    	gen(
-    		"push " + std::to_string(8 + currentClassInfo.members->
-    			at(node->identifier->name).offset) + "(%ebp)"
-    	);
-    	//NEED TO SEPARATE MEMBER ACCESS THEN VARIABLE ACCESS
+    	// member variable (of `this`)
+    	VariableInfo& member = currentClassInfo.members->at(node->identifier->name);
+    	gen("mov " + thisAddress() + ", %eax");
+    	genLoad(std::to_string(member.offset) + "(%eax)", member.size);
     }
 
     gen(" # End Variable Node");
+
+    genSaved(node);
 }
 
 void CodeGenerator::visitIntegerLiteralNode(IntegerLiteralNode* node) {
@@ -525,46 +1789,79 @@ void CodeGenerator::visitBooleanLiteralNode(BooleanLiteralNode* node) {
 }
 
 void CodeGenerator::visitNewNode(NewNode* node) {
-    //node->visit_children(this);
+    std::string className = node->identifier->name;
+    std::string objectSize = std::to_string(classTable->at(className).membersSize);
+
+    // With register calls, nothing is live in the registers across an
+    // expression (see genRegisterArguments)
+    int numSaved = options.registerCalls ? 0 : 3;
+    gen(" # Begin New Node: " + className);
+    if (numSaved) {
+    	gen(
+    		"push %eax",
+    		"push %ecx",
+    		"push %edx"
+    	);
+    }
+    operandTypes.insert(operandTypes.end(), numSaved, false);
 
-    std::string objectSize = std::to_string(classTable->at(node->identifier->name).membersSize);
+    // The constructor's arguments are evaluated before the object is
+    // allocated, so the new object is never held only in a register
+    // while they are evaluated (which may allocate and collect).
+    int numArgs = 0;
+    if (node->expression_list) {
+    	numArgs = node->expression_list->size();
+    	for (std::list<ExpressionNode*>::reverse_iterator iter = node->expression_list->rbegin(); iter != node->expression_list->rend(); iter++) {
+    		(*iter)->accept(this);
+    		operandTypes.push_back((*iter)->basetype == bt_object);
+    	}
+    }
 
+    // gc_alloc(size, class, frame) returns the object with its members
+    // zeroed; the frame pointer is where the collector starts walking
     gen(
-    	" # Begin New Node: " + node->identifier->name,
+    	"push %ebp",
+    	"push $vtable_" + className,
     	"push $" + objectSize,
-    	"call malloc",
-   		"add $4, %esp",
-   		"mov %eax, %edi"
-   	);
+    	"call gc_alloc",
+    	genStackMap() + ":",
+    	"add $12, %esp"
+    );
 
-    if (classTable->at(node->identifier->name).methods->count(node->identifier->name)) {
+    if (classTable->at(className).methods->count(className) && options.registerCalls) {
+    	numArgs = genPopRegisterArguments(numArgs);
+    	gen(
+    		"call " + className + "_" + className,
+    		genStackMap() + ":"
+    	);
+    	if (numArgs) {
+    		gen("add $" + std::to_string(4 * numArgs) + ", %esp");
+    	}
+    } else if (classTable->at(className).methods->count(className)) {
     	gen(
     		"push %eax",
-    		"push %ecx",
-    		"push %edx"
+    		"call " + className + "_" + className,
+    		genStackMap() + ":",
+    		"add $" + std::to_string(4 * (numArgs + 1)) + ", %esp"
     	);
+    } else if (numArgs) {
+    	gen("add $" + std::to_string(4 * numArgs) + ", %esp");
+    }
+    operandTypes.resize(operandTypes.size() - numSaved - numArgs);
 
-    	int numArgs = 0;
-    	if (node->expression_list) {
-    		numArgs = node->expression_list->size();
-   			for (std::list<ExpressionNode*>::reverse_iterator iter = node->expression_list->rbegin(); iter != node->expression_list->rend(); iter++) {
-   				(*iter)->accept(this);
-   			}
-		}
-
-		gen(
-			"push %edi",
-			"call " + node->identifier->name + "_" + node->identifier->name,
-			"add $" + std::to_string(4 * (numArgs + 1)) + ", %esp",
-			"mov %eax, %edi",
-			"pop %edx",
-    		"pop %ecx",
-    		"pop %eax",
-    		"mov %edi, %eax"
-		);
+    if (!numSaved) {
+    	gen(
+    		"push %eax",
+    		" # End New Node"
+    	);
+    	return;
     }
     gen(
-    	"push %eax",
+    	"mov %eax, %edi",
+    	"pop %edx",
+    	"pop %ecx",
+    	"pop %eax",
+    	"push %edi",
     	" # End New Node"
    	);
 }
@@ -592,3 +1889,129 @@ void CodeGenerator::visitIdentifierNode(IdentifierNode* node) {
 void CodeGenerator::visitIntegerNode(IntegerNode* node) {
     // WRITEME: Replace with code if necessary
 }
+
+std::vector<std::pair<std::string, std::string> > vtableMethods(ClassTable* classTable, const std::string& className) {
+	std::vector<std::pair<std::string, std::string> > vtable;
+	ClassInfo& info = classTable->at(className);
+	if (info.superClassName != "") {
+		vtable = vtableMethods(classTable, info.superClassName);
+	}
+	for (MethodTable::iterator it = info.methods->begin(); it != info.methods->end(); it++) {
+		size_t slot = 0;
+		while (slot < vtable.size() && vtable[slot].first != it->first) {
+			slot++;
+		}
+		if (slot == vtable.size()) {
+			vtable.push_back(std::make_pair(it->first, ""));
+		}
+		vtable[slot].second = className + "_" + it->first;
+	}
+	return vtable;
+}
+
+void findOverriddenMethods(ClassTable* classTable, std::set<std::string>& overridden) {
+	for (ClassTable::iterator c = classTable->begin(); c != classTable->end(); c++) {
+		for (MethodTable::iterator m = c->second.methods->begin(); m != c->second.methods->end(); m++) {
+			for (std::string name = c->second.superClassName; name != ""; name = classTable->at(name).superClassName) {
+				overridden.insert(name + "_" + m->first);
+			}
+		}
+	}
+}
+
+void collectMethods(ProgramNode* program, std::map<std::string, MethodNode*>& methods) {
+	for (std::list<ClassNode*>::iterator c = program->class_list->begin(); c != program->class_list->end(); c++) {
+		if ((*c)->method_list) {
+			for (std::list<MethodNode*>::iterator m = (*c)->method_list->begin(); m != (*c)->method_list->end(); m++) {
+				methods[(*c)->identifier_1->name + "_" + (*m)->identifier->name] = *m;
+			}
+		}
+	}
+}
+
+// Parallel code generation: after type checking, the code for each
+// method only depends on the (now read-only) class table, so every
+// method is generated by its own CodeGenerator into its own buffer.
+// Labels are numbered per method so buffers never clash, and they are
+// written out in source order so the output is deterministic.
+void generateParallel(ProgramNode* program, ClassTable* classTable, int threads, const CodeGenOptions& options, std::ostream& out) {
+	std::vector<ClassNode*> classes;
+	std::vector<std::pair<ClassNode*, MethodNode*> > methods;
+	for (std::list<ClassNode*>::iterator c = program->class_list->begin(); c != program->class_list->end(); c++) {
+		classes.push_back(*c);
+		if ((*c)->method_list) {
+			for (std::list<MethodNode*>::iterator m = (*c)->method_list->begin(); m != (*c)->method_list->end(); m++) {
+				methods.push_back(std::make_pair(*c, *m));
+			}
+		}
+	}
+
+	std::string output;
+	bool evaluated = options.evaluate.steps && !options.profile && evaluateProgram(program, classTable, options.evaluate, output);
+	std::set<std::string> reachable;
+	if (evaluated) {
+		reachable.insert("Main_main");
+	} else {
+		propagateConstants(program, classTable);
+		eliminateDeadCode(program, classTable, reachable, NULL);
+	}
+	std::map<std::string, MethodNode*> methodNodes;
+	if (options.profileData) {
+		collectMethods(program, methodNodes);
+	}
+	std::set<std::string> parameters;
+	findNonEscapingParameters(program, classTable, parameters);
+	std::set<std::string> overridden;
+	findOverriddenMethods(classTable, overridden);
+	std::set<std::string> pure;
+	findPureMethods(program, classTable, overridden, pure);
+
+	std::vector<std::ostringstream> buffers(methods.size());
+	std::atomic<size_t> next(0);
+
+	auto worker = [&]() {
+		for (size_t i = next++; i < methods.size(); i = next++) {
+			CodeGenerator codegen;
+			codegen.out = &buffers[i];
+			codegen.classTable = classTable;
+			codegen.methodLabels = true;
+			codegen.options = options;
+			codegen.methodNodes = options.profileData ? &methodNodes : NULL;
+			codegen.nonEscapingParameters = &parameters;
+			codegen.overriddenMethods = &overridden;
+			codegen.pureMethods = &pure;
+			codegen.reachableMethods = &reachable;
+			codegen.evaluatedOutput = evaluated ? &output : NULL;
+			codegen.currentClassName = methods[i].first->identifier_1->name;
+			codegen.currentClassInfo = classTable->at(codegen.currentClassName);
+			methods[i].second->accept(&codegen);
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (int i = 1; i < threads; i++) {
+		pool.push_back(std::thread(worker));
+	}
+	worker();
+	for (size_t i = 0; i < pool.size(); i++) {
+		pool[i].join();
+	}
+
+	// the descriptors name the methods the way the workers labelled them
+	CodeGenerator codegen;
+	codegen.out = &out;
+	codegen.classTable = classTable;
+	codegen.options = options;
+	codegen.reachableMethods = &reachable;
+	codegen.genProgramPrologue();
+	size_t method = 0;
+	for (size_t i = 0; i < classes.size(); i++) {
+		out << " # Begin Class Node: " << classes[i]->identifier_1->name << std::endl;
+		codegen.genClassDescriptor(classes[i]->identifier_1->name);
+		while (method < methods.size() && methods[method].first == classes[i]) {
+			out << buffers[method++].str();
+		}
+		out << " # End Class Node: " << classes[i]->identifier_1->name << std::endl;
+	}
+	codegen.genProgramEpilogue();
+}
@@ -3,6 +3,55 @@
 
 #include "ast.hpp"
 #include "typecheck.hpp"
+#include "profile.hpp"
+#include "escape.hpp"
+#include "cse.hpp"
+#include "loops.hpp"
+#include "deadcode.hpp"
+#include "isel.hpp"
+#include "evaluate.hpp"
+#include "interproc.hpp"
+
+#include <map>
+#include <set>
+#include <vector>
+
+// Defines the options that change the generated code (as opposed
+// to how it is generated).
+struct CodeGenOptions {
+  // Count how often every method is called and every loop body and
+  // branch is run. The counters are written to a profile file when
+  // the program exits (see tester.c).
+  bool profile;
+  // Also count the processor cycles spent in every method (including
+  // the methods it calls), using rdtsc.
+  bool profileTime;
+  // A profile of an earlier run of the program. Hot call sites of
+  // small methods are inlined, the more frequent arm of every if and
+  // the body of every hot loop are laid out on the fall-through path,
+  // and methods that never ran are moved to .text.unlikely.
+  const ProfileData* profileData;
+  // Counting loops (see loops.hpp) with small bodies are unrolled this
+  // many times; 1 turns unrolling off. Instrumented code is never
+  // unrolled, so every counter stays in one place.
+  int unroll;
+  // Compiled methods call each other with `this` in %eax and their
+  // first two arguments in %edx and %ecx (the rest are pushed as
+  // usual), and Main_main is a cdecl thunk for tester.c. Every class of
+  // a program must be compiled with the same convention.
+  bool registerCalls;
+  // Main.main is run at compile time within this budget (see
+  // evaluate.hpp), and if it finishes, the program only writes what it
+  // printed. No steps turn evaluation off, and so does profiling.
+  EvaluationBudget evaluate;
+  // Pure methods (see interproc.hpp) worth it keep the values they
+  // return in a memo table indexed by their arguments, and return the
+  // value from it when they are called with the same arguments again.
+  // Instrumented code has no memo tables.
+  bool memoize;
+
+  CodeGenOptions() : profile(false), profileTime(false), profileData(NULL), unroll(4), registerCalls(false), memoize(false) {}
+};
 
 // This defines the CodeGenerator visitor, which will visit
 // the AST and generate x86 assembly code. You will do all
@@ -16,6 +65,143 @@
 class CodeGenerator : public Visitor {
 private:
   int currentLabel;
+  std::string labelPrefix;
+
+  // The (kind, line) of every profile counter of the current method;
+  // the counters are emitted after the method's code.
+  std::vector<std::pair<ProfileCounterKind, int> > profileCounters;
+
+  // Emits the code that increments a new profile counter and returns
+  // the counter's label.
+  std::string genCounter(ProfileCounterKind kind, int line);
+  void genProfileCounters();
+
+  // The profile count of the block being generated (-1 if unknown),
+  // and whether a method is being inlined.
+  long long blockCount;
+  bool inlining;
+
+  // Returns the profile count of a block of the current method.
+  long long profileCount(int line, ProfileCounterKind kind);
+  void genStatements(std::list<StatementNode*>* statements, long long count);
+  bool shouldInline(MethodNode* callee, const std::string& className);
+
+  // Garbage collection (see tester.c) needs to find every object
+  // pointer on the stack whenever an object is allocated. These are
+  // the values the current method has pushed while evaluating an
+  // expression (true for object pointers), and the stack maps of the
+  // current method: for the return address of every call, the frame
+  // offsets (from %ebp) of the slots holding object pointers.
+  std::vector<bool> operandTypes;
+  std::vector<std::pair<std::string, std::vector<int> > > stackMaps;
+
+  void genOperands(ExpressionNode* left, ExpressionNode* right);
+  // Records the stack map for the return address of a call (or of
+  // an inlined call) and returns the label to put at that address.
+  std::string genStackMap();
+  void genStackMaps();
+
+  // The objects of the current method that are allocated in its
+  // frame (see escape.hpp). Their members are addressed directly.
+  MethodEscapes escapes;
+
+  // Returns the frame object held by a variable of the current
+  // method, or NULL if the variable does not have one.
+  const StackObject* stackObject(const std::string& name);
+  void genStackNew(NewNode* node, const std::string& variable, const StackObject& object);
+
+  // The values of the current method that are computed once and
+  // reused (see cse.hpp).
+  MethodValues values;
+
+  // Pushes the saved value of an expression that is not computed
+  // again and returns true, or returns false.
+  bool genReused(ExpressionNode* node);
+  // Saves the value of an expression that is reused later.
+  void genSaved(ExpressionNode* node);
+
+  // The counting loops of the current method (see loops.hpp).
+  MethodLoops loops;
+
+  // Returns the counting loop of a while or do while statement, or
+  // NULL if it is not one.
+  const CountingLoop* countingLoop(StatementNode* node);
+  // Sets the temporaries of a loop's reduced products before the loop,
+  // and steps them after an increment of its induction variable.
+  void genStartProducts(const CountingLoop& loop);
+  void genStepProducts(AssignmentNode* node);
+  // Runs the body of a counting loop options.unroll times per
+  // iteration for as long as that many iterations are left (or emits
+  // nothing if the loop is not unrolled).
+  void genUnrolled(const CountingLoop& loop, std::list<StatementNode*>* statements, long long count);
+
+  // Instruction selection (see isel.hpp): expressions the selector
+  // covers are computed in registers, and the templates of the
+  // visitors are left for the rest.
+  InstructionSelector selector();
+  // Defines how the selector reads an expression of the current
+  // method.
+  SelectionInfo selectionInfo(ExpressionNode* node);
+  // Computes an expression the selector covers and returns its operand
+  // (an immediate or a register), or returns "" if it does not.
+  std::string genSelected(ExpressionNode* node);
+  // Pushes an expression the selector covers and returns true, or
+  // returns false.
+  bool genPushSelected(ExpressionNode* node);
+  // Jumps to a label if a condition is true (when is set) or false.
+  void genBranch(ExpressionNode* condition, bool when, const std::string& label);
+  // Lowers an if whose arms only assign one local to a conditional
+  // move and returns true, or returns false.
+  bool genConditionalMove(IfElseNode* node);
+
+  // The register calling convention (see CodeGenOptions): the current
+  // method keeps `this` and its register arguments in its frame, at
+  // these offsets, and its variables (with the offsets of its
+  // parameters moved) in registerVariables. `this` is at 8(%ebp)
+  // otherwise, and always in an inlined body.
+  int thisOffset;
+  std::vector<int> registerHomes;
+  VariableTable registerVariables;
+  std::string thisAddress();
+  // Returns the label of a method (given as Class_method).
+  std::string methodLabel(const std::string& name);
+  // Leaves the first two arguments of a call in %edx and %ecx and
+  // pushes the rest, in reverse, and returns how many were pushed.
+  int genRegisterArguments(std::list<ExpressionNode*>* arguments);
+  // Pops the first two of the pushed arguments of a call into %edx
+  // and %ecx, and returns how many are left pushed.
+  int genPopRegisterArguments(int numArgs);
+
+  // The memo table of the current method (see CodeGenOptions::memoize),
+  // or "", and the frame offsets of its parameters (the key). An entry
+  // is a word that is set once the entry is filled, the key and the
+  // value.
+  std::string memoTable;
+  std::vector<int> memoKeys;
+  // Leaves the address of the entry for the current arguments in %ebx
+  // (using %ecx).
+  void genMemoEntry();
+
+  // Emits Main_main as a call of printf with the evaluated output as
+  // the format (it only holds digits, minus signs and newlines).
+  void genEvaluatedMain();
+
+  // Loads the object held by a local or a member of `this` into a
+  // register.
+  void genObject(const std::string& name, const std::string& reg);
+  // Push the member at an address, or store %eax into it. Booleans
+  // are single bytes in objects (see TypeCheck::collectClass).
+  void genLoad(const std::string& address, int size);
+  void genStore(const std::string& address, int size);
+
+  // Writes one line of assembly to the output stream.
+  void gen(std::string str);
+
+  template<typename... Args>
+  void gen(std::string str, Args... args) {
+    gen(str);
+    gen(args...);
+  }
 public:
   // This member is the ClassTable pointer for the symbol
   // table. The main file sets this appropraitely to the
@@ -39,11 +225,78 @@ public:
   ClassInfo currentClassInfo;
   MethodInfo currentMethodInfo;
   
-  int nextLabel() {
-    return currentLabel++;
+  // The stream all generated assembly is written to. This is
+  // std::cout unless the generator writes into a buffer (as the
+  // parallel code generator does).
+  std::ostream* out;
+
+  // When this is set, label numbering restarts in every method
+  // and labels are prefixed with the method's name, so the code
+  // for each method can be generated independently.
+  bool methodLabels;
+
+  // When this is set, every method's label is made global so
+  // methods can be called from separately compiled files.
+  bool exportMethods;
+
+  // When this is set, the number of instructions generated for
+  // every method is appended to it (for --time-report).
+  std::vector<std::pair<std::string, int> >* instructionCounts;
+
+  CodeGenOptions options;
+
+  // The AST of every method by Class_method name, for inlining. When
+  // this is NULL (as when classes are generated one at a time), no
+  // calls are inlined.
+  const std::map<std::string, MethodNode*>* methodNodes;
+
+  // The object parameters that do not escape (see escape.hpp), so
+  // frame objects may be passed to them. When this is NULL (as when
+  // classes are generated one at a time), passing an object as an
+  // argument makes it escape.
+  const std::set<std::string>* nonEscapingParameters;
+
+  // The methods that may run a different method depending on the
+  // class of the object they are called on, as "Class_method" (see
+  // findOverriddenMethods). Calls of all other methods are direct.
+  // When this is NULL (as when classes are generated one at a time),
+  // every call is dispatched through the vtable.
+  const std::set<std::string>* overriddenMethods;
+
+  // The methods Main.main can reach, as "Class_method" (see
+  // deadcode.hpp). No code is generated for the others, and their
+  // vtable slots are null. When this is NULL (as when classes are
+  // generated one at a time), every method is generated.
+  const std::set<std::string>* reachableMethods;
+
+  // The output of the program, when it was evaluated at compile time
+  // (see evaluate.hpp). Only Main.main is generated then, as a write
+  // of it. When this is NULL, the program is compiled as usual.
+  const std::string* evaluatedOutput;
+
+  // The pure methods, as "Class_method" (see interproc.hpp). Their
+  // calls are numbered as values (see cse.hpp), and they may get memo
+  // tables. When this is NULL (as when classes are generated one at a
+  // time), no method is known to be pure.
+  const std::set<std::string>* pureMethods;
+
+  std::string nextLabel() {
+    return labelPrefix + std::to_string(currentLabel++);
   }
   
-  CodeGenerator() : currentLabel(0) {}
+  CodeGenerator() : currentLabel(0), blockCount(-1), inlining(false), thisOffset(8), out(&std::cout), methodLabels(false), exportMethods(false), instructionCounts(NULL), methodNodes(NULL), nonEscapingParameters(NULL), overriddenMethods(NULL), reachableMethods(NULL), evaluatedOutput(NULL), pureMethods(NULL) {}
+
+  // These functions emit the code that begins and ends the
+  // whole program. visitProgramNode emits them around its
+  // children; the streaming pipeline in main.cpp emits them
+  // around the classes it generates one at a time.
+  void genProgramPrologue();
+  void genProgramEpilogue();
+
+  // Emits the descriptor of a class, which every object of the class
+  // points to from its header: the size of the object, the offsets of
+  // its members that hold objects (for the collector), and its vtable.
+  void genClassDescriptor(const std::string& className);
   
   // All the visitor functions. You will need to write
   // appropriate implementation in codegeneration.cpp.
@@ -85,4 +338,23 @@ public:
   virtual void visitIntegerNode(IntegerNode* node);
 };
 
+// Returns the vtable of a class: the name of the method in every slot
+// and the Class_method label of the code it runs. The slots of the
+// superclass come first, in the same order, so a method is in the same
+// slot in every subclass.
+std::vector<std::pair<std::string, std::string> > vtableMethods(ClassTable* classTable, const std::string& className);
+
+// Class hierarchy analysis: adds "Class_method" for every method of
+// every class that a (direct or indirect) subclass defines again.
+void findOverriddenMethods(ClassTable* classTable, std::set<std::string>& overridden);
+
+// Adds every method of the program to a map from Class_method names
+// to their ASTs (see CodeGenerator::methodNodes).
+void collectMethods(ProgramNode* program, std::map<std::string, MethodNode*>& methods);
+
+// Generates code for the whole (type checked) program, generating
+// methods concurrently on the given number of threads. The output is
+// the same for any number of threads.
+void generateParallel(ProgramNode* program, ClassTable* classTable, int threads, const CodeGenOptions& options, std::ostream& out);
+
 #endif
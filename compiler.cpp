@@ -0,0 +1,122 @@
+#include "compiler.hpp"
+#include "parser.hpp"
+#include "cache.hpp"
+
+#include <sstream>
+
+// The reentrant lexer interface (defined in the generated lexer.cpp)
+struct yy_buffer_state;
+typedef yy_buffer_state* YY_BUFFER_STATE;
+int yylex_init_extra(ParseState* state, yyscan_t* scanner);
+int yylex_destroy(yyscan_t scanner);
+void yyset_in(FILE* input, yyscan_t scanner);
+YY_BUFFER_STATE yy_scan_bytes(const char* bytes, int length, yyscan_t scanner);
+void yy_delete_buffer(YY_BUFFER_STATE buffer, yyscan_t scanner);
+
+static ProgramNode* finishParse(ParseState& state, std::vector<std::string>& errors) {
+  errors.insert(errors.end(), state.errors.begin(), state.errors.end());
+  if (!state.errors.empty()) {
+    delete state.root;
+    return NULL;
+  }
+  return state.root;
+}
+
+ProgramNode* parseProgram(FILE* input, std::vector<std::string>& errors, ClassHandler onClass, double* lexTime) {
+  ParseState state;
+  state.root = NULL;
+  state.onClass = onClass;
+  state.lexTime = lexTime;
+
+  yyscan_t scanner;
+  yylex_init_extra(&state, &scanner);
+  yyset_in(input, scanner);
+  try {
+    yyparse(scanner, &state);
+  } catch (...) {
+    // a type error thrown by onClass while streaming
+    yylex_destroy(scanner);
+    throw;
+  }
+  yylex_destroy(scanner);
+
+  return finishParse(state, errors);
+}
+
+ProgramNode* parseProgram(const std::string& source, std::vector<std::string>& errors, ClassHandler onClass) {
+  ParseState state;
+  state.root = NULL;
+  state.onClass = onClass;
+  state.lexTime = NULL;
+
+  yyscan_t scanner;
+  yylex_init_extra(&state, &scanner);
+  YY_BUFFER_STATE buffer = yy_scan_bytes(source.data(), source.size(), scanner);
+  try {
+    yyparse(scanner, &state);
+  } catch (...) {
+    yy_delete_buffer(buffer, scanner);
+    yylex_destroy(scanner);
+    throw;
+  }
+  yy_delete_buffer(buffer, scanner);
+  yylex_destroy(scanner);
+
+  return finishParse(state, errors);
+}
+
+ClassTable* typeCheckProgram(ProgramNode* program, const CompileOptions& options) {
+  if (options.jobs) {
+    return typeCheckParallel(program, options.jobs);
+  }
+  TypeCheck typecheck;
+  typecheck.classTable = NULL;
+  try {
+    program->accept(&typecheck);
+  } catch (TypeErrorException& e) {
+    if (typecheck.classTable) {
+      deleteClassTable(typecheck.classTable);
+    }
+    throw;
+  }
+  return typecheck.classTable;
+}
+
+void generateProgram(ProgramNode* program, ClassTable* classTable, const CompileOptions& options, std::ostream& out) {
+  if (options.jobs) {
+    generateParallel(program, classTable, options.jobs, options.codegen, out);
+    return;
+  }
+  CodeGenerator codegen;
+  codegen.out = &out;
+  codegen.classTable = classTable;
+  codegen.options = options.codegen;
+  program->accept(&codegen);
+}
+
+CompileResult compile(const std::string& source, const CompileOptions& options) {
+  CompileResult result;
+
+  ProgramNode* program = parseProgram(source, result.errors);
+  if (!program) {
+    return result;
+  }
+
+  try {
+    std::ostringstream assembly;
+    if (!options.cacheDirectory.empty()) {
+      CacheStats stats;
+      compileCached(program, options, assembly, stats);
+    } else {
+      ClassTable* classTable = typeCheckProgram(program, options);
+      generateProgram(program, classTable, options, assembly);
+      deleteClassTable(classTable);
+    }
+    result.assembly = assembly.str();
+  } catch (TypeErrorException& e) {
+    result.errors.push_back(typeErrorMessage(e.code));
+  }
+
+  delete program;
+  return result;
+}
@@ -0,0 +1,73 @@
+#ifndef __COMPILER_HPP
+#define __COMPILER_HPP
+
+#include "ast.hpp"
+#include "typecheck.hpp"
+#include "codegeneration.hpp"
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+// This file defines the library interface to the compiler. The
+// lexer and parser are reentrant and keep all of their state in
+// a ParseState, and type errors are thrown rather than ending
+// the process, so any number of programs may be compiled in one
+// process (and from several threads at once).
+
+// Called with every class as soon as the parser reduces it.
+typedef std::function<void(ClassNode*)> ClassHandler;
+
+// Defines the state of a single parse, shared by the parser and
+// the lexer (which keeps a pointer to it as its "extra" data).
+// If onClass is set, classes are handed to it instead of being
+// added to the ProgramNode.
+struct ParseState {
+  ProgramNode* root;
+  ClassHandler onClass;
+  std::vector<std::string> errors;
+  // If this is set, the time spent in the lexer is added to it
+  // (in milliseconds).
+  double* lexTime;
+};
+
+// Defines the options that control a compilation.
+struct CompileOptions {
+  // Number of threads used to type check method bodies and to
+  // generate code (0 checks and generates sequentially).
+  int jobs;
+  // Directory of the incremental compilation cache (see cache.hpp),
+  // or empty to compile without a cache.
+  std::string cacheDirectory;
+  // Options of the generated code.
+  CodeGenOptions codegen;
+
+  CompileOptions() : jobs(0) {}
+};
+
+// Defines the result of compiling a program: the generated
+// assembly, or the syntax and type errors found (in which case
+// the assembly is empty).
+struct CompileResult {
+  std::string assembly;
+  std::vector<std::string> errors;
+};
+
+// Parse a program from a file or from memory. Returns NULL and
+// appends to errors if the program has syntax errors.
+// If lexTime is given, the time spent lexing is added to it.
+ProgramNode* parseProgram(FILE* input, std::vector<std::string>& errors, ClassHandler onClass = ClassHandler(), double* lexTime = NULL);
+ProgramNode* parseProgram(const std::string& source, std::vector<std::string>& errors, ClassHandler onClass = ClassHandler());
+
+// Type checks a parsed program and returns its class table.
+// Throws a TypeErrorException if the program has a type error.
+ClassTable* typeCheckProgram(ProgramNode* program, const CompileOptions& options);
+
+// Generates the assembly for a type checked program.
+void generateProgram(ProgramNode* program, ClassTable* classTable, const CompileOptions& options, std::ostream& out);
+
+// Compiles a whole program held in memory.
+CompileResult compile(const std::string& source, const CompileOptions& options = CompileOptions());
+
+#endif
@@ -0,0 +1,306 @@
+#include "cse.hpp"
+
+#include <algorithm>
+#include <vector>
+
+// This visitor numbers the values of a method body in the order the
+// generated code computes them, and records the expressions whose
+// value was computed before in their block.
+class ValueNumbering : public Visitor {
+private:
+  const MethodInfo& method;
+  const MethodEscapes& escapes;
+  std::string className;
+  ClassTable* classTable;
+  const std::set<std::string>* pureMethods;
+
+  // The number of every operator, load and literal, by its key (the
+  // operator and the numbers of its operands)
+  std::map<std::string, int> numbers;
+  int values;
+  // The number of the value every local of the method holds
+  std::map<std::string, int> variables;
+  // The state of memory: changed by every store, call and new
+  int memory;
+  // The expression that first computed each value in the current
+  // block, and the values in the order they were added
+  std::map<int, ExpressionNode*> available;
+  std::vector<int> added;
+  int block;
+
+  // The number of the last expression visited, or -1 if its value
+  // cannot be known (it calls a method or creates an object)
+  int value;
+
+  int number(const std::string& key) {
+    std::map<std::string, int>::iterator it = numbers.find(key);
+    if (it != numbers.end()) {
+      return it->second;
+    }
+    return numbers[key] = values++;
+  }
+
+  int variable(const std::string& name) {
+    if (!variables.count(name)) {
+      variables[name] = values++;
+    }
+    return variables[name];
+  }
+
+  // Returns the key of a load of a member of the object with the
+  // given number.
+  std::string load(int object, const std::string& member) {
+    return "load " + std::to_string(object) + " " + member + " " + std::to_string(memory);
+  }
+
+  // Returns the number of the object held by a local or a member of
+  // `this`.
+  int object(const std::string& name) {
+    if (method.variables->count(name)) {
+      return variable(name);
+    }
+    return number(load(number("this"), name));
+  }
+
+  void endBlock() {
+    available.clear();
+    added.clear();
+    variables.clear();
+    memory++;
+    block++;
+  }
+
+  // Numbers an expression whose operands were numbered since there
+  // were reuseStart reuses and addedStart available values. If its
+  // value is available, the code for its operands is not generated
+  // either, so their reuses and values are dropped.
+  void numbered(ExpressionNode* node, const std::string& key, bool worthwhile, size_t reuseStart, size_t addedStart) {
+    if (key.empty()) {
+      value = -1;
+      return;
+    }
+    value = number(key);
+    if (!worthwhile || node->basetype == bt_object) {
+      return;
+    }
+
+    std::map<int, ExpressionNode*>::iterator it = available.find(value);
+    if (it == available.end()) {
+      available[value] = node;
+      added.push_back(value);
+      blocks[node] = block;
+      return;
+    }
+    ExpressionNode* source = it->second;
+    reuses.resize(reuseStart);
+    while (added.size() > addedStart) {
+      available.erase(added.back());
+      added.pop_back();
+    }
+    reuses.push_back(std::make_pair(node, source));
+  }
+
+  void binary(ExpressionNode* node, const std::string& op, ExpressionNode* left, ExpressionNode* right, bool commutative) {
+    size_t reuseStart = reuses.size();
+    size_t addedStart = added.size();
+    left->accept(this);
+    int leftValue = value;
+    right->accept(this);
+    int rightValue = value;
+    if (commutative && leftValue > rightValue) {
+      std::swap(leftValue, rightValue);
+    }
+    std::string key;
+    if (leftValue >= 0 && rightValue >= 0) {
+      key = op + " " + std::to_string(leftValue) + " " + std::to_string(rightValue);
+    }
+    numbered(node, key, true, reuseStart, addedStart);
+  }
+
+  void unary(ExpressionNode* node, const std::string& op, ExpressionNode* operand) {
+    size_t reuseStart = reuses.size();
+    size_t addedStart = added.size();
+    operand->accept(this);
+    numbered(node, value >= 0 ? op + " " + std::to_string(value) : "", true, reuseStart, addedStart);
+  }
+
+  // Numbers the arguments of a call or new (last to first, as they
+  // are pushed). The method or constructor may store to any member.
+  void visitArguments(std::list<ExpressionNode*>* arguments) {
+    if (arguments) {
+      for (std::list<ExpressionNode*>::reverse_iterator it = arguments->rbegin(); it != arguments->rend(); it++) {
+        (*it)->accept(this);
+      }
+    }
+    memory++;
+    value = -1;
+  }
+
+  void visitStatements(std::list<StatementNode*>* statements) {
+    if (statements) {
+      for (std::list<StatementNode*>::iterator it = statements->begin(); it != statements->end(); it++) {
+        (*it)->accept(this);
+      }
+    }
+  }
+
+public:
+  // Every expression whose value is reused, with the expression that
+  // computed the value first
+  std::vector<std::pair<ExpressionNode*, ExpressionNode*> > reuses;
+  // The block of every expression that computed a value first
+  std::map<ExpressionNode*, int> blocks;
+
+  ValueNumbering(const MethodInfo& method, const MethodEscapes& escapes, const std::string& className, ClassTable* classTable, const std::set<std::string>* pureMethods)
+      : method(method), escapes(escapes), className(className), classTable(classTable), pureMethods(pureMethods),
+        values(0), memory(0), block(0), value(-1) {}
+
+  virtual void visitProgramNode(ProgramNode* node) { node->visit_children(this); }
+  virtual void visitClassNode(ClassNode* node) { node->visit_children(this); }
+  virtual void visitMethodNode(MethodNode* node) { node->visit_children(this); }
+  virtual void visitMethodBodyNode(MethodBodyNode* node) { node->visit_children(this); }
+  virtual void visitParameterNode(ParameterNode* node) {}
+  virtual void visitDeclarationNode(DeclarationNode* node) {}
+  virtual void visitReturnStatementNode(ReturnStatementNode* node) { node->visit_children(this); }
+
+  virtual void visitAssignmentNode(AssignmentNode* node) {
+    std::string name = node->identifier_1->name;
+    node->expression->accept(this);
+    int stored = value >= 0 ? value : values++;
+
+    if (node->identifier_2) {
+      // the object is loaded after the value is computed; only a store
+      // through a local is remembered (a member of `this` holding the
+      // object could be the member stored to)
+      int target = object(name);
+      memory++;
+      if (method.variables->count(name)) {
+        numbers[load(target, node->identifier_2->name)] = stored;
+      }
+    } else if (method.variables->count(name)) {
+      variables[name] = stored;
+    } else {
+      memory++;
+      numbers[load(number("this"), name)] = stored;
+    }
+  }
+
+  virtual void visitCallNode(CallNode* node) { node->visit_children(this); }
+
+  virtual void visitIfElseNode(IfElseNode* node) {
+    node->expression->accept(this);
+    endBlock();
+    visitStatements(node->statement_list_1);
+    endBlock();
+    visitStatements(node->statement_list_2);
+    endBlock();
+  }
+
+  virtual void visitWhileNode(WhileNode* node) {
+    endBlock();
+    node->expression->accept(this);
+    endBlock();
+    visitStatements(node->statement_list);
+    endBlock();
+  }
+
+  virtual void visitPrintNode(PrintNode* node) { node->visit_children(this); }
+
+  // the condition runs straight after the body, in its last block
+  virtual void visitDoWhileNode(DoWhileNode* node) {
+    endBlock();
+    visitStatements(node->statement_list);
+    node->expression->accept(this);
+    endBlock();
+  }
+
+  virtual void visitPlusNode(PlusNode* node) { binary(node, "+", node->expression_1, node->expression_2, true); }
+  virtual void visitMinusNode(MinusNode* node) { binary(node, "-", node->expression_1, node->expression_2, false); }
+  virtual void visitTimesNode(TimesNode* node) { binary(node, "*", node->expression_1, node->expression_2, true); }
+  virtual void visitDivideNode(DivideNode* node) { binary(node, "/", node->expression_1, node->expression_2, false); }
+  virtual void visitGreaterNode(GreaterNode* node) { binary(node, ">", node->expression_1, node->expression_2, false); }
+  virtual void visitGreaterEqualNode(GreaterEqualNode* node) { binary(node, ">=", node->expression_1, node->expression_2, false); }
+  virtual void visitEqualNode(EqualNode* node) { binary(node, "equals", node->expression_1, node->expression_2, true); }
+  virtual void visitAndNode(AndNode* node) { binary(node, "and", node->expression_1, node->expression_2, true); }
+  virtual void visitOrNode(OrNode* node) { binary(node, "or", node->expression_1, node->expression_2, true); }
+  virtual void visitNotNode(NotNode* node) { unary(node, "not", node->expression); }
+  virtual void visitNegationNode(NegationNode* node) { unary(node, "-", node->expression); }
+
+  // a pure method reads and stores nothing, so memory does not change
+  virtual void visitMethodCallNode(MethodCallNode* node) {
+    std::string target = node->identifier_2 ? node->identifier_1->objectClassName : className;
+    std::string methodName = node->identifier_2 ? node->identifier_2->name : node->identifier_1->name;
+    while (!classTable->at(target).methods->count(methodName)) {
+      target = classTable->at(target).superClassName;
+    }
+    if (!pureMethods || !pureMethods->count(target + "_" + methodName)) {
+      visitArguments(node->expression_list);
+      return;
+    }
+
+    size_t reuseStart = reuses.size();
+    size_t addedStart = added.size();
+    std::string key = "call " + target + "_" + methodName;
+    if (node->expression_list) {
+      for (std::list<ExpressionNode*>::reverse_iterator it = node->expression_list->rbegin(); it != node->expression_list->rend(); it++) {
+        (*it)->accept(this);
+        key = value >= 0 && !key.empty() ? key + " " + std::to_string(value) : "";
+      }
+    }
+    numbered(node, key, true, reuseStart, addedStart);
+  }
+
+  // the members of a frame object are read with a single push
+  virtual void visitMemberAccessNode(MemberAccessNode* node) {
+    std::string name = node->identifier_1->name;
+    numbered(node, load(object(name), node->identifier_2->name), !escapes.objects.count(name), reuses.size(), added.size());
+  }
+
+  // a local is read with a single push
+  virtual void visitVariableNode(VariableNode* node) {
+    std::string name = node->identifier->name;
+    if (method.variables->count(name)) {
+      value = variable(name);
+    } else {
+      numbered(node, load(number("this"), name), true, reuses.size(), added.size());
+    }
+  }
+
+  virtual void visitIntegerLiteralNode(IntegerLiteralNode* node) {
+    value = number("int " + std::to_string(node->integer->value));
+  }
+
+  virtual void visitBooleanLiteralNode(BooleanLiteralNode* node) {
+    value = number("int " + std::to_string(node->integer->value));
+  }
+
+  virtual void visitNewNode(NewNode* node) { visitArguments(node->expression_list); }
+
+  virtual void visitIntegerTypeNode(IntegerTypeNode* node) {}
+  virtual void visitBooleanTypeNode(BooleanTypeNode* node) {}
+  virtual void visitObjectTypeNode(ObjectTypeNode* node) {}
+  virtual void visitNoneNode(NoneNode* node) {}
+  virtual void visitIdentifierNode(IdentifierNode* node) {}
+  virtual void visitIntegerNode(IntegerNode* node) {}
+};
+
+MethodValues numberValues(MethodNode* method, const std::string& className, ClassTable* classTable, const MethodEscapes& escapes, int localsSize, const std::set<std::string>* pureMethods) {
+  MethodInfo info = classTable->at(className).methods->at(method->identifier->name);
+  ValueNumbering analysis(info, escapes, className, classTable, pureMethods);
+  method->accept(&analysis);
+
+  // the values saved in one block are dead in every other block, so
+  // the blocks share the temporaries
+  MethodValues result;
+  std::map<int, int> blockTemporaries;
+  for (size_t i = 0; i < analysis.reuses.size(); i++) {
+    ExpressionNode* source = analysis.reuses[i].second;
+    if (!result.saved.count(source)) {
+      int temporary = blockTemporaries[analysis.blocks[source]]++;
+      result.saved[source] = -(localsSize + 4 * (temporary + 1));
+      result.frameSize = std::max(result.frameSize, 4 * (temporary + 1));
+    }
+    result.reused[analysis.reuses[i].first] = result.saved[source];
+  }
+  return result;
+}
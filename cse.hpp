@@ -0,0 +1,53 @@
+#ifndef __CSE_HPP
+#define __CSE_HPP
+
+#include "ast.hpp"
+#include "typecheck.hpp"
+#include "escape.hpp"
+
+#include <map>
+#include <set>
+#include <string>
+
+// This file defines local value numbering, which finds the expressions
+// of a method whose value was already computed earlier in the same
+// basic block, so the CodeGenerator can reuse that value instead of
+// computing it again (common subexpression elimination), and the
+// members whose value is already known (redundant load removal).
+//
+// Every expression gets a value number: expressions with the same
+// number in a block are known to have the same value. Operators are
+// numbered by their operands' numbers, a local by the number of the
+// value last assigned to it, and a member load by the object's number
+// and the state of memory, which every member store, call and new
+// changes (a store also records the value it stored, so reading it
+// back needs no load). A call of a pure method (see interproc.hpp) is
+// numbered by the method and its arguments' numbers, and changes
+// nothing. A block ends at every branch and label, where all numbers
+// are forgotten.
+//
+// Only values that cost more than a single push to compute are reused,
+// and only integers and booleans (a saved object would have to be in
+// the stack maps).
+
+// Defines the values a method computes once and reuses.
+struct MethodValues {
+  // The frame offset (from %ebp) of the temporary that the value of
+  // every expression that is reused later is saved to
+  std::map<ExpressionNode*, int> saved;
+  // The frame offset of the temporary holding the value of every
+  // expression that is not computed again
+  std::map<ExpressionNode*, int> reused;
+  // The bytes the temporaries add to the method's locals
+  int frameSize;
+
+  MethodValues() : frameSize(0) {}
+};
+
+// Numbers the values of a method of the given class. Its temporaries
+// are put below the first localsSize bytes of its frame. pureMethods
+// holds the Class_method names of the pure methods, or is NULL if
+// they are not known.
+MethodValues numberValues(MethodNode* method, const std::string& className, ClassTable* classTable, const MethodEscapes& escapes, int localsSize, const std::set<std::string>* pureMethods);
+
+#endif
@@ -0,0 +1,329 @@
+#include "deadcode.hpp"
+
+#include <map>
+#include <vector>
+
+// This visitor collects what a method (or an expression) uses: the
+// variables it reads (as values, as receivers of calls, or as objects
+// whose members it reads or writes), the methods it calls (by the
+// static class they are called on) and the classes it creates.
+class UseScan : public Visitor {
+private:
+  std::string className;
+
+public:
+  std::set<std::string> reads;
+  std::vector<std::pair<std::string, std::string> > calls;
+  std::set<std::string> created;
+  // Set if it calls a method, creates an object, or can fail (divides,
+  // or reads a member of an object that may be null)
+  bool effects;
+
+  UseScan(const std::string& className) : className(className), effects(false) {}
+
+  virtual void visitProgramNode(ProgramNode* node) { node->visit_children(this); }
+  virtual void visitClassNode(ClassNode* node) { node->visit_children(this); }
+  virtual void visitMethodNode(MethodNode* node) { node->visit_children(this); }
+  virtual void visitMethodBodyNode(MethodBodyNode* node) { node->visit_children(this); }
+  virtual void visitParameterNode(ParameterNode* node) {}
+  virtual void visitDeclarationNode(DeclarationNode* node) {}
+  virtual void visitReturnStatementNode(ReturnStatementNode* node) { node->visit_children(this); }
+
+  virtual void visitAssignmentNode(AssignmentNode* node) {
+    if (node->identifier_2) {
+      reads.insert(node->identifier_1->name);
+    }
+    node->expression->accept(this);
+  }
+
+  virtual void visitCallNode(CallNode* node) { node->visit_children(this); }
+  virtual void visitIfElseNode(IfElseNode* node) { node->visit_children(this); }
+  virtual void visitWhileNode(WhileNode* node) { node->visit_children(this); }
+  virtual void visitPrintNode(PrintNode* node) { node->visit_children(this); }
+  virtual void visitDoWhileNode(DoWhileNode* node) { node->visit_children(this); }
+  virtual void visitPlusNode(PlusNode* node) { node->visit_children(this); }
+  virtual void visitMinusNode(MinusNode* node) { node->visit_children(this); }
+  virtual void visitTimesNode(TimesNode* node) { node->visit_children(this); }
+  virtual void visitDivideNode(DivideNode* node) {
+    effects = true;
+    node->visit_children(this);
+  }
+  virtual void visitGreaterNode(GreaterNode* node) { node->visit_children(this); }
+  virtual void visitGreaterEqualNode(GreaterEqualNode* node) { node->visit_children(this); }
+  virtual void visitEqualNode(EqualNode* node) { node->visit_children(this); }
+  virtual void visitAndNode(AndNode* node) { node->visit_children(this); }
+  virtual void visitOrNode(OrNode* node) { node->visit_children(this); }
+  virtual void visitNotNode(NotNode* node) { node->visit_children(this); }
+  virtual void visitNegationNode(NegationNode* node) { node->visit_children(this); }
+
+  virtual void visitMethodCallNode(MethodCallNode* node) {
+    effects = true;
+    if (node->identifier_2) {
+      reads.insert(node->identifier_1->name);
+      calls.push_back(std::make_pair(node->identifier_1->objectClassName, node->identifier_2->name));
+    } else {
+      calls.push_back(std::make_pair(className, node->identifier_1->name));
+    }
+    node->visit_children(this);
+  }
+
+  virtual void visitMemberAccessNode(MemberAccessNode* node) {
+    effects = true;
+    reads.insert(node->identifier_1->name);
+  }
+
+  virtual void visitVariableNode(VariableNode* node) {
+    reads.insert(node->identifier->name);
+  }
+
+  virtual void visitIntegerLiteralNode(IntegerLiteralNode* node) {}
+  virtual void visitBooleanLiteralNode(BooleanLiteralNode* node) {}
+
+  virtual void visitNewNode(NewNode* node) {
+    effects = true;
+    created.insert(node->identifier->name);
+    node->visit_children(this);
+  }
+
+  virtual void visitIntegerTypeNode(IntegerTypeNode* node) {}
+  virtual void visitBooleanTypeNode(BooleanTypeNode* node) {}
+  virtual void visitObjectTypeNode(ObjectTypeNode* node) {}
+  virtual void visitNoneNode(NoneNode* node) {}
+  virtual void visitIdentifierNode(IdentifierNode* node) {}
+  virtual void visitIntegerNode(IntegerNode* node) {}
+};
+
+template<typename T>
+static bool constantOperands(ExpressionNode* node, int& left, int& right) {
+  T* op = dynamic_cast<T*>(node);
+  return op && constantValue(op->expression_1, left) && constantValue(op->expression_2, right);
+}
+
+// Computes the value of an expression made only of literals, as the
+// generated code would (arithmetic wraps around). Division by zero is
+// left for the program to fail at.
+bool constantValue(ExpressionNode* node, int& value) {
+  int left, right;
+  if (IntegerLiteralNode* literal = dynamic_cast<IntegerLiteralNode*>(node)) {
+    value = literal->integer->value;
+  } else if (BooleanLiteralNode* literal = dynamic_cast<BooleanLiteralNode*>(node)) {
+    value = literal->integer->value;
+  } else if (NotNode* op = dynamic_cast<NotNode*>(node)) {
+    if (!constantValue(op->expression, value)) {
+      return false;
+    }
+    value ^= 1;
+  } else if (NegationNode* op = dynamic_cast<NegationNode*>(node)) {
+    if (!constantValue(op->expression, value)) {
+      return false;
+    }
+    value = (int)(0u - (unsigned)value);
+  } else if (constantOperands<PlusNode>(node, left, right)) {
+    value = (int)((unsigned)left + (unsigned)right);
+  } else if (constantOperands<MinusNode>(node, left, right)) {
+    value = (int)((unsigned)left - (unsigned)right);
+  } else if (constantOperands<TimesNode>(node, left, right)) {
+    value = (int)((unsigned)left * (unsigned)right);
+  } else if (constantOperands<DivideNode>(node, left, right)) {
+    if (right == 0 || (right == -1 && left == (int)0x80000000)) {
+      return false;
+    }
+    value = left / right;
+  } else if (constantOperands<GreaterNode>(node, left, right)) {
+    value = left > right;
+  } else if (constantOperands<GreaterEqualNode>(node, left, right)) {
+    value = left >= right;
+  } else if (constantOperands<EqualNode>(node, left, right)) {
+    value = left == right;
+  } else if (constantOperands<AndNode>(node, left, right)) {
+    value = left & right;
+  } else if (constantOperands<OrNode>(node, left, right)) {
+    value = left | right;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Counts the statements of a block, including nested blocks.
+static int statementCount(std::list<StatementNode*>* statements) {
+  int count = 0;
+  if (statements) {
+    for (std::list<StatementNode*>::iterator it = statements->begin(); it != statements->end(); it++) {
+      count++;
+      if (IfElseNode* ifElse = dynamic_cast<IfElseNode*>(*it)) {
+        count += statementCount(ifElse->statement_list_1) + statementCount(ifElse->statement_list_2);
+      } else if (WhileNode* loop = dynamic_cast<WhileNode*>(*it)) {
+        count += statementCount(loop->statement_list);
+      } else if (DoWhileNode* loop = dynamic_cast<DoWhileNode*>(*it)) {
+        count += statementCount(loop->statement_list);
+      }
+    }
+  }
+  return count;
+}
+
+// Removes the constant branches of a block and its stores to the
+// locals in dead, and returns true if it removed anything. The
+// statements of an arm that replaces its if are spliced into the
+// block, and only looked at by the next pass.
+static bool removeDeadStatements(std::list<StatementNode*>* statements, const std::set<std::string>& dead, DeadCodeStats& stats) {
+  if (!statements) {
+    return false;
+  }
+  bool changed = false;
+  for (std::list<StatementNode*>::iterator it = statements->begin(); it != statements->end();) {
+    StatementNode* statement = *it;
+    // the statement is removed, and replaced by these if they are set
+    bool remove = false;
+    std::list<StatementNode*>* replacement = NULL;
+    int value;
+
+    if (AssignmentNode* assignment = dynamic_cast<AssignmentNode*>(statement)) {
+      UseScan scan("");
+      assignment->expression->accept(&scan);
+      if (!assignment->identifier_2 && dead.count(assignment->identifier_1->name) && !scan.effects) {
+        remove = true;
+        stats.stores++;
+      }
+    } else if (IfElseNode* ifElse = dynamic_cast<IfElseNode*>(statement)) {
+      if (constantValue(ifElse->expression, value)) {
+        remove = true;
+        replacement = value ? ifElse->statement_list_1 : ifElse->statement_list_2;
+        stats.branches++;
+        stats.branchStatements += statementCount(value ? ifElse->statement_list_2 : ifElse->statement_list_1);
+      } else {
+        changed |= removeDeadStatements(ifElse->statement_list_1, dead, stats);
+        changed |= removeDeadStatements(ifElse->statement_list_2, dead, stats);
+      }
+    } else if (WhileNode* loop = dynamic_cast<WhileNode*>(statement)) {
+      if (constantValue(loop->expression, value) && !value) {
+        remove = true;
+        stats.branches++;
+        stats.branchStatements += statementCount(loop->statement_list);
+      } else {
+        changed |= removeDeadStatements(loop->statement_list, dead, stats);
+      }
+    } else if (DoWhileNode* loop = dynamic_cast<DoWhileNode*>(statement)) {
+      if (constantValue(loop->expression, value) && !value) {
+        remove = true;
+        replacement = loop->statement_list;
+        stats.branches++;
+      } else {
+        changed |= removeDeadStatements(loop->statement_list, dead, stats);
+      }
+    }
+
+    if (!remove) {
+      it++;
+      continue;
+    }
+    if (replacement) {
+      statements->splice(it, *replacement);
+    }
+    it = statements->erase(it);
+    delete statement;
+    changed = true;
+  }
+  return changed;
+}
+
+void eliminateDeadCode(MethodNode* method, const std::string& className, ClassTable* classTable, DeadCodeStats* stats) {
+  DeadCodeStats ignored;
+  MethodInfo info = classTable->at(className).methods->at(method->identifier->name);
+
+  // a removed store may have been the only read of another local
+  bool changed = true;
+  while (changed) {
+    UseScan scan(className);
+    method->accept(&scan);
+    std::set<std::string> dead;
+    for (VariableTable::iterator it = info.variables->begin(); it != info.variables->end(); it++) {
+      if (!scan.reads.count(it->first)) {
+        dead.insert(it->first);
+      }
+    }
+    changed = removeDeadStatements(method->methodbody->statement_list, dead, stats ? *stats : ignored);
+  }
+}
+
+void eliminateDeadCode(ProgramNode* program, ClassTable* classTable, std::set<std::string>& reachable, DeadCodeStats* stats) {
+  // every method by Class_method name, with its class
+  std::map<std::string, std::pair<std::string, MethodNode*> > methods;
+  for (std::list<ClassNode*>::iterator c = program->class_list->begin(); c != program->class_list->end(); c++) {
+    std::string className = (*c)->identifier_1->name;
+    if (!(*c)->method_list) {
+      continue;
+    }
+    for (std::list<MethodNode*>::iterator m = (*c)->method_list->begin(); m != (*c)->method_list->end(); m++) {
+      eliminateDeadCode(*m, className, classTable, stats);
+      methods[className + "_" + (*m)->identifier->name] = std::make_pair(className, *m);
+    }
+  }
+
+  std::vector<std::string> work;
+  work.push_back("Main_main");
+  reachable.insert("Main_main");
+  while (!work.empty()) {
+    std::map<std::string, std::pair<std::string, MethodNode*> >::iterator method = methods.find(work.back());
+    work.pop_back();
+    if (method == methods.end()) {
+      continue;
+    }
+    UseScan scan(method->second.first);
+    method->second.second->accept(&scan);
+
+    std::vector<std::string> callees;
+    for (size_t i = 0; i < scan.calls.size(); i++) {
+      std::string staticClass = scan.calls[i].first;
+      std::string methodName = scan.calls[i].second;
+      // the method the static class defines or inherits, and every
+      // override of it in a subclass
+      std::string name = staticClass;
+      while (name != "" && !classTable->at(name).methods->count(methodName)) {
+        name = classTable->at(name).superClassName;
+      }
+      if (name != "") {
+        callees.push_back(name + "_" + methodName);
+      }
+      for (ClassTable::iterator c = classTable->begin(); c != classTable->end(); c++) {
+        if (!c->second.methods->count(methodName)) {
+          continue;
+        }
+        for (name = c->second.superClassName; name != ""; name = classTable->at(name).superClassName) {
+          if (name == staticClass) {
+            callees.push_back(c->first + "_" + methodName);
+            break;
+          }
+        }
+      }
+    }
+    for (std::set<std::string>::iterator it = scan.created.begin(); it != scan.created.end(); it++) {
+      if (classTable->at(*it).methods->count(*it)) {
+        callees.push_back(*it + "_" + *it);
+      }
+    }
+
+    for (size_t i = 0; i < callees.size(); i++) {
+      if (reachable.insert(callees[i]).second) {
+        work.push_back(callees[i]);
+      }
+    }
+  }
+
+  if (stats) {
+    stats->totalMethods += methods.size();
+    for (std::map<std::string, std::pair<std::string, MethodNode*> >::iterator it = methods.begin(); it != methods.end(); it++) {
+      if (!reachable.count(it->first)) {
+        stats->methods++;
+        stats->methodStatements += statementCount(it->second.second->methodbody->statement_list);
+      }
+    }
+  }
+}
+
+void printDeadCode(const DeadCodeStats& stats, std::ostream& out) {
+  out << "dead code: " << stats.stores << " dead stores, " << stats.branches << " constant branches ("
+      << stats.branchStatements << " statements), " << stats.methods << " of " << stats.totalMethods
+      << " methods unreachable (" << stats.methodStatements << " statements)" << std::endl;
+}
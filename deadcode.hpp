@@ -0,0 +1,62 @@
+#ifndef __DEADCODE_HPP
+#define __DEADCODE_HPP
+
+#include "ast.hpp"
+#include "typecheck.hpp"
+
+#include <ostream>
+#include <set>
+#include <string>
+
+// This file defines dead code elimination, which removes from the AST
+// the code whose removal cannot change what the program does:
+//
+//  - dead stores: assignments to a local that the method never reads
+//    (when computing the value has no effects, that is, it neither
+//    calls a method nor creates an object, and cannot fail: it
+//    neither divides nor reads a member of an object that may be
+//    null),
+//  - constant branches: an if whose condition is made of literals is
+//    replaced by the arm that runs, a while loop whose condition is
+//    false is removed, and a do while loop whose condition is false is
+//    replaced by its body,
+//  - unreachable methods: methods that no chain of calls from
+//    Main.main can run. Calls are followed into every override a
+//    subclass defines, and new into the constructor.
+//
+// The CodeGenerator runs it before generating code, so every analysis
+// after it sees the smaller AST. Removing the dead code of a method is
+// idempotent; unreachable methods are only known for a whole program.
+
+// Defines how much dead code was removed.
+struct DeadCodeStats {
+  int stores;
+  // The constant branches, and the statements (including nested ones)
+  // in the arms and loops that were removed with them
+  int branches;
+  int branchStatements;
+  // The unreachable methods out of all methods, and their statements
+  int methods;
+  int totalMethods;
+  int methodStatements;
+
+  DeadCodeStats() : stores(0), branches(0), branchStatements(0), methods(0), totalMethods(0), methodStatements(0) {}
+};
+
+// Removes the dead stores and constant branches of a method of the
+// given class, adding them to stats unless it is NULL.
+void eliminateDeadCode(MethodNode* method, const std::string& className, ClassTable* classTable, DeadCodeStats* stats);
+
+// Removes the dead stores and constant branches of every method of a
+// program, and adds the Class_method names of the methods Main.main
+// can reach to reachable.
+void eliminateDeadCode(ProgramNode* program, ClassTable* classTable, std::set<std::string>& reachable, DeadCodeStats* stats);
+
+// Sets value to the value of an expression made only of literals and
+// returns true, or returns false.
+bool constantValue(ExpressionNode* node, int& value);
+
+// Prints how much dead code was removed (for --dce-report).
+void printDeadCode(const DeadCodeStats& stats, std::ostream& out);
+
+#endif
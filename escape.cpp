@@ -0,0 +1,251 @@
+#include "escape.hpp"
+
+#include <vector>
+
+// Defines how a method uses one of its object variables.
+struct VariableUse {
+  // Used as a value (other than as an argument)
+  bool escapes;
+  // The receiver of a call or an argument
+  bool addressTaken;
+  // Assigned something other than a new object
+  bool assignedOther;
+  // Assigned new objects of more than one class
+  bool mixedClasses;
+  // The class of the new objects assigned to it
+  std::string newClass;
+  // The "Class_method:index" parameters it is passed to
+  std::vector<std::string> passedTo;
+
+  VariableUse() : escapes(false), addressTaken(false), assignedOther(false), mixedClasses(false) {}
+};
+
+// This visitor records how a method body uses the object variables
+// of the method (its parameters and locals).
+class EscapeAnalysis : public Visitor {
+private:
+  ClassTable* classTable;
+  std::string className;
+
+  bool tracked(const std::string& name) {
+    return uses.count(name) > 0;
+  }
+
+  // Returns the Class_method name of the method a call runs.
+  std::string callee(std::string calleeClass, const std::string& methodName) {
+    while (!classTable->at(calleeClass).methods->count(methodName)) {
+      calleeClass = classTable->at(calleeClass).superClassName;
+    }
+    return calleeClass + "_" + methodName;
+  }
+
+  void visitArguments(const std::string& calleeName, std::list<ExpressionNode*>* arguments) {
+    if (!arguments) {
+      return;
+    }
+    int index = 0;
+    for (std::list<ExpressionNode*>::iterator it = arguments->begin(); it != arguments->end(); it++, index++) {
+      VariableNode* variable = dynamic_cast<VariableNode*>(*it);
+      if (variable && tracked(variable->identifier->name)) {
+        VariableUse& use = uses[variable->identifier->name];
+        use.passedTo.push_back(calleeName + ":" + std::to_string(index));
+        use.addressTaken = true;
+      } else {
+        (*it)->accept(this);
+      }
+    }
+  }
+
+public:
+  std::map<std::string, VariableUse> uses;
+
+  EscapeAnalysis(ClassTable* classTable, const std::string& className, const MethodInfo& method)
+      : classTable(classTable), className(className) {
+    for (VariableTable::iterator it = method.variables->begin(); it != method.variables->end(); it++) {
+      if (it->second.type.baseType == bt_object) {
+        uses[it->first];
+      }
+    }
+  }
+
+  virtual void visitProgramNode(ProgramNode* node) { node->visit_children(this); }
+  virtual void visitClassNode(ClassNode* node) { node->visit_children(this); }
+  virtual void visitMethodNode(MethodNode* node) { node->visit_children(this); }
+  virtual void visitMethodBodyNode(MethodBodyNode* node) { node->visit_children(this); }
+  virtual void visitParameterNode(ParameterNode* node) {}
+  virtual void visitDeclarationNode(DeclarationNode* node) {}
+  virtual void visitReturnStatementNode(ReturnStatementNode* node) { node->visit_children(this); }
+
+  virtual void visitAssignmentNode(AssignmentNode* node) {
+    std::string name = node->identifier_1->name;
+    if (!node->identifier_2 && tracked(name)) {
+      VariableUse& use = uses[name];
+      NewNode* newNode = dynamic_cast<NewNode*>(node->expression);
+      if (!newNode) {
+        use.assignedOther = true;
+      } else if (use.newClass.empty()) {
+        use.newClass = newNode->identifier->name;
+      } else if (use.newClass != newNode->identifier->name) {
+        use.mixedClasses = true;
+      }
+    }
+    node->expression->accept(this);
+  }
+
+  virtual void visitCallNode(CallNode* node) { node->visit_children(this); }
+  virtual void visitIfElseNode(IfElseNode* node) { node->visit_children(this); }
+  virtual void visitWhileNode(WhileNode* node) { node->visit_children(this); }
+  virtual void visitPrintNode(PrintNode* node) { node->visit_children(this); }
+  virtual void visitDoWhileNode(DoWhileNode* node) { node->visit_children(this); }
+  virtual void visitPlusNode(PlusNode* node) { node->visit_children(this); }
+  virtual void visitMinusNode(MinusNode* node) { node->visit_children(this); }
+  virtual void visitTimesNode(TimesNode* node) { node->visit_children(this); }
+  virtual void visitDivideNode(DivideNode* node) { node->visit_children(this); }
+  virtual void visitGreaterNode(GreaterNode* node) { node->visit_children(this); }
+  virtual void visitGreaterEqualNode(GreaterEqualNode* node) { node->visit_children(this); }
+  virtual void visitEqualNode(EqualNode* node) { node->visit_children(this); }
+  virtual void visitAndNode(AndNode* node) { node->visit_children(this); }
+  virtual void visitOrNode(OrNode* node) { node->visit_children(this); }
+  virtual void visitNotNode(NotNode* node) { node->visit_children(this); }
+  virtual void visitNegationNode(NegationNode* node) { node->visit_children(this); }
+
+  virtual void visitMethodCallNode(MethodCallNode* node) {
+    std::string calleeName;
+    if (node->identifier_2) {
+      if (tracked(node->identifier_1->name)) {
+        uses[node->identifier_1->name].addressTaken = true;
+      }
+      calleeName = callee(node->identifier_1->objectClassName, node->identifier_2->name);
+    } else {
+      calleeName = callee(className, node->identifier_1->name);
+    }
+    visitArguments(calleeName, node->expression_list);
+  }
+
+  virtual void visitMemberAccessNode(MemberAccessNode* node) {}
+
+  virtual void visitVariableNode(VariableNode* node) {
+    if (tracked(node->identifier->name)) {
+      uses[node->identifier->name].escapes = true;
+    }
+  }
+
+  virtual void visitIntegerLiteralNode(IntegerLiteralNode* node) {}
+  virtual void visitBooleanLiteralNode(BooleanLiteralNode* node) {}
+
+  virtual void visitNewNode(NewNode* node) {
+    std::string newClass = node->identifier->name;
+    if (classTable->at(newClass).methods->count(newClass)) {
+      visitArguments(newClass + "_" + newClass, node->expression_list);
+    } else {
+      visitArguments("", node->expression_list);
+    }
+  }
+
+  virtual void visitIntegerTypeNode(IntegerTypeNode* node) {}
+  virtual void visitBooleanTypeNode(BooleanTypeNode* node) {}
+  virtual void visitObjectTypeNode(ObjectTypeNode* node) {}
+  virtual void visitNoneNode(NoneNode* node) {}
+  virtual void visitIdentifierNode(IdentifierNode* node) {}
+  virtual void visitIntegerNode(IntegerNode* node) {}
+};
+
+static bool escapes(const VariableUse& use, const std::set<std::string>* parameters) {
+  if (use.escapes) {
+    return true;
+  }
+  for (size_t i = 0; i < use.passedTo.size(); i++) {
+    if (!parameters || !parameters->count(use.passedTo[i])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void findNonEscapingParameters(ProgramNode* program, ClassTable* classTable, std::set<std::string>& parameters) {
+  // the uses of every object parameter, by "Class_method:index"
+  std::map<std::string, VariableUse> uses;
+  for (std::list<ClassNode*>::iterator c = program->class_list->begin(); c != program->class_list->end(); c++) {
+    std::string className = (*c)->identifier_1->name;
+    if (!(*c)->method_list) {
+      continue;
+    }
+    for (std::list<MethodNode*>::iterator m = (*c)->method_list->begin(); m != (*c)->method_list->end(); m++) {
+      std::string methodName = (*m)->identifier->name;
+      EscapeAnalysis analysis(classTable, className, classTable->at(className).methods->at(methodName));
+      (*m)->accept(&analysis);
+      if (!(*m)->parameter_list) {
+        continue;
+      }
+
+      int index = 0;
+      for (std::list<ParameterNode*>::iterator p = (*m)->parameter_list->begin(); p != (*m)->parameter_list->end(); p++, index++) {
+        std::string name = (*p)->identifier->name;
+        if (analysis.uses.count(name)) {
+          std::string key = className + "_" + methodName + ":" + std::to_string(index);
+          uses[key] = analysis.uses[name];
+          parameters.insert(key);
+        }
+      }
+    }
+  }
+
+  // a call may run an override of the method in a subclass, so a
+  // parameter also escapes if it escapes in any override
+  for (ClassTable::iterator c = classTable->begin(); c != classTable->end(); c++) {
+    for (MethodTable::iterator m = c->second.methods->begin(); m != c->second.methods->end(); m++) {
+      for (std::string name = c->second.superClassName; name != ""; name = classTable->at(name).superClassName) {
+        MethodTable* methods = classTable->at(name).methods;
+        if (!methods->count(m->first)) {
+          continue;
+        }
+        for (size_t index = 0; index < methods->at(m->first).parameters->size(); index++) {
+          std::string key = name + "_" + m->first + ":" + std::to_string(index);
+          if (uses.count(key)) {
+            uses[key].passedTo.push_back(c->first + "_" + m->first + ":" + std::to_string(index));
+          }
+        }
+      }
+    }
+  }
+
+  // Every parameter starts out not escaping; a parameter passed to
+  // one that escapes escapes too, until nothing changes.
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (std::map<std::string, VariableUse>::iterator it = uses.begin(); it != uses.end(); it++) {
+      if (parameters.count(it->first) && escapes(it->second, &parameters)) {
+        parameters.erase(it->first);
+        changed = true;
+      }
+    }
+  }
+}
+
+MethodEscapes findStackObjects(MethodNode* method, const std::string& className, ClassTable* classTable, const std::set<std::string>* parameters) {
+  MethodInfo info = classTable->at(className).methods->at(method->identifier->name);
+  EscapeAnalysis analysis(classTable, className, info);
+  method->accept(&analysis);
+
+  MethodEscapes result;
+  for (std::map<std::string, VariableUse>::iterator it = analysis.uses.begin(); it != analysis.uses.end(); it++) {
+    const VariableUse& use = it->second;
+    if (info.variables->at(it->first).offset > 0 || use.newClass.empty() || use.assignedOther
+        || use.mixedClasses || escapes(use, parameters)) {
+      continue;
+    }
+
+    // a frame object has a header word like a heap object (see
+    // tester.c), which points to the vtable if calls need it
+    ClassInfo& objectClass = classTable->at(use.newClass);
+    result.frameSize += objectClass.membersSize + 4;
+
+    StackObject object;
+    object.className = use.newClass;
+    object.offset = -(info.localsSize + result.frameSize) + 4;
+    object.scalar = !use.addressTaken && !objectClass.methods->count(use.newClass);
+    result.objects[it->first] = object;
+  }
+  return result;
+}
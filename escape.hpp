@@ -0,0 +1,61 @@
+#ifndef __ESCAPE_HPP
+#define __ESCAPE_HPP
+
+#include "ast.hpp"
+#include "typecheck.hpp"
+
+#include <map>
+#include <set>
+#include <string>
+
+// This file defines the escape analysis, which finds the objects
+// created with new that never outlive the method creating them, so
+// the CodeGenerator can allocate them in the method's frame instead
+// of the heap.
+//
+// A local variable's object escapes if the variable is used as a
+// value: assigned to another variable or a member, returned, or passed
+// to a parameter that escapes. Calling a method on it or reading and
+// writing its members does not make it escape (the language has no
+// `this`, so a method can never leak the object it is called on). A
+// parameter escapes by the same rules, in the method it belongs to.
+//
+// A local gets a frame object if it does not escape and is only ever
+// assigned new objects of a single class. Each new reuses the same
+// frame object: the previous one can only have been reached through
+// the variable.
+
+// Defines an object allocated in a method's frame.
+struct StackObject {
+  // The class of the object
+  std::string className;
+  // The frame offset (from %ebp) of the object's first member (its
+  // header word is right below)
+  int offset;
+  // Set if the object's address is never needed (it is never the
+  // receiver of a call or an argument, and its class has no
+  // constructor). Its members are then just locals of the method,
+  // and the variable holding it is never written.
+  bool scalar;
+};
+
+// Defines the frame objects of a method.
+struct MethodEscapes {
+  // The frame object of every variable that has one
+  std::map<std::string, StackObject> objects;
+  // The bytes they add to the method's locals
+  int frameSize;
+
+  MethodEscapes() : frameSize(0) {}
+};
+
+// Finds the object parameters of all methods of a program that do
+// not escape. They are added to parameters as "Class_method:index".
+void findNonEscapingParameters(ProgramNode* program, ClassTable* classTable, std::set<std::string>& parameters);
+
+// Finds the frame objects of a method of the given class. Without
+// the parameters found by findNonEscapingParameters, every object
+// passed as an argument escapes.
+MethodEscapes findStackObjects(MethodNode* method, const std::string& className, ClassTable* classTable, const std::set<std::string>* parameters);
+
+#endif
@@ -0,0 +1,374 @@
+#include "evaluate.hpp"
+
+#include <climits>
+#include <map>
+#include <vector>
+
+// Thrown when evaluation gives up
+struct EvaluationStopped {};
+
+// An object: its class, and its members by offset (see
+// TypeCheck::collectClass). Objects are numbered from 1, and 0 is
+// null.
+struct EvaluatedObject {
+  std::string className;
+  std::vector<int> members;
+};
+
+// A variable of the method being run, and whether it has a value
+// (parameters and objects always have one)
+struct EvaluatedVariable {
+  int value;
+  bool assigned;
+};
+
+// This visitor runs a program. Every expression leaves its value in
+// value; integers and booleans are the values the generated code
+// computes, and objects are their numbers.
+class Interpreter : public Visitor {
+private:
+  ClassTable* classTable;
+  EvaluationBudget budget;
+  std::map<std::string, MethodNode*> methods;
+  std::vector<EvaluatedObject> objects;
+  int depth;
+
+  // The class of the method being run, its `this` and its variables
+  std::string className;
+  int self;
+  std::map<std::string, EvaluatedVariable> variables;
+
+  int value;
+
+  void step() {
+    if (--budget.steps < 0) {
+      throw EvaluationStopped();
+    }
+  }
+
+  void allocate(long long bytes) {
+    budget.memory -= bytes;
+    if (budget.memory < 0) {
+      throw EvaluationStopped();
+    }
+  }
+
+  int evaluate(ExpressionNode* node) {
+    node->accept(this);
+    return value;
+  }
+
+  void run(std::list<StatementNode*>* statements) {
+    if (statements) {
+      for (std::list<StatementNode*>::iterator it = statements->begin(); it != statements->end(); it++) {
+        (*it)->accept(this);
+      }
+    }
+  }
+
+  // Returns a member of an object, whose static class is given
+  int& member(int object, const std::string& objectClassName, const std::string& name) {
+    if (!object) {
+      throw EvaluationStopped();
+    }
+    return objects[object - 1].members[classTable->at(objectClassName).members->at(name).offset];
+  }
+
+  // Returns the object held by a variable or a member of `this`
+  int objectNamed(const std::string& name) {
+    std::map<std::string, EvaluatedVariable>::iterator it = variables.find(name);
+    return it != variables.end() ? it->second.value : member(self, className, name);
+  }
+
+  // Evaluates the arguments of a call, from last to first as the
+  // generated code pushes them
+  std::vector<int> arguments(std::list<ExpressionNode*>* expressions) {
+    std::vector<int> values(expressions ? expressions->size() : 0);
+    if (expressions) {
+      int i = values.size();
+      for (std::list<ExpressionNode*>::reverse_iterator it = expressions->rbegin(); it != expressions->rend(); it++) {
+        values[--i] = evaluate(*it);
+      }
+    }
+    return values;
+  }
+
+  template<typename T>
+  void operands(T* node, int& left, int& right) {
+    step();
+    left = evaluate(node->expression_1);
+    right = evaluate(node->expression_2);
+  }
+
+public:
+  std::string output;
+
+  Interpreter(ProgramNode* program, ClassTable* classTable, const EvaluationBudget& budget)
+      : classTable(classTable), budget(budget), depth(0), self(0), value(0) {
+    for (std::list<ClassNode*>::iterator c = program->class_list->begin(); c != program->class_list->end(); c++) {
+      if ((*c)->method_list) {
+        for (std::list<MethodNode*>::iterator m = (*c)->method_list->begin(); m != (*c)->method_list->end(); m++) {
+          methods[(*c)->identifier_1->name + "_" + (*m)->identifier->name] = *m;
+        }
+      }
+    }
+  }
+
+  // Runs a method on an object (or on null) of the given static
+  // class, which dispatches on its class.
+  int call(const std::string& staticClassName, const std::string& methodName, int object, const std::vector<int>& values) {
+    if (++depth > maxEvaluationDepth) {
+      throw EvaluationStopped();
+    }
+    std::string calleeClassName = object ? objects[object - 1].className : staticClassName;
+    while (!classTable->at(calleeClassName).methods->count(methodName)) {
+      calleeClassName = classTable->at(calleeClassName).superClassName;
+    }
+    MethodNode* method = methods.at(calleeClassName + "_" + methodName);
+
+    std::string callerClassName = className;
+    int callerSelf = self;
+    std::map<std::string, EvaluatedVariable> callerVariables;
+    callerVariables.swap(variables);
+    className = calleeClassName;
+    self = object;
+
+    VariableTable* table = classTable->at(className).methods->at(methodName).variables;
+    for (VariableTable::iterator it = table->begin(); it != table->end(); it++) {
+      EvaluatedVariable variable = {0, it->second.type.baseType == bt_object};
+      variables[it->first] = variable;
+    }
+    if (method->parameter_list) {
+      // the arguments of new are not checked, and a missing one is
+      // whatever the stack held
+      if (values.size() < method->parameter_list->size()) {
+        throw EvaluationStopped();
+      }
+      size_t i = 0;
+      for (std::list<ParameterNode*>::iterator it = method->parameter_list->begin(); it != method->parameter_list->end(); it++) {
+        EvaluatedVariable variable = {values[i++], true};
+        variables[(*it)->identifier->name] = variable;
+      }
+    }
+
+    run(method->methodbody->statement_list);
+    int result = 0;
+    if (method->methodbody->returnstatement) {
+      result = evaluate(method->methodbody->returnstatement->expression);
+    } else if (methodName == className) {
+      // a constructor returns its object
+      result = self;
+    }
+
+    variables.swap(callerVariables);
+    className = callerClassName;
+    self = callerSelf;
+    depth--;
+    return result;
+  }
+
+  // Creates an object whose members are all zero (or null).
+  int create(const std::string& objectClassName) {
+    int size = classTable->at(objectClassName).membersSize;
+    allocate(size + 4);
+    EvaluatedObject object;
+    object.className = objectClassName;
+    object.members.resize(size);
+    objects.push_back(object);
+    return objects.size();
+  }
+
+  virtual void visitProgramNode(ProgramNode* node) {}
+  virtual void visitClassNode(ClassNode* node) {}
+  virtual void visitMethodNode(MethodNode* node) {}
+  virtual void visitMethodBodyNode(MethodBodyNode* node) {}
+  virtual void visitParameterNode(ParameterNode* node) {}
+  virtual void visitDeclarationNode(DeclarationNode* node) {}
+  virtual void visitReturnStatementNode(ReturnStatementNode* node) {}
+
+  virtual void visitAssignmentNode(AssignmentNode* node) {
+    step();
+    int result = evaluate(node->expression);
+    if (node->identifier_2) {
+      member(objectNamed(node->identifier_1->name), node->identifier_1->objectClassName, node->identifier_2->name) = result;
+      return;
+    }
+    std::map<std::string, EvaluatedVariable>::iterator it = variables.find(node->identifier_1->name);
+    if (it != variables.end()) {
+      it->second.value = result;
+      it->second.assigned = true;
+    } else {
+      member(self, className, node->identifier_1->name) = result;
+    }
+  }
+
+  virtual void visitCallNode(CallNode* node) {
+    step();
+    node->methodcall->accept(this);
+  }
+
+  virtual void visitIfElseNode(IfElseNode* node) {
+    step();
+    run(evaluate(node->expression) ? node->statement_list_1 : node->statement_list_2);
+  }
+
+  virtual void visitWhileNode(WhileNode* node) {
+    step();
+    while (evaluate(node->expression)) {
+      run(node->statement_list);
+    }
+  }
+
+  virtual void visitDoWhileNode(DoWhileNode* node) {
+    step();
+    do {
+      run(node->statement_list);
+    } while (evaluate(node->expression));
+  }
+
+  virtual void visitPrintNode(PrintNode* node) {
+    step();
+    if (node->expression->basetype == bt_object || node->expression->basetype == bt_none) {
+      throw EvaluationStopped();
+    }
+    std::string line = std::to_string(evaluate(node->expression)) + "\n";
+    allocate(line.size());
+    output += line;
+  }
+
+  virtual void visitPlusNode(PlusNode* node) {
+    int left, right;
+    operands(node, left, right);
+    value = (int)((unsigned)left + (unsigned)right);
+  }
+
+  virtual void visitMinusNode(MinusNode* node) {
+    int left, right;
+    operands(node, left, right);
+    value = (int)((unsigned)left - (unsigned)right);
+  }
+
+  virtual void visitTimesNode(TimesNode* node) {
+    int left, right;
+    operands(node, left, right);
+    value = (int)((unsigned)left * (unsigned)right);
+  }
+
+  virtual void visitDivideNode(DivideNode* node) {
+    int left, right;
+    operands(node, left, right);
+    // idiv traps on both
+    if (right == 0 || (left == INT_MIN && right == -1)) {
+      throw EvaluationStopped();
+    }
+    value = left / right;
+  }
+
+  virtual void visitGreaterNode(GreaterNode* node) {
+    int left, right;
+    operands(node, left, right);
+    value = left > right;
+  }
+
+  virtual void visitGreaterEqualNode(GreaterEqualNode* node) {
+    int left, right;
+    operands(node, left, right);
+    value = left >= right;
+  }
+
+  virtual void visitEqualNode(EqualNode* node) {
+    int left, right;
+    operands(node, left, right);
+    value = left == right;
+  }
+
+  // both operands are evaluated, as in the generated code
+  virtual void visitAndNode(AndNode* node) {
+    int left, right;
+    operands(node, left, right);
+    value = left & right;
+  }
+
+  virtual void visitOrNode(OrNode* node) {
+    int left, right;
+    operands(node, left, right);
+    value = left | right;
+  }
+
+  virtual void visitNotNode(NotNode* node) {
+    step();
+    value = evaluate(node->expression) ^ 1;
+  }
+
+  virtual void visitNegationNode(NegationNode* node) {
+    step();
+    value = (int)(0u - (unsigned)evaluate(node->expression));
+  }
+
+  virtual void visitMethodCallNode(MethodCallNode* node) {
+    step();
+    std::vector<int> values = arguments(node->expression_list);
+    if (node->identifier_2) {
+      value = call(node->identifier_1->objectClassName, node->identifier_2->name, objectNamed(node->identifier_1->name), values);
+    } else {
+      value = call(className, node->identifier_1->name, self, values);
+    }
+  }
+
+  virtual void visitMemberAccessNode(MemberAccessNode* node) {
+    step();
+    value = member(objectNamed(node->identifier_1->name), node->identifier_1->objectClassName, node->identifier_2->name);
+  }
+
+  virtual void visitVariableNode(VariableNode* node) {
+    step();
+    std::map<std::string, EvaluatedVariable>::iterator it = variables.find(node->identifier->name);
+    if (it == variables.end()) {
+      value = member(self, className, node->identifier->name);
+    } else if (!it->second.assigned) {
+      throw EvaluationStopped();
+    } else {
+      value = it->second.value;
+    }
+  }
+
+  virtual void visitIntegerLiteralNode(IntegerLiteralNode* node) {
+    step();
+    value = node->integer->value;
+  }
+
+  virtual void visitBooleanLiteralNode(BooleanLiteralNode* node) {
+    step();
+    value = node->integer->value;
+  }
+
+  virtual void visitNewNode(NewNode* node) {
+    step();
+    std::string objectClassName = node->identifier->name;
+    std::vector<int> values = arguments(node->expression_list);
+    int object = create(objectClassName);
+    if (classTable->at(objectClassName).methods->count(objectClassName)) {
+      call(objectClassName, objectClassName, object, values);
+    }
+    value = object;
+  }
+
+  virtual void visitIntegerTypeNode(IntegerTypeNode* node) {}
+  virtual void visitBooleanTypeNode(BooleanTypeNode* node) {}
+  virtual void visitObjectTypeNode(ObjectTypeNode* node) {}
+  virtual void visitNoneNode(NoneNode* node) {}
+  virtual void visitIdentifierNode(IdentifierNode* node) {}
+  virtual void visitIntegerNode(IntegerNode* node) {}
+};
+
+bool evaluateProgram(ProgramNode* program, ClassTable* classTable, const EvaluationBudget& budget, std::string& output) {
+  Interpreter interpreter(program, classTable, budget);
+  try {
+    // Main has no members, so its `this` is never read
+    interpreter.call("Main", "main", interpreter.create("Main"), std::vector<int>());
+  } catch (EvaluationStopped&) {
+    return false;
+  }
+  output.swap(interpreter.output);
+  return true;
+}
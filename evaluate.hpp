@@ -0,0 +1,51 @@
+#ifndef __EVALUATE_HPP
+#define __EVALUATE_HPP
+
+#include "ast.hpp"
+#include "typecheck.hpp"
+
+#include <string>
+
+// This file defines compile-time evaluation. Programs take no input,
+// so a program that always prints the same output can be run by the
+// compiler: it interprets the type checked AST of Main.main the way
+// the generated code would run it (arithmetic wraps around, arguments
+// are evaluated from last to first, a call on null runs the method of
+// the static class, and so on), collecting what it prints.
+//
+// Evaluation is strict: it gives up as soon as the program does
+// something whose outcome the compiler cannot be sure of, and the
+// program is then compiled as usual. That is, when it
+//
+//  - runs out of steps or memory (see EvaluationBudget), or nests
+//    calls deeper than maxEvaluationDepth,
+//  - would fail at run time: divides by zero (or the smallest integer
+//    by -1), or reads or writes a member of null,
+//  - reads a local it has not assigned, or a parameter new passed no
+//    argument for (whatever the stack held), or prints an object or
+//    the value of a method returning none.
+//
+// The CodeGenerator then emits Main_main as a single write of the
+// output (see CodeGenerator::evaluatedOutput).
+
+// Defines how much work evaluation may do.
+struct EvaluationBudget {
+  // The statements and expressions it may run
+  long long steps;
+  // The bytes of objects it may create (counting each object's
+  // descriptor word) and of output it may print (default: 16 MB)
+  long long memory;
+
+  EvaluationBudget() : steps(0), memory(1 << 24) {}
+};
+
+// Calls nested deeper than this give up, so the compiler's own stack
+// never overflows.
+const int maxEvaluationDepth = 1000;
+
+// Runs Main.main of a type checked program within a budget. Returns
+// true and sets output to what the program prints if it finishes, or
+// returns false if evaluation gives up.
+bool evaluateProgram(ProgramNode* program, ClassTable* classTable, const EvaluationBudget& budget, std::string& output);
+
+#endif
@@ -205,6 +205,8 @@ writeline(headerfile, "  char* base_char_ptr;")
 writeline(headerfile, "  int base_int;")
 writeline(headerfile, "} astnode_union;")
 writeline(headerfile, "#define YYSTYPE astnode_union")
+writeline(headerfile, "// The union is trivially copyable, so the parser can grow its stack")
+writeline(headerfile, "#define YYSTYPE_IS_TRIVIAL 1")
 writeline(headerfile, "")
 writeline(headerfile, "// Define abstract base class for all Visitors")
 writeline(headerfile, "class Visitor {")
@@ -225,10 +227,18 @@ writeline(headerfile, "  BaseType basetype;")
 writeline(headerfile, "  // All AST nodes have a member which stores the class name, applicable if the base type")
 writeline(headerfile, "  // is object. Otherwise this field may be unused")
 writeline(headerfile, "  std::string objectClassName;")
+writeline(headerfile, "  // The source line of the node, for the nodes the parser records")
+writeline(headerfile, "  // it on (identifiers, methods, if, while and do); 0 otherwise")
+writeline(headerfile, "  int lineno;")
+writeline(headerfile, "")
+writeline(headerfile, "  ASTNode() : lineno(0) {}")
 writeline(headerfile, "")
 writeline(headerfile, "  // All AST nodes provide visit children and accept methods")
 writeline(headerfile, "  virtual void visit_children(Visitor* v) = 0;")
 writeline(headerfile, "  virtual void accept(Visitor* v) = 0;")
+writeline(headerfile, "")
+writeline(headerfile, "  // Deleting a node deletes all of its children (and child lists)")
+writeline(headerfile, "  virtual ~ASTNode() {}")
 writeline(headerfile, "};")
 writeline(headerfile, "")
 writeline(headerfile, "// Define all abstract AST node classes")
@@ -297,6 +307,7 @@ for node in nodes:
     if (len(members) > 0):
         writeline(headerfile, "")
         writeline(headerfile, "  " + node.name + "Node(" + (", ".join(members)) + ");")
+        writeline(headerfile, "  virtual ~" + node.name + "Node();")
     writeline(headerfile, "};")
     writeline(headerfile, "")
 
@@ -340,6 +351,7 @@ for node in nodes:
     dupnames = {}
     childnames = []
     members = []
+    lists = []
     
     for child in node.children:
         if (child.name in childnames):
@@ -360,14 +372,17 @@ for node in nodes:
             writeline(codefile, "    }")
             writeline(codefile, "  }")
             members.append(("std::list<" + child.name + "Node*" + ">*", child.name.lower() + "_list" + number))
+            lists.append(child.name)
         elif (child.optional):
             writeline(codefile, "  if (this->" + child.name.lower() + number + ") {")
             writeline(codefile, "    this->" + child.name.lower() + number + "->accept(v);")
             writeline(codefile, "  }")
             members.append((child.name + "Node* ", child.name.lower() + number))
+            lists.append(None)
         else:
             writeline(codefile, "  " + child.name.lower() + number + "->accept(v);")
             members.append((child.name + "Node* ", child.name.lower() + number))
+            lists.append(None)
     writeline(codefile, "}")
     
     if (len(members) > 0):
@@ -378,6 +393,22 @@ for node in nodes:
             writeline(codefile, "  this->" + member[1] + " = " + member[1] + ";")
         writeline(codefile, "}")
 
+        writeline(codefile, "")
+        writeline(codefile, "// Destructor for " + node.name + " AST node")
+        writeline(codefile, "" + node.name + "Node::~" + node.name + "Node() {")
+        for member, listname in zip(members, lists):
+            if (listname):
+                writeline(codefile, "  if (this->" + member[1] + ") {")
+                writeline(codefile, "    for(std::list<" + listname + "Node*" + ">::iterator iter = this->" + member[1] + "->begin();")
+                writeline(codefile, "        iter != this->" + member[1] + "->end(); iter++) {")
+                writeline(codefile, "      delete (*iter);")
+                writeline(codefile, "    }")
+                writeline(codefile, "    delete this->" + member[1] + ";")
+                writeline(codefile, "  }")
+            else:
+                writeline(codefile, "  delete this->" + member[1] + ";")
+        writeline(codefile, "}")
+
 writeline(codefile, "")
 writeline(codefile, "// Definitions for print functions")
 writeline(codefile, "// Push Level adds a new level to the printed tree (for a node with children)")
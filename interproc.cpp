@@ -0,0 +1,423 @@
+#include "interproc.hpp"
+#include "deadcode.hpp"
+
+#include <map>
+#include <vector>
+
+// Defines a call (or new) in a method: the static class of its
+// receiver, the method it calls and its arguments.
+struct MethodCall {
+  std::string className;
+  std::string methodName;
+  std::list<ExpressionNode*>* arguments;
+};
+
+// This visitor collects the calls of a method, the locals it assigns,
+// whether it loops, and whether it does anything a pure method may
+// not do.
+class MethodScan : public Visitor {
+private:
+  std::string className;
+  VariableTable* variables;
+  ClassTable* classTable;
+
+public:
+  std::vector<MethodCall> calls;
+  std::set<std::string> assigned;
+  bool loops;
+  bool impure;
+
+  MethodScan(const std::string& className, VariableTable* variables, ClassTable* classTable)
+      : className(className), variables(variables), classTable(classTable), loops(false), impure(false) {}
+
+  virtual void visitProgramNode(ProgramNode* node) {}
+  virtual void visitClassNode(ClassNode* node) {}
+  virtual void visitMethodNode(MethodNode* node) { node->methodbody->accept(this); }
+  virtual void visitMethodBodyNode(MethodBodyNode* node) { node->visit_children(this); }
+  virtual void visitParameterNode(ParameterNode* node) {}
+  virtual void visitDeclarationNode(DeclarationNode* node) {}
+  virtual void visitReturnStatementNode(ReturnStatementNode* node) { node->visit_children(this); }
+
+  virtual void visitAssignmentNode(AssignmentNode* node) {
+    if (!node->identifier_2 && variables->count(node->identifier_1->name)) {
+      assigned.insert(node->identifier_1->name);
+    } else {
+      impure = true;
+    }
+    node->expression->accept(this);
+  }
+
+  virtual void visitCallNode(CallNode* node) { node->visit_children(this); }
+  virtual void visitIfElseNode(IfElseNode* node) { node->visit_children(this); }
+
+  virtual void visitWhileNode(WhileNode* node) {
+    loops = true;
+    node->visit_children(this);
+  }
+
+  virtual void visitPrintNode(PrintNode* node) {
+    impure = true;
+    node->visit_children(this);
+  }
+
+  virtual void visitDoWhileNode(DoWhileNode* node) {
+    loops = true;
+    node->visit_children(this);
+  }
+
+  virtual void visitPlusNode(PlusNode* node) { node->visit_children(this); }
+  virtual void visitMinusNode(MinusNode* node) { node->visit_children(this); }
+  virtual void visitTimesNode(TimesNode* node) { node->visit_children(this); }
+  virtual void visitDivideNode(DivideNode* node) { node->visit_children(this); }
+  virtual void visitGreaterNode(GreaterNode* node) { node->visit_children(this); }
+  virtual void visitGreaterEqualNode(GreaterEqualNode* node) { node->visit_children(this); }
+  virtual void visitEqualNode(EqualNode* node) { node->visit_children(this); }
+  virtual void visitAndNode(AndNode* node) { node->visit_children(this); }
+  virtual void visitOrNode(OrNode* node) { node->visit_children(this); }
+  virtual void visitNotNode(NotNode* node) { node->visit_children(this); }
+  virtual void visitNegationNode(NegationNode* node) { node->visit_children(this); }
+
+  // a pure method only calls methods of `this`
+  virtual void visitMethodCallNode(MethodCallNode* node) {
+    MethodCall call;
+    if (node->identifier_2) {
+      impure = true;
+      call.className = node->identifier_1->objectClassName;
+      call.methodName = node->identifier_2->name;
+    } else {
+      call.className = className;
+      call.methodName = node->identifier_1->name;
+    }
+    call.arguments = node->expression_list;
+    calls.push_back(call);
+    node->visit_children(this);
+  }
+
+  virtual void visitMemberAccessNode(MemberAccessNode* node) {
+    impure = true;
+  }
+
+  virtual void visitVariableNode(VariableNode* node) {
+    if (!variables->count(node->identifier->name)) {
+      impure = true;
+    }
+  }
+
+  virtual void visitIntegerLiteralNode(IntegerLiteralNode* node) {}
+  virtual void visitBooleanLiteralNode(BooleanLiteralNode* node) {}
+
+  virtual void visitNewNode(NewNode* node) {
+    impure = true;
+    std::string objectClassName = node->identifier->name;
+    if (classTable->at(objectClassName).methods->count(objectClassName)) {
+      MethodCall call;
+      call.className = objectClassName;
+      call.methodName = objectClassName;
+      call.arguments = node->expression_list;
+      calls.push_back(call);
+    }
+    node->visit_children(this);
+  }
+
+  virtual void visitIntegerTypeNode(IntegerTypeNode* node) {}
+  virtual void visitBooleanTypeNode(BooleanTypeNode* node) {}
+  virtual void visitObjectTypeNode(ObjectTypeNode* node) {}
+  virtual void visitNoneNode(NoneNode* node) {}
+  virtual void visitIdentifierNode(IdentifierNode* node) {}
+  virtual void visitIntegerNode(IntegerNode* node) {}
+};
+
+// Returns the Class_method names of the methods a call may run (a new
+// only runs the constructor of its class).
+static std::vector<std::string> callTargets(ClassTable* classTable, const MethodCall& call) {
+  std::string defining = call.className;
+  while (!classTable->at(defining).methods->count(call.methodName)) {
+    defining = classTable->at(defining).superClassName;
+  }
+  std::vector<std::string> targets(1, defining + "_" + call.methodName);
+  if (call.methodName == call.className) {
+    return targets;
+  }
+  for (ClassTable::iterator it = classTable->begin(); it != classTable->end(); it++) {
+    if (it->first == call.className || !it->second.methods->count(call.methodName)) {
+      continue;
+    }
+    for (std::string super = it->second.superClassName; !super.empty(); super = classTable->at(super).superClassName) {
+      if (super == call.className) {
+        targets.push_back(it->first + "_" + call.methodName);
+        break;
+      }
+    }
+  }
+  return targets;
+}
+
+// This visitor replaces every use of a parameter in a method body with
+// a literal.
+class ParameterSubstitution : public Visitor {
+private:
+  std::string name;
+  int value;
+  BaseType type;
+
+  void replace(ExpressionNode*& expression) {
+    VariableNode* variable = dynamic_cast<VariableNode*>(expression);
+    if (!variable || variable->identifier->name != name) {
+      expression->accept(this);
+      return;
+    }
+    ExpressionNode* literal;
+    if (type == bt_boolean) {
+      literal = new BooleanLiteralNode(new IntegerNode(value));
+    } else {
+      literal = new IntegerLiteralNode(new IntegerNode(value));
+    }
+    literal->basetype = type;
+    literal->lineno = variable->lineno;
+    delete variable;
+    expression = literal;
+    replaced++;
+  }
+
+  void replace(std::list<ExpressionNode*>* expressions) {
+    if (expressions) {
+      for (std::list<ExpressionNode*>::iterator it = expressions->begin(); it != expressions->end(); it++) {
+        replace(*it);
+      }
+    }
+  }
+
+  void visitStatements(std::list<StatementNode*>* statements) {
+    if (statements) {
+      for (std::list<StatementNode*>::iterator it = statements->begin(); it != statements->end(); it++) {
+        (*it)->accept(this);
+      }
+    }
+  }
+
+public:
+  int replaced;
+
+  ParameterSubstitution(const std::string& name, int value, BaseType type) : name(name), value(value), type(type), replaced(0) {}
+
+  virtual void visitProgramNode(ProgramNode* node) {}
+  virtual void visitClassNode(ClassNode* node) {}
+  virtual void visitMethodNode(MethodNode* node) { node->methodbody->accept(this); }
+
+  virtual void visitMethodBodyNode(MethodBodyNode* node) {
+    visitStatements(node->statement_list);
+    if (node->returnstatement) {
+      replace(node->returnstatement->expression);
+    }
+  }
+
+  virtual void visitParameterNode(ParameterNode* node) {}
+  virtual void visitDeclarationNode(DeclarationNode* node) {}
+  virtual void visitReturnStatementNode(ReturnStatementNode* node) {}
+  virtual void visitAssignmentNode(AssignmentNode* node) { replace(node->expression); }
+  virtual void visitCallNode(CallNode* node) { node->methodcall->accept(this); }
+
+  virtual void visitIfElseNode(IfElseNode* node) {
+    replace(node->expression);
+    visitStatements(node->statement_list_1);
+    visitStatements(node->statement_list_2);
+  }
+
+  virtual void visitWhileNode(WhileNode* node) {
+    replace(node->expression);
+    visitStatements(node->statement_list);
+  }
+
+  virtual void visitPrintNode(PrintNode* node) { replace(node->expression); }
+
+  virtual void visitDoWhileNode(DoWhileNode* node) {
+    visitStatements(node->statement_list);
+    replace(node->expression);
+  }
+
+  virtual void visitPlusNode(PlusNode* node) { replace(node->expression_1); replace(node->expression_2); }
+  virtual void visitMinusNode(MinusNode* node) { replace(node->expression_1); replace(node->expression_2); }
+  virtual void visitTimesNode(TimesNode* node) { replace(node->expression_1); replace(node->expression_2); }
+  virtual void visitDivideNode(DivideNode* node) { replace(node->expression_1); replace(node->expression_2); }
+  virtual void visitGreaterNode(GreaterNode* node) { replace(node->expression_1); replace(node->expression_2); }
+  virtual void visitGreaterEqualNode(GreaterEqualNode* node) { replace(node->expression_1); replace(node->expression_2); }
+  virtual void visitEqualNode(EqualNode* node) { replace(node->expression_1); replace(node->expression_2); }
+  virtual void visitAndNode(AndNode* node) { replace(node->expression_1); replace(node->expression_2); }
+  virtual void visitOrNode(OrNode* node) { replace(node->expression_1); replace(node->expression_2); }
+  virtual void visitNotNode(NotNode* node) { replace(node->expression); }
+  virtual void visitNegationNode(NegationNode* node) { replace(node->expression); }
+  virtual void visitMethodCallNode(MethodCallNode* node) { replace(node->expression_list); }
+  virtual void visitMemberAccessNode(MemberAccessNode* node) {}
+  virtual void visitVariableNode(VariableNode* node) {}
+  virtual void visitIntegerLiteralNode(IntegerLiteralNode* node) {}
+  virtual void visitBooleanLiteralNode(BooleanLiteralNode* node) {}
+  virtual void visitNewNode(NewNode* node) { replace(node->expression_list); }
+  virtual void visitIntegerTypeNode(IntegerTypeNode* node) {}
+  virtual void visitBooleanTypeNode(BooleanTypeNode* node) {}
+  virtual void visitObjectTypeNode(ObjectTypeNode* node) {}
+  virtual void visitNoneNode(NoneNode* node) {}
+  virtual void visitIdentifierNode(IdentifierNode* node) {}
+  virtual void visitIntegerNode(IntegerNode* node) {}
+};
+
+// Defines what the calls of a method pass for one parameter: nothing
+// yet, one constant, or different (or unknown) values.
+struct ArgumentValue {
+  enum { unseen, constant, varying } state;
+  int value;
+
+  ArgumentValue() : state(unseen), value(0) {}
+
+  void meet(ExpressionNode* argument) {
+    int argumentValue;
+    if (!constantValue(argument, argumentValue)) {
+      state = varying;
+    } else if (state == unseen) {
+      state = constant;
+      value = argumentValue;
+    } else if (state == constant && value != argumentValue) {
+      state = varying;
+    }
+  }
+};
+
+int propagateConstants(ProgramNode* program, ClassTable* classTable) {
+  std::vector<std::pair<std::string, MethodNode*> > methods;
+  std::map<std::string, size_t> parameterCounts;
+  for (std::list<ClassNode*>::iterator c = program->class_list->begin(); c != program->class_list->end(); c++) {
+    if ((*c)->method_list) {
+      for (std::list<MethodNode*>::iterator m = (*c)->method_list->begin(); m != (*c)->method_list->end(); m++) {
+        methods.push_back(std::make_pair((*c)->identifier_1->name, *m));
+        parameterCounts[(*c)->identifier_1->name + "_" + (*m)->identifier->name] = (*m)->parameter_list ? (*m)->parameter_list->size() : 0;
+      }
+    }
+  }
+
+  int replaced = 0;
+  for (int round = 1; round; replaced += round) {
+    std::vector<MethodScan> scans;
+    std::map<std::string, std::vector<ArgumentValue> > arguments;
+    for (size_t i = 0; i < methods.size(); i++) {
+      const std::string& className = methods[i].first;
+      MethodInfo& info = classTable->at(className).methods->at(methods[i].second->identifier->name);
+      scans.push_back(MethodScan(className, info.variables, classTable));
+      methods[i].second->accept(&scans.back());
+      for (size_t j = 0; j < scans.back().calls.size(); j++) {
+        const MethodCall& call = scans.back().calls[j];
+        std::vector<std::string> targets = callTargets(classTable, call);
+        for (size_t k = 0; k < targets.size(); k++) {
+          std::vector<ArgumentValue>& values = arguments[targets[k]];
+          values.resize(parameterCounts[targets[k]]);
+          if (!call.arguments || call.arguments->size() != values.size()) {
+            // the type checker does not check the arguments of new, so
+            // a constructor may get too few or too many: none is constant
+            for (size_t l = 0; l < values.size(); l++) {
+              values[l].state = ArgumentValue::varying;
+            }
+            continue;
+          }
+          std::list<ExpressionNode*>::iterator argument = call.arguments->begin();
+          for (size_t l = 0; l < values.size(); l++, argument++) {
+            values[l].meet(*argument);
+          }
+        }
+      }
+    }
+
+    round = 0;
+    for (size_t i = 0; i < methods.size(); i++) {
+      MethodNode* method = methods[i].second;
+      std::map<std::string, std::vector<ArgumentValue> >::iterator values = arguments.find(methods[i].first + "_" + method->identifier->name);
+      if (values == arguments.end() || !method->parameter_list || values->second.size() != method->parameter_list->size()) {
+        continue;
+      }
+      VariableTable* variables = classTable->at(methods[i].first).methods->at(method->identifier->name).variables;
+      size_t index = 0;
+      for (std::list<ParameterNode*>::iterator it = method->parameter_list->begin(); it != method->parameter_list->end(); it++, index++) {
+        std::string name = (*it)->identifier->name;
+        BaseType type = variables->at(name).type.baseType;
+        if (type == bt_object || scans[i].assigned.count(name) || values->second[index].state != ArgumentValue::constant) {
+          continue;
+        }
+        ParameterSubstitution substitution(name, values->second[index].value, type);
+        method->accept(&substitution);
+        if (substitution.replaced) {
+          round++;
+        }
+      }
+    }
+  }
+  return replaced;
+}
+
+void findPureMethods(ProgramNode* program, ClassTable* classTable, const std::set<std::string>& overridden, std::set<std::string>& pure) {
+  // assume every candidate is pure, then drop the ones calling a method
+  // that is not until none is left
+  std::map<std::string, std::vector<std::string> > callees;
+  for (std::list<ClassNode*>::iterator c = program->class_list->begin(); c != program->class_list->end(); c++) {
+    std::string className = (*c)->identifier_1->name;
+    if (!(*c)->method_list) {
+      continue;
+    }
+    for (std::list<MethodNode*>::iterator m = (*c)->method_list->begin(); m != (*c)->method_list->end(); m++) {
+      std::string methodName = (*m)->identifier->name;
+      std::string name = className + "_" + methodName;
+      MethodInfo& info = classTable->at(className).methods->at(methodName);
+      BaseType returnType = info.returnType.baseType;
+      if (methodName == className || overridden.count(name) || returnType == bt_object || returnType == bt_none) {
+        continue;
+      }
+      bool objects = false;
+      for (VariableTable::iterator it = info.variables->begin(); it != info.variables->end(); it++) {
+        objects = objects || it->second.type.baseType == bt_object;
+      }
+      MethodScan scan(className, info.variables, classTable);
+      (*m)->accept(&scan);
+      if (objects || scan.impure) {
+        continue;
+      }
+
+      bool direct = true;
+      std::vector<std::string>& names = callees[name];
+      for (size_t i = 0; i < scan.calls.size(); i++) {
+        std::vector<std::string> targets = callTargets(classTable, scan.calls[i]);
+        direct = direct && targets.size() == 1;
+        names.push_back(targets[0]);
+      }
+      if (direct) {
+        pure.insert(name);
+      }
+    }
+  }
+
+  for (bool changed = true; changed; ) {
+    changed = false;
+    for (std::set<std::string>::iterator it = pure.begin(); it != pure.end(); ) {
+      std::vector<std::string>& names = callees[*it];
+      bool callsImpure = false;
+      for (size_t i = 0; i < names.size(); i++) {
+        callsImpure = callsImpure || !pure.count(names[i]);
+      }
+      if (callsImpure) {
+        pure.erase(it++);
+        changed = true;
+      } else {
+        it++;
+      }
+    }
+  }
+}
+
+bool worthMemoizing(MethodNode* method, const std::string& className, ClassTable* classTable) {
+  if (!method->parameter_list || method->parameter_list->empty()) {
+    return false;
+  }
+  MethodScan scan(className, classTable->at(className).methods->at(method->identifier->name).variables, classTable);
+  method->accept(&scan);
+  for (std::list<ParameterNode*>::iterator it = method->parameter_list->begin(); it != method->parameter_list->end(); it++) {
+    if (scan.assigned.count((*it)->identifier->name)) {
+      return false;
+    }
+  }
+  return scan.loops || !scan.calls.empty();
+}
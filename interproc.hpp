@@ -0,0 +1,47 @@
+#ifndef __INTERPROC_HPP
+#define __INTERPROC_HPP
+
+#include "ast.hpp"
+#include "typecheck.hpp"
+
+#include <set>
+#include <string>
+
+// This file defines two analyses over the calls between the methods of
+// a whole program. A call reaches the method its receiver's static
+// class defines or inherits, and every override of it in a subclass;
+// new reaches the class's constructor.
+//
+// Interprocedural constant propagation: when every call of a method
+// passes the same constant for an integer or boolean parameter the
+// method never assigns, the method is specialized for it: the uses of
+// the parameter in its body are replaced by the constant, so they fold
+// like literals (into constant branches, see deadcode.hpp, and into
+// immediates, see isel.hpp). The calls still pass the argument. This
+// can make the arguments the method passes on constant, so it repeats
+// until nothing changes. Methods that are never called are left alone.
+//
+// Purity: a pure method returns an integer or boolean computed from
+// integer and boolean parameters alone. It never reads or assigns a
+// member, prints, creates an object or holds one, and only calls pure
+// methods of `this`. Neither it nor the methods it calls are
+// overridden, so every call of it runs the same code. Two calls of a
+// pure method with the same arguments return the same value, so the
+// value of the first can be reused (see cse.hpp), or kept in a memo
+// table (see CodeGenOptions::memoize).
+
+// Replaces the constant parameters of the methods of a program, and
+// returns how many parameters were replaced.
+int propagateConstants(ProgramNode* program, ClassTable* classTable);
+
+// Adds the Class_method names of the pure methods of a program to
+// pure. overridden holds the methods that are overridden (see
+// findOverriddenMethods).
+void findPureMethods(ProgramNode* program, ClassTable* classTable, const std::set<std::string>& overridden, std::set<std::string>& pure);
+
+// Returns true if a pure method is worth a memo table: it has
+// parameters, never assigns them (they are the table's key), and calls
+// a method or loops.
+bool worthMemoizing(MethodNode* method, const std::string& className, ClassTable* classTable);
+
+#endif
@@ -0,0 +1,515 @@
+#include "isel.hpp"
+
+#include <algorithm>
+
+namespace {
+
+const int infinite = 1 << 20;
+
+// The registers in the order they are allocated; the first four have
+// byte registers for setcc.
+const char* const registerOrder[] = {"%eax", "%ecx", "%edx", "%ebx", "%esi", "%edi"};
+
+// Conditions a rule puts on the immediate right operand
+enum Constraint { c_none, c_scale, c_power, c_lea, c_zero };
+
+// How a rule emits its code
+enum Emitter {
+  e_leaf, e_fold, e_move, e_lea, e_shift, e_test, e_compare_zero,
+  e_binary, e_unary, e_shift_times, e_lea_times, e_index, e_address, e_displace, e_compare, e_set
+};
+
+struct SelectionRule {
+  Nonterminal result;
+  SelectionOp op;
+  // The nonterminals of the operands (of the node itself for a chain
+  // rule); nt_count if there is none
+  Nonterminal left;
+  Nonterminal right;
+  Constraint constraint;
+  int cost;
+  Emitter emitter;
+  // The instruction, or the condition a rule for nt_cc sets
+  const char* instruction;
+};
+
+// The cost table. Costs count an instruction as 1, a memory operand as
+// 1 more and a multiplication as 3.
+const SelectionRule rules[] = {
+  // leaves
+  {nt_imm, op_constant, nt_count, nt_count, c_none, 0, e_leaf, ""},
+  {nt_mem, op_frame, nt_count, nt_count, c_none, 0, e_leaf, ""},
+  {nt_reg, op_load, nt_count, nt_count, c_none, 0, e_leaf, ""},
+
+  // chain rules
+  {nt_reg, op_chain, nt_imm, nt_count, c_none, 1, e_move, "mov"},
+  {nt_reg, op_chain, nt_mem, nt_count, c_none, 2, e_move, "mov"},
+  {nt_reg, op_chain, nt_addr, nt_count, c_none, 1, e_lea, "lea"},
+  {nt_reg, op_chain, nt_index, nt_count, c_none, 1, e_shift, "shl"},
+  {nt_cc, op_chain, nt_reg, nt_count, c_none, 1, e_test, "ne"},
+  {nt_cc, op_chain, nt_mem, nt_count, c_none, 2, e_compare_zero, "ne"},
+  {nt_reg, op_chain, nt_cc, nt_count, c_none, 2, e_set, "set"},
+
+  // constants
+  {nt_imm, op_plus, nt_imm, nt_imm, c_none, 0, e_fold, ""},
+  {nt_imm, op_minus, nt_imm, nt_imm, c_none, 0, e_fold, ""},
+  {nt_imm, op_times, nt_imm, nt_imm, c_none, 0, e_fold, ""},
+  {nt_imm, op_and, nt_imm, nt_imm, c_none, 0, e_fold, ""},
+  {nt_imm, op_or, nt_imm, nt_imm, c_none, 0, e_fold, ""},
+  {nt_imm, op_not, nt_imm, nt_count, c_none, 0, e_fold, ""},
+  {nt_imm, op_negation, nt_imm, nt_count, c_none, 0, e_fold, ""},
+
+  // arithmetic
+  {nt_reg, op_plus, nt_reg, nt_imm, c_none, 1, e_binary, "add"},
+  {nt_reg, op_plus, nt_reg, nt_mem, c_none, 2, e_binary, "add"},
+  {nt_reg, op_plus, nt_reg, nt_reg, c_none, 1, e_binary, "add"},
+  {nt_reg, op_minus, nt_reg, nt_imm, c_none, 1, e_binary, "sub"},
+  {nt_reg, op_minus, nt_reg, nt_mem, c_none, 2, e_binary, "sub"},
+  {nt_reg, op_minus, nt_reg, nt_reg, c_none, 1, e_binary, "sub"},
+  {nt_reg, op_times, nt_reg, nt_imm, c_power, 1, e_shift_times, "shl"},
+  {nt_reg, op_times, nt_reg, nt_imm, c_lea, 1, e_lea_times, "lea"},
+  {nt_reg, op_times, nt_reg, nt_imm, c_none, 3, e_binary, "imul"},
+  {nt_reg, op_times, nt_reg, nt_mem, c_none, 4, e_binary, "imul"},
+  {nt_reg, op_times, nt_reg, nt_reg, c_none, 3, e_binary, "imul"},
+  {nt_reg, op_and, nt_reg, nt_imm, c_none, 1, e_binary, "and"},
+  {nt_reg, op_and, nt_reg, nt_mem, c_none, 2, e_binary, "and"},
+  {nt_reg, op_and, nt_reg, nt_reg, c_none, 1, e_binary, "and"},
+  {nt_reg, op_or, nt_reg, nt_imm, c_none, 1, e_binary, "or"},
+  {nt_reg, op_or, nt_reg, nt_mem, c_none, 2, e_binary, "or"},
+  {nt_reg, op_or, nt_reg, nt_reg, c_none, 1, e_binary, "or"},
+  {nt_reg, op_not, nt_reg, nt_count, c_none, 1, e_unary, "xor $1,"},
+  {nt_reg, op_negation, nt_reg, nt_count, c_none, 1, e_unary, "neg"},
+
+  // addresses: base + index * scale + displacement, computed by one lea
+  {nt_index, op_times, nt_reg, nt_imm, c_scale, 0, e_index, ""},
+  {nt_addr, op_plus, nt_reg, nt_index, c_none, 0, e_address, ""},
+  {nt_addr, op_plus, nt_reg, nt_reg, c_none, 0, e_address, ""},
+  {nt_addr, op_plus, nt_addr, nt_imm, c_none, 0, e_displace, ""},
+  {nt_addr, op_plus, nt_index, nt_imm, c_none, 0, e_displace, ""},
+
+  // conditions
+  {nt_cc, op_greater, nt_reg, nt_imm, c_none, 1, e_compare, "g"},
+  {nt_cc, op_greater, nt_reg, nt_mem, c_none, 2, e_compare, "g"},
+  {nt_cc, op_greater, nt_reg, nt_reg, c_none, 1, e_compare, "g"},
+  {nt_cc, op_greater_equal, nt_reg, nt_imm, c_none, 1, e_compare, "ge"},
+  {nt_cc, op_greater_equal, nt_reg, nt_mem, c_none, 2, e_compare, "ge"},
+  {nt_cc, op_greater_equal, nt_reg, nt_reg, c_none, 1, e_compare, "ge"},
+  {nt_cc, op_equal, nt_reg, nt_imm, c_zero, 1, e_test, "e"},
+  {nt_cc, op_equal, nt_reg, nt_imm, c_none, 1, e_compare, "e"},
+  {nt_cc, op_equal, nt_reg, nt_mem, c_none, 2, e_compare, "e"},
+  {nt_cc, op_equal, nt_reg, nt_reg, c_none, 1, e_compare, "e"},
+};
+
+const int ruleCount = sizeof(rules) / sizeof(rules[0]);
+
+// Returns true if the operands of an operator may be matched in either
+// order (comparisons swap their condition).
+bool commutes(SelectionOp op) {
+  return op == op_plus || op == op_times || op == op_and || op == op_or ||
+    op == op_greater || op == op_greater_equal || op == op_equal;
+}
+
+bool satisfies(Constraint constraint, int value) {
+  switch (constraint) {
+    case c_scale: return value == 2 || value == 4 || value == 8;
+    case c_power: return value >= 2 && (value & (value - 1)) == 0;
+    case c_lea: return value == 3 || value == 5 || value == 9;
+    case c_zero: return value == 0;
+    default: return true;
+  }
+}
+
+int shiftOf(int value) {
+  int bits = 0;
+  while (value > 1) {
+    value >>= 1;
+    bits++;
+  }
+  return bits;
+}
+
+// Folds an operator over constants, wrapping around like the machine.
+int fold(SelectionOp op, int left, int right) {
+  unsigned a = left, b = right;
+  switch (op) {
+    case op_plus: return a + b;
+    case op_minus: return a - b;
+    case op_times: return a * b;
+    case op_and: return a & b;
+    case op_or: return a | b;
+    case op_not: return a ^ 1;
+    case op_negation: return 0u - a;
+    default: return 0;
+  }
+}
+
+// Returns the condition of a comparison with its operands swapped.
+std::string swapCondition(const std::string& condition) {
+  if (condition == "g") return "l";
+  if (condition == "ge") return "le";
+  return condition;
+}
+
+// Finds the operator of an expression and its operands.
+SelectionOp operation(ExpressionNode* node, ExpressionNode*& left, ExpressionNode*& right) {
+  left = right = NULL;
+  if (PlusNode* plus = dynamic_cast<PlusNode*>(node)) {
+    left = plus->expression_1;
+    right = plus->expression_2;
+    return op_plus;
+  } else if (MinusNode* minus = dynamic_cast<MinusNode*>(node)) {
+    left = minus->expression_1;
+    right = minus->expression_2;
+    return op_minus;
+  } else if (TimesNode* times = dynamic_cast<TimesNode*>(node)) {
+    left = times->expression_1;
+    right = times->expression_2;
+    return op_times;
+  } else if (AndNode* andNode = dynamic_cast<AndNode*>(node)) {
+    left = andNode->expression_1;
+    right = andNode->expression_2;
+    return op_and;
+  } else if (OrNode* orNode = dynamic_cast<OrNode*>(node)) {
+    left = orNode->expression_1;
+    right = orNode->expression_2;
+    return op_or;
+  } else if (NotNode* notNode = dynamic_cast<NotNode*>(node)) {
+    left = notNode->expression;
+    return op_not;
+  } else if (NegationNode* negation = dynamic_cast<NegationNode*>(node)) {
+    left = negation->expression;
+    return op_negation;
+  } else if (GreaterNode* greater = dynamic_cast<GreaterNode*>(node)) {
+    left = greater->expression_1;
+    right = greater->expression_2;
+    return op_greater;
+  } else if (GreaterEqualNode* greaterEqual = dynamic_cast<GreaterEqualNode*>(node)) {
+    left = greaterEqual->expression_1;
+    right = greaterEqual->expression_2;
+    return op_greater_equal;
+  } else if (EqualNode* equal = dynamic_cast<EqualNode*>(node)) {
+    left = equal->expression_1;
+    right = equal->expression_2;
+    return op_equal;
+  }
+  return op_none;
+}
+
+}
+
+std::string negateCondition(const std::string& condition) {
+  if (condition == "g") return "le";
+  if (condition == "ge") return "l";
+  if (condition == "l") return "ge";
+  if (condition == "le") return "g";
+  if (condition == "e") return "ne";
+  return "e";
+}
+
+// Labels a tree bottom-up: the cheapest cost of every nonterminal of a
+// node, the rule reaching it and the registers it needs (evaluating
+// the operand that needs more first, while the other waits in one).
+InstructionSelector::Label& InstructionSelector::label(ExpressionNode* node) {
+  std::map<ExpressionNode*, Label>::iterator it = labels.find(node);
+  if (it != labels.end()) {
+    return it->second;
+  }
+
+  Label result;
+  for (int nt = 0; nt < nt_count; nt++) {
+    result.cost[nt] = infinite;
+    result.need[nt] = 0;
+    result.rule[nt] = -1;
+    result.swapped[nt] = false;
+  }
+  result.value = 0;
+  result.info = info(node);
+  result.saves = result.info.saved != 0;
+  result.reads = result.info.reused;
+  result.ordered = false;
+  result.loads = result.info.op == op_load;
+
+  ExpressionNode* left = NULL;
+  ExpressionNode* right = NULL;
+  SelectionOp op = result.info.op;
+  if (op == op_none) {
+    op = operation(node, left, right);
+  }
+  // labels are never removed, so these stay valid
+  Label* leftLabel = left ? &label(left) : NULL;
+  Label* rightLabel = right ? &label(right) : NULL;
+  if (leftLabel) {
+    result.saves = result.saves || leftLabel->saves;
+    result.reads = result.reads || leftLabel->reads;
+    result.loads = result.loads || leftLabel->loads;
+  }
+  if (rightLabel) {
+    result.saves = result.saves || rightLabel->saves;
+    result.reads = result.reads || rightLabel->reads;
+    result.loads = result.loads || rightLabel->loads;
+    result.ordered = leftLabel->saves && rightLabel->reads;
+  }
+
+  for (int i = 0; op != op_none && i < ruleCount; i++) {
+    const SelectionRule& rule = rules[i];
+    if (rule.op != op) {
+      continue;
+    }
+    for (int swap = 0; swap < (rightLabel && commutes(op) ? 2 : 1); swap++) {
+      Label* first = swap ? rightLabel : leftLabel;
+      Label* second = swap ? leftLabel : rightLabel;
+      int cost = rule.cost + (op == op_load ? result.info.loadCost : 0);
+      int need = rule.result == nt_reg ? 1 : 0;
+      // a value saved for later is computed into a register
+      if ((first && first->info.saved && rule.left != nt_reg) || (second && second->info.saved && rule.right != nt_reg)) {
+        continue;
+      }
+      if (first) {
+        cost += first->cost[rule.left];
+        need = first->need[rule.left];
+      }
+      if (second) {
+        cost += second->cost[rule.right];
+        int a = need, b = second->need[rule.right];
+        if (result.ordered) {
+          // the left operand (second if swapped) waits for the right one
+          need = swap ? std::max(b, a + 1) : std::max(a, b + 1);
+        } else {
+          need = std::max(std::max(a, b), std::min(a, b) + 1);
+        }
+        if (rule.constraint != c_none && (second->cost[nt_imm] >= infinite || !satisfies(rule.constraint, second->value))) {
+          continue;
+        }
+      }
+      if (cost < result.cost[rule.result]) {
+        result.cost[rule.result] = cost;
+        result.need[rule.result] = need;
+        result.rule[rule.result] = i;
+        result.swapped[rule.result] = swap;
+        if (rule.emitter == e_fold) {
+          result.value = fold(op, first->value, second ? second->value : 0);
+        } else if (op == op_constant) {
+          result.value = result.info.value;
+        }
+      }
+    }
+  }
+  closure(result);
+
+  return labels[node] = result;
+}
+
+// Applies the chain rules until no nonterminal gets cheaper.
+void InstructionSelector::closure(Label& label) {
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (int i = 0; i < ruleCount; i++) {
+      const SelectionRule& rule = rules[i];
+      if (rule.op != op_chain || label.cost[rule.left] >= infinite) {
+        continue;
+      }
+      int cost = rule.cost + label.cost[rule.left];
+      if (cost < label.cost[rule.result]) {
+        label.cost[rule.result] = cost;
+        label.need[rule.result] = std::max(label.need[rule.left], rule.result == nt_reg ? 1 : 0);
+        label.rule[rule.result] = i;
+        label.swapped[rule.result] = false;
+        changed = true;
+      }
+    }
+  }
+}
+
+bool InstructionSelector::selectable(ExpressionNode* root, Nonterminal goal, int available) {
+  Label& rootLabel = label(root);
+  if (rootLabel.info.saved && goal != nt_reg) {
+    return false;
+  }
+  return rootLabel.cost[goal] < infinite && rootLabel.need[goal] <= available;
+}
+
+bool InstructionSelector::speculable(ExpressionNode* root) {
+  return !label(root).loads;
+}
+
+bool InstructionSelector::saves(ExpressionNode* root) {
+  return label(root).saves;
+}
+
+std::string InstructionSelector::reduce(ExpressionNode* root, Nonterminal goal, int available) {
+  registers.assign(registerOrder, registerOrder + available);
+  std::reverse(registers.begin(), registers.end());
+  Operand result = reduceNode(root, goal);
+  return goal == nt_cc ? result.condition : text(result, goal);
+}
+
+std::string InstructionSelector::allocate() {
+  std::string reg = registers.back();
+  registers.pop_back();
+  return reg;
+}
+
+// Allocates a register with a byte register, or returns "" if none is
+// free.
+std::string InstructionSelector::allocateByte() {
+  for (int i = registers.size() - 1; i >= 0; i--) {
+    if (registers[i] != "%esi" && registers[i] != "%edi") {
+      std::string reg = registers[i];
+      registers.erase(registers.begin() + i);
+      return reg;
+    }
+  }
+  return "";
+}
+
+void InstructionSelector::release(const Operand& operand) {
+  if (!operand.base.empty()) {
+    registers.push_back(operand.base);
+  }
+  if (!operand.index.empty()) {
+    registers.push_back(operand.index);
+  }
+}
+
+std::string InstructionSelector::text(const Operand& operand, Nonterminal nt) {
+  switch (nt) {
+    case nt_imm:
+      return "$" + std::to_string(operand.value);
+    case nt_mem:
+      return std::to_string(operand.value) + "(%ebp)";
+    case nt_reg:
+      return operand.base;
+    default:
+      return (operand.value ? std::to_string(operand.value) : "") + "(" + operand.base +
+        (operand.index.empty() ? "" : "," + operand.index + "," + std::to_string(operand.scale)) + ")";
+  }
+}
+
+// Reduces a labeled tree top-down, emitting the code of the rules.
+InstructionSelector::Operand InstructionSelector::reduceNode(ExpressionNode* node, Nonterminal nt) {
+  Label& nodeLabel = labels.at(node);
+  const SelectionRule& rule = rules[nodeLabel.rule[nt]];
+
+  ExpressionNode* left = NULL;
+  ExpressionNode* right = NULL;
+  if (rule.op != op_chain && rule.left != nt_count) {
+    operation(node, left, right);
+  }
+  if (nodeLabel.swapped[nt]) {
+    std::swap(left, right);
+  }
+
+  Operand a, b;
+  if (rule.op == op_chain) {
+    a = reduceNode(node, rule.left);
+  } else if (left && right && (nodeLabel.ordered ? nodeLabel.swapped[nt] : labels.at(right).need[rule.right] > labels.at(left).need[rule.left])) {
+    b = reduceNode(right, rule.right);
+    a = reduceNode(left, rule.left);
+  } else if (left) {
+    a = reduceNode(left, rule.left);
+    if (right) {
+      b = reduceNode(right, rule.right);
+    }
+  }
+
+  Operand result;
+  switch (rule.emitter) {
+    case e_leaf:
+      result.value = nodeLabel.info.value;
+      if (rule.op == op_load) {
+        result.base = allocate();
+        for (size_t i = 0; i < nodeLabel.info.load.size(); i++) {
+          std::string line = nodeLabel.info.load[i];
+          for (size_t at = line.find("%r"); at != std::string::npos; at = line.find("%r", at)) {
+            line.replace(at, 2, result.base);
+          }
+          emit(line);
+        }
+      }
+      break;
+    case e_fold:
+      result.value = nodeLabel.value;
+      break;
+    case e_move:
+      result.base = allocate();
+      emit("mov " + text(a, rule.left) + ", " + result.base);
+      break;
+    case e_lea:
+      result.base = a.base.empty() ? a.index : a.base;
+      emit("lea " + text(a, nt_addr) + ", " + result.base);
+      if (!a.base.empty() && !a.index.empty()) {
+        registers.push_back(a.index);
+      }
+      break;
+    case e_shift:
+      result.base = a.index;
+      emit("shl $" + std::to_string(shiftOf(a.scale)) + ", " + result.base);
+      break;
+    case e_test:
+      emit("test " + a.base + ", " + a.base);
+      release(a);
+      result.condition = rule.instruction;
+      break;
+    case e_compare_zero:
+      emit("cmpl $0, " + text(a, nt_mem));
+      result.condition = rule.instruction;
+      break;
+    case e_binary:
+      emit(std::string(rule.instruction) + " " + text(b, rule.right) + ", " + a.base);
+      release(b);
+      result = a;
+      break;
+    case e_unary:
+      emit(std::string(rule.instruction) + " " + a.base);
+      result = a;
+      break;
+    case e_shift_times:
+      emit("shl $" + std::to_string(shiftOf(b.value)) + ", " + a.base);
+      result = a;
+      break;
+    case e_lea_times:
+      emit("lea (" + a.base + "," + a.base + "," + std::to_string(b.value - 1) + "), " + a.base);
+      result = a;
+      break;
+    case e_index:
+      result.index = a.base;
+      result.scale = b.value;
+      break;
+    case e_address:
+      result.base = a.base;
+      result.index = rule.right == nt_index ? b.index : b.base;
+      result.scale = rule.right == nt_index ? b.scale : 1;
+      break;
+    case e_displace:
+      result = a;
+      result.value += b.value;
+      break;
+    case e_compare:
+      emit("cmp " + text(b, rule.right) + ", " + a.base);
+      release(a);
+      release(b);
+      result.condition = nodeLabel.swapped[nt] ? swapCondition(rule.instruction) : rule.instruction;
+      break;
+    case e_set:
+      result.base = allocateByte();
+      if (!result.base.empty()) {
+        std::string byte = "%" + result.base.substr(2, 1) + "l";
+        emit("set" + a.condition + " " + byte);
+        emit("movzbl " + byte + ", " + result.base);
+      } else {
+        // pushing and popping leave the flags alone
+        result.base = allocate();
+        emit("push %eax");
+        emit("set" + a.condition + " %al");
+        emit("movzbl %al, " + result.base);
+        emit("pop %eax");
+      }
+      break;
+  }
+
+  if (nt == nt_reg && nodeLabel.info.saved) {
+    emit("mov " + result.base + ", " + std::to_string(nodeLabel.info.saved) + "(%ebp)");
+  }
+  return result;
+}
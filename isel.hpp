@@ -0,0 +1,129 @@
+#ifndef __ISEL_HPP
+#define __ISEL_HPP
+
+#include "ast.hpp"
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// This file defines the instruction selector, which generates code for
+// whole expression trees instead of one fixed push/pop template per
+// node. It is a BURS-style tree pattern matcher: the rules below each
+// rewrite an operator whose operands have been reduced to the given
+// nonterminals (an immediate, a frame slot, a register, a scaled index
+// or an address) to a nonterminal, at a cost. Patterns of several
+// nodes (an address computed with one lea, a multiplication by 2, 4 or
+// 8 folded into it, a comparison with zero) are written with the
+// nonterminals in between. A comparison sets the flags (nt_cc), which
+// a branch jumps on, or setcc turns into 0 or 1. Labeling the tree bottom-up finds the
+// cheapest rule for every node and nonterminal; reducing it top-down
+// emits the code.
+//
+// The selector only covers trees without calls and new (so no
+// collection can happen while it holds values in registers), made of
+// the operators in the rule table: a tree with any other operator is
+// left to the CodeGenerator's templates, which select its operands.
+// An operator is added by adding its rules.
+//
+// Values are computed in %eax, %ecx, %edx, %ebx, %esi and %edi (the
+// operand stack holds all other values), evaluating the operand that
+// needs more registers first, unless the left one saves a value the
+// right one reuses. A tree that needs more is not selected.
+
+enum Nonterminal { nt_imm, nt_mem, nt_reg, nt_index, nt_addr, nt_cc, nt_count };
+
+enum SelectionOp {
+  op_constant, op_frame, op_load, op_chain,
+  op_plus, op_minus, op_times, op_and, op_or, op_not, op_negation,
+  op_greater, op_greater_equal, op_equal, op_none
+};
+
+// Defines how the code generator reads an expression.
+struct SelectionInfo {
+  // op_constant, op_frame or op_load for a leaf, op_none otherwise
+  SelectionOp op;
+  // The constant, or the frame offset (from %ebp) of the word
+  int value;
+  // The code that loads a leaf into the register %r, and its cost
+  std::vector<std::string> load;
+  int loadCost;
+  // The frame offset of the temporary the value is saved to (see
+  // cse.hpp), or 0, and whether the value is read from one
+  int saved;
+  bool reused;
+
+  SelectionInfo() : op(op_none), value(0), loadCost(0), saved(0), reused(false) {}
+};
+
+class InstructionSelector {
+public:
+  InstructionSelector(std::function<SelectionInfo(ExpressionNode*)> info, std::function<void(const std::string&)> emit)
+      : info(info), emit(emit) {}
+
+  // Returns true if the selector covers a tree, reducing it to goal
+  // with the first available registers (%eax, %ecx, %edx, %ebx, %esi,
+  // %edi).
+  bool selectable(ExpressionNode* root, Nonterminal goal, int available = 6);
+  // Returns true if a selectable tree may be computed when its value
+  // is not needed, that is, it loads nothing through an object.
+  bool speculable(ExpressionNode* root);
+  // Returns true if a selectable tree saves a value for later (see
+  // cse.hpp).
+  bool saves(ExpressionNode* root);
+  // Emits the code for a selectable tree and returns its operand: an
+  // immediate or a register, or the condition (as in jcc) under which
+  // it is true for nt_cc.
+  std::string reduce(ExpressionNode* root, Nonterminal goal, int available = 6);
+
+private:
+  struct Label {
+    int cost[nt_count];
+    int need[nt_count];
+    int rule[nt_count];
+    bool swapped[nt_count];
+    // The value of a tree of constants
+    int value;
+    SelectionInfo info;
+    // Set if the tree saves or reuses a value, and if its left operand
+    // must be evaluated first because of it
+    bool saves;
+    bool reads;
+    bool ordered;
+    // Set if the tree loads through an object
+    bool loads;
+  };
+
+  // An operand while it is reduced: an immediate or frame offset
+  // (value), a register (base), an address (value(base,index,scale))
+  // or a condition
+  struct Operand {
+    int value;
+    std::string base;
+    std::string index;
+    int scale;
+    std::string condition;
+
+    Operand() : value(0), scale(1) {}
+  };
+
+  std::function<SelectionInfo(ExpressionNode*)> info;
+  std::function<void(const std::string&)> emit;
+  std::map<ExpressionNode*, Label> labels;
+  std::vector<std::string> registers;
+
+  Label& label(ExpressionNode* node);
+  void closure(Label& label);
+  Operand reduceNode(ExpressionNode* node, Nonterminal nt);
+  std::string allocate();
+  std::string allocateByte();
+  void release(const Operand& operand);
+  std::string text(const Operand& operand, Nonterminal nt);
+};
+
+// Returns the condition that holds when a condition does not (as in
+// jcc).
+std::string negateCondition(const std::string& condition);
+
+#endif
@@ -0,0 +1,230 @@
+#include "loops.hpp"
+
+// Defines what the loop being visited (and the loops inside it) does.
+struct LoopScope {
+  // How often every local is assigned
+  std::map<std::string, int> assigned;
+  // The products not reduced in an inner loop
+  std::vector<TimesNode*> products;
+};
+
+// This visitor finds the counting loops of a method body, inner loops
+// first.
+class LoopAnalysis : public Visitor {
+private:
+  const MethodInfo& method;
+  int localsSize;
+  std::vector<LoopScope> scopes;
+
+  bool integerLocal(const std::string& name) {
+    return method.variables->count(name) && method.variables->at(name).type.baseType == bt_integer;
+  }
+
+  bool isVariable(ExpressionNode* node, const std::string& name) {
+    VariableNode* variable = dynamic_cast<VariableNode*>(node);
+    return variable && variable->identifier->name == name;
+  }
+
+  // Returns true if an expression is a literal or an integer local
+  // that the loop never assigns, setting value or variable to it.
+  bool invariant(ExpressionNode* node, const LoopScope& scope, int& value, std::string& variable) {
+    if (IntegerLiteralNode* literal = dynamic_cast<IntegerLiteralNode*>(node)) {
+      value = literal->integer->value;
+      variable = "";
+      return true;
+    }
+    VariableNode* local = dynamic_cast<VariableNode*>(node);
+    if (local && integerLocal(local->identifier->name) && !scope.assigned.count(local->identifier->name)) {
+      value = 0;
+      variable = local->identifier->name;
+      return true;
+    }
+    return false;
+  }
+
+  void visitStatements(std::list<StatementNode*>* statements) {
+    if (statements) {
+      for (std::list<StatementNode*>::iterator it = statements->begin(); it != statements->end(); it++) {
+        (*it)->accept(this);
+      }
+    }
+  }
+
+  // Returns true if a loop is a counting loop, filling in all of it
+  // but its products.
+  bool countingLoop(ExpressionNode* condition, std::list<StatementNode*>* body, const LoopScope& scope, CountingLoop& loop) {
+    if (!body || body->empty()) {
+      return false;
+    }
+    AssignmentNode* increment = dynamic_cast<AssignmentNode*>(body->back());
+    if (!increment || increment->identifier_2) {
+      return false;
+    }
+    std::string name = increment->identifier_1->name;
+    PlusNode* plus = dynamic_cast<PlusNode*>(increment->expression);
+    if (!integerLocal(name) || scope.assigned.at(name) != 1 || !plus) {
+      return false;
+    }
+    IntegerLiteralNode* step = NULL;
+    if (isVariable(plus->expression_1, name)) {
+      step = dynamic_cast<IntegerLiteralNode*>(plus->expression_2);
+    } else if (isVariable(plus->expression_2, name)) {
+      step = dynamic_cast<IntegerLiteralNode*>(plus->expression_1);
+    }
+    if (!step || step->integer->value <= 0) {
+      return false;
+    }
+
+    ExpressionNode* bound;
+    if (GreaterNode* greater = dynamic_cast<GreaterNode*>(condition)) {
+      loop.inclusive = false;
+      bound = greater->expression_1;
+      if (!isVariable(greater->expression_2, name)) {
+        return false;
+      }
+    } else if (GreaterEqualNode* greaterEqual = dynamic_cast<GreaterEqualNode*>(condition)) {
+      loop.inclusive = true;
+      bound = greaterEqual->expression_1;
+      if (!isVariable(greaterEqual->expression_2, name)) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+    if (!invariant(bound, scope, loop.bound, loop.boundVariable)) {
+      return false;
+    }
+
+    loop.variable = name;
+    loop.step = step->integer->value;
+    loop.increment = increment;
+    return true;
+  }
+
+  // Ends the scope of a loop: if it is a counting loop, it takes the
+  // products of its induction variable; the rest are left to the
+  // loops around it.
+  void endLoop(StatementNode* node, ExpressionNode* condition, std::list<StatementNode*>* body) {
+    LoopScope scope = scopes.back();
+    scopes.pop_back();
+
+    std::vector<TimesNode*> unreduced;
+    CountingLoop loop;
+    if (countingLoop(condition, body, scope, loop)) {
+      // products with the same other factor share a temporary
+      std::map<std::string, int> temporaries;
+      for (size_t i = 0; i < scope.products.size(); i++) {
+        TimesNode* product = scope.products[i];
+        ReducedProduct reduced;
+        bool reducible = false;
+        if (isVariable(product->expression_1, loop.variable)) {
+          reducible = invariant(product->expression_2, scope, reduced.factor, reduced.factorVariable);
+        } else if (isVariable(product->expression_2, loop.variable)) {
+          reducible = invariant(product->expression_1, scope, reduced.factor, reduced.factorVariable);
+        }
+        if (!reducible || reduced.factorVariable == loop.variable) {
+          unreduced.push_back(product);
+          continue;
+        }
+
+        std::string key = reduced.factorVariable.empty() ? std::to_string(reduced.factor) : reduced.factorVariable;
+        if (!temporaries.count(key)) {
+          result.frameSize += 4;
+          reduced.offset = -(localsSize + result.frameSize);
+          temporaries[key] = reduced.offset;
+          loop.products.push_back(reduced);
+        }
+        result.reduced[product] = temporaries[key];
+      }
+      result.loops[node] = loop;
+      result.increments[loop.increment] = node;
+    } else {
+      unreduced = scope.products;
+    }
+
+    if (!scopes.empty()) {
+      LoopScope& outer = scopes.back();
+      for (std::map<std::string, int>::iterator it = scope.assigned.begin(); it != scope.assigned.end(); it++) {
+        outer.assigned[it->first] += it->second;
+      }
+      outer.products.insert(outer.products.end(), unreduced.begin(), unreduced.end());
+    }
+  }
+
+public:
+  MethodLoops result;
+
+  LoopAnalysis(const MethodInfo& method, int localsSize) : method(method), localsSize(localsSize) {}
+
+  virtual void visitProgramNode(ProgramNode* node) { node->visit_children(this); }
+  virtual void visitClassNode(ClassNode* node) { node->visit_children(this); }
+  virtual void visitMethodNode(MethodNode* node) { node->visit_children(this); }
+  virtual void visitMethodBodyNode(MethodBodyNode* node) { node->visit_children(this); }
+  virtual void visitParameterNode(ParameterNode* node) {}
+  virtual void visitDeclarationNode(DeclarationNode* node) {}
+  virtual void visitReturnStatementNode(ReturnStatementNode* node) { node->visit_children(this); }
+
+  virtual void visitAssignmentNode(AssignmentNode* node) {
+    if (!node->identifier_2 && !scopes.empty()) {
+      scopes.back().assigned[node->identifier_1->name]++;
+    }
+    node->expression->accept(this);
+  }
+
+  virtual void visitCallNode(CallNode* node) { node->visit_children(this); }
+  virtual void visitIfElseNode(IfElseNode* node) { node->visit_children(this); }
+
+  virtual void visitWhileNode(WhileNode* node) {
+    scopes.push_back(LoopScope());
+    node->expression->accept(this);
+    visitStatements(node->statement_list);
+    endLoop(node, node->expression, node->statement_list);
+  }
+
+  virtual void visitPrintNode(PrintNode* node) { node->visit_children(this); }
+
+  virtual void visitDoWhileNode(DoWhileNode* node) {
+    scopes.push_back(LoopScope());
+    visitStatements(node->statement_list);
+    node->expression->accept(this);
+    endLoop(node, node->expression, node->statement_list);
+  }
+
+  virtual void visitPlusNode(PlusNode* node) { node->visit_children(this); }
+  virtual void visitMinusNode(MinusNode* node) { node->visit_children(this); }
+
+  virtual void visitTimesNode(TimesNode* node) {
+    if (!scopes.empty()) {
+      scopes.back().products.push_back(node);
+    }
+    node->visit_children(this);
+  }
+
+  virtual void visitDivideNode(DivideNode* node) { node->visit_children(this); }
+  virtual void visitGreaterNode(GreaterNode* node) { node->visit_children(this); }
+  virtual void visitGreaterEqualNode(GreaterEqualNode* node) { node->visit_children(this); }
+  virtual void visitEqualNode(EqualNode* node) { node->visit_children(this); }
+  virtual void visitAndNode(AndNode* node) { node->visit_children(this); }
+  virtual void visitOrNode(OrNode* node) { node->visit_children(this); }
+  virtual void visitNotNode(NotNode* node) { node->visit_children(this); }
+  virtual void visitNegationNode(NegationNode* node) { node->visit_children(this); }
+  virtual void visitMethodCallNode(MethodCallNode* node) { node->visit_children(this); }
+  virtual void visitMemberAccessNode(MemberAccessNode* node) {}
+  virtual void visitVariableNode(VariableNode* node) {}
+  virtual void visitIntegerLiteralNode(IntegerLiteralNode* node) {}
+  virtual void visitBooleanLiteralNode(BooleanLiteralNode* node) {}
+  virtual void visitNewNode(NewNode* node) { node->visit_children(this); }
+  virtual void visitIntegerTypeNode(IntegerTypeNode* node) {}
+  virtual void visitBooleanTypeNode(BooleanTypeNode* node) {}
+  virtual void visitObjectTypeNode(ObjectTypeNode* node) {}
+  virtual void visitNoneNode(NoneNode* node) {}
+  virtual void visitIdentifierNode(IdentifierNode* node) {}
+  virtual void visitIntegerNode(IntegerNode* node) {}
+};
+
+MethodLoops findCountingLoops(MethodNode* method, const std::string& className, ClassTable* classTable, int localsSize) {
+  MethodInfo info = classTable->at(className).methods->at(method->identifier->name);
+  LoopAnalysis analysis(info, localsSize);
+  method->accept(&analysis);
+  return analysis.result;
+}
@@ -0,0 +1,72 @@
+#ifndef __LOOPS_HPP
+#define __LOOPS_HPP
+
+#include "ast.hpp"
+#include "typecheck.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+// This file defines the analysis of counting loops: while and do while
+// loops of the form
+//
+//   while (bound > i) { ...; i = i + step; }
+//
+// where i is an integer local that the loop assigns nowhere else, step
+// is a positive literal, and the bound is a literal or an integer local
+// that the loop never assigns (bound >= i works too). i is the loop's
+// induction variable.
+//
+// The CodeGenerator unrolls counting loops and strength-reduces the
+// products of their induction variable: a product i * k (or k * i, with
+// k a literal or an integer local the loop never assigns) is kept in a
+// temporary, which is set before the loop and increased by step * k
+// whenever i is increased, so the loop never multiplies. A product is
+// reduced in the innermost loop it qualifies for.
+
+// Defines a product of an induction variable kept in a temporary.
+struct ReducedProduct {
+  // The frame offset (from %ebp) of the temporary
+  int offset;
+  // The other factor: a literal, or the local named factorVariable
+  int factor;
+  std::string factorVariable;
+};
+
+// Defines a counting loop.
+struct CountingLoop {
+  // The induction variable and the step it is increased by
+  std::string variable;
+  int step;
+  // The bound: a literal, or the local named boundVariable
+  int bound;
+  std::string boundVariable;
+  // Set if the condition is bound >= i
+  bool inclusive;
+  // The statement increasing the induction variable
+  AssignmentNode* increment;
+  // The products reduced in this loop
+  std::vector<ReducedProduct> products;
+};
+
+// Defines the counting loops of a method.
+struct MethodLoops {
+  // Every counting loop, by its WhileNode or DoWhileNode
+  std::map<StatementNode*, CountingLoop> loops;
+  // The loop of every increment statement
+  std::map<AssignmentNode*, StatementNode*> increments;
+  // The frame offset of the temporary of every reduced product
+  std::map<ExpressionNode*, int> reduced;
+  // The bytes the temporaries add to the method's locals
+  int frameSize;
+
+  MethodLoops() : frameSize(0) {}
+};
+
+// Finds the counting loops of a method of the given class. The
+// temporaries of its reduced products are put below the first
+// localsSize bytes of its frame.
+MethodLoops findCountingLoops(MethodNode* method, const std::string& className, ClassTable* classTable, int localsSize);
+
+#endif
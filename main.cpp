@@ -1,31 +1,291 @@
-#include "ast.hpp"
-#include "typecheck.hpp"
-#include "codegeneration.hpp"
-#include "parser.hpp"
-
-extern int yydebug;
-extern int yyparse();
-
-ASTNode* astRoot;
-
-int main(void) {
-    yydebug = 0; // Set this to 1 if you want the parser to output debug information and parse process
-    
-    astRoot = NULL;
-    
-    yyparse();
-    
-    if (astRoot) {
-        TypeCheck* typecheck = new TypeCheck();
-        astRoot->accept(typecheck);
-        ClassTable* classTable = typecheck->classTable;
-        if (classTable) {
+#include "cache.hpp"
+#include "compiler.hpp"
+#include "separate.hpp"
+#include "timereport.hpp"
+#include "server.hpp"
+#include "profile.hpp"
+#include "deadcode.hpp"
+
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+// The visitors used by the streaming pipeline. They persist across
+// classes: the class table built so far is needed to check and
+// generate every later class.
+static TypeCheck* streamTypecheck;
+static CodeGenerator* streamCodegen;
+
+// Type checks and generates code for a single class, then frees its
+// AST. Classes may only extend previously declared classes, so all
+// the information a class needs is already in the class table.
+static void streamClass(ClassNode* node) {
+    node->accept(streamTypecheck);
+    node->accept(streamCodegen);
+    delete node;
+}
+
+static void printErrors(std::vector<std::string>& errors) {
+    for (size_t i = 0; i < errors.size(); i++) {
+        std::cerr << errors[i] << std::endl;
+    }
+}
+
+// Compiles the program on stdin like the default pipeline, timing
+// every phase for the report. The assembly is generated into a
+// buffer, so that writing it out is timed as a phase of its own.
+static void compileWithReport(TimeReport& report, const CompileOptions& options, std::vector<std::string>& errors) {
+    report.beginPhase();
+    ProgramNode* program = parseProgram(stdin, errors, ClassHandler(), &report.lexTime);
+    report.endPhase("parse");
+    if (!program) {
+        return;
+    }
+    report.countNodes(program);
+
+    report.beginPhase();
+    TypeCheck typecheck;
+    program->accept(&typecheck);
+    report.endPhase("typecheck");
+
+    report.beginPhase();
+    std::ostringstream assembly;
+    CodeGenerator codegen;
+    codegen.classTable = typecheck.classTable;
+    codegen.out = &assembly;
+    codegen.options = options.codegen;
+    codegen.instructionCounts = &report.instructionCounts;
+    program->accept(&codegen);
+    report.endPhase("codegen");
+
+    report.beginPhase();
+    std::cout << assembly.str();
+    std::cout.flush();
+    report.endPhase("output");
+}
+
+int main(int argc, char** argv) {
+    CompileOptions options;
+
+    // --stream: process each class as soon as it is parsed, keeping
+    // only the class being compiled in memory. Code for earlier classes
+    // has already been written if a later class has a type error.
+    bool stream = false;
+    // --serve SOCKET: run as a compile server (see server.hpp) with
+    // --workers N worker threads (default: one per core).
+    std::string serveSocket;
+    int workers = std::thread::hardware_concurrency();
+    // Source and interface files given on the command line are
+    // compiled separately (see separate.hpp) instead of stdin.
+    std::vector<std::string> files;
+    // --time-report[=json]: print where the time and memory of the
+    // compilation went on stderr (see timereport.hpp).
+    bool timeReport = false;
+    bool timeReportJson = false;
+    // --layout: print the size and member layout of every class on
+    // stderr (see printLayout).
+    bool layoutReport = false;
+    // --dce-report: print how much dead code was removed on stderr
+    // (see deadcode.hpp).
+    bool deadCodeReport = false;
+    std::string profilePath;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--stream")) {
+            stream = true;
+        } else if (!strcmp(argv[i], "--cache") && i + 1 < argc) {
+            // --cache DIR: reuse the code of classes that have not changed
+            // since an earlier compilation (see cache.hpp).
+            options.cacheDirectory = argv[++i];
+        } else if (!strcmp(argv[i], "--profile") || !strcmp(argv[i], "--profile=time")) {
+            // --profile[=time]: count method calls, loop iterations and
+            // branches (and cycles per method) in the generated program,
+            // which writes them to a profile file at exit (see tester.c).
+            options.codegen.profile = true;
+            options.codegen.profileTime = !strcmp(argv[i], "--profile=time");
+        } else if (!strcmp(argv[i], "--use-profile") && i + 1 < argc) {
+            // --use-profile FILE: optimize with the profile written by a
+            // program compiled with --profile (see profile.hpp).
+            profilePath = argv[++i];
+        } else if (!strcmp(argv[i], "--unroll") && i + 1 < argc) {
+            // --unroll N: unroll counting loops N times (default: 4;
+            // 1 turns unrolling off).
+            options.codegen.unroll = atoi(argv[++i]);
+            if (options.codegen.unroll < 1) {
+                std::cerr << "Invalid unroll factor: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (!strcmp(argv[i], "--register-calls")) {
+            // --register-calls: pass `this` and the first two arguments
+            // of calls between compiled methods in registers.
+            options.codegen.registerCalls = true;
+        } else if (!strcmp(argv[i], "--memoize")) {
+            // --memoize: give pure methods that call methods or loop a
+            // memo table (see interproc.hpp).
+            options.codegen.memoize = true;
+        } else if (!strcmp(argv[i], "--evaluate") && i + 1 < argc) {
+            // --evaluate STEPS: run the program at compile time for up
+            // to STEPS statements and expressions, and compile it to a
+            // write of its output if it finishes (see evaluate.hpp).
+            options.codegen.evaluate.steps = atoll(argv[++i]);
+            if (options.codegen.evaluate.steps < 1) {
+                std::cerr << "Invalid evaluation steps: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (!strcmp(argv[i], "--evaluate-memory") && i + 1 < argc) {
+            // --evaluate-memory BYTES: the memory evaluation may use.
+            options.codegen.evaluate.memory = atoll(argv[++i]);
+            if (options.codegen.evaluate.memory < 1) {
+                std::cerr << "Invalid evaluation memory: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (!strcmp(argv[i], "--time-report") || !strcmp(argv[i], "--time-report=json")) {
+            timeReport = true;
+            timeReportJson = !strcmp(argv[i], "--time-report=json");
+        } else if (!strcmp(argv[i], "--layout")) {
+            layoutReport = true;
+        } else if (!strcmp(argv[i], "--dce-report")) {
+            deadCodeReport = true;
+        } else if (!strcmp(argv[i], "--serve") && i + 1 < argc) {
+            serveSocket = argv[++i];
+        } else if (!strcmp(argv[i], "--workers") && i + 1 < argc) {
+            workers = atoi(argv[++i]);
+            if (workers < 1) {
+                std::cerr << "Invalid number of workers: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if ((!strcmp(argv[i], "-j") || !strcmp(argv[i], "--jobs")) && i + 1 < argc) {
+            // -j N / --jobs N: type check method bodies and generate code
+            // for methods on N threads.
+            options.jobs = atoi(argv[++i]);
+            if (options.jobs < 1) {
+                std::cerr << "Invalid number of jobs: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (argv[i][0] != '-') {
+            files.push_back(argv[i]);
+        } else {
+            std::cerr << "Unknown option: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    ProfileData profile;
+    if (!profilePath.empty()) {
+        std::vector<std::string> warnings;
+        if (!readProfile(profilePath, profile, warnings)) {
+            std::cerr << "Cannot read the profile " << profilePath << std::endl;
+            return 1;
+        }
+        for (size_t i = 0; i < warnings.size(); i++) {
+            std::cerr << "warning: " << warnings[i] << std::endl;
+        }
+        options.codegen.profileData = &profile;
+    }
+
+    if (stream && options.jobs) {
+        std::cerr << "--stream cannot be combined with --jobs" << std::endl;
+        return 1;
+    }
+    if (!options.cacheDirectory.empty() && (stream || options.jobs)) {
+        std::cerr << "--cache cannot be combined with --stream or --jobs" << std::endl;
+        return 1;
+    }
+
+    if (options.codegen.evaluate.steps && (stream || !options.cacheDirectory.empty() || !files.empty())) {
+        std::cerr << "--evaluate needs the whole program, so it cannot be combined with --stream, --cache or files" << std::endl;
+        return 1;
+    }
+
+    if (timeReport && (stream || options.jobs || !options.cacheDirectory.empty() || !serveSocket.empty() || !files.empty())) {
+        std::cerr << "--time-report only applies to the default sequential pipeline" << std::endl;
+        return 1;
+    }
+
+    if (layoutReport && (stream || timeReport || !options.cacheDirectory.empty() || !serveSocket.empty() || !files.empty())) {
+        std::cerr << "--layout only applies to the default pipeline" << std::endl;
+        return 1;
+    }
+
+    if (deadCodeReport && (stream || timeReport || !options.cacheDirectory.empty() || !serveSocket.empty() || !files.empty())) {
+        std::cerr << "--dce-report only applies to the default pipeline" << std::endl;
+        return 1;
+    }
+
+    if (!files.empty()) {
+        if (stream || !serveSocket.empty() || !options.cacheDirectory.empty()) {
+            std::cerr << "Files cannot be combined with --stream, --serve or --cache" << std::endl;
+            return 1;
+        }
+        return compileFiles(files, options);
+    }
+
+    if (!serveSocket.empty()) {
+        return runServer(serveSocket, workers > 0 ? workers : 1, options);
+    }
+
+    // Syntax errors are reported on stderr with a zero exit status;
+    // type errors exit with status 1.
+    std::vector<std::string> errors;
+
+    try {
+        if (stream) {
+            streamTypecheck = new TypeCheck();
+            streamTypecheck->beginProgram();
+            streamCodegen = new CodeGenerator();
+            streamCodegen->classTable = streamTypecheck->classTable;
+            streamCodegen->options = options.codegen;
+            streamCodegen->genProgramPrologue();
+
+            ProgramNode* program = parseProgram(stdin, errors, streamClass);
+            if (program) {
+                streamTypecheck->endProgram();
+                streamCodegen->genProgramEpilogue();
+            }
+            printErrors(errors);
+            return 0;
+        }
+
+        if (timeReport) {
+            TimeReport report;
+            compileWithReport(report, options, errors);
+            printErrors(errors);
+            if (timeReportJson) {
+                report.printJson(std::cerr);
+            } else {
+                report.print(std::cerr);
+            }
+            return 0;
+        }
+
+        ProgramNode* program = parseProgram(stdin, errors);
+        if (program && !options.cacheDirectory.empty()) {
+            CacheStats stats;
+            compileCached(program, options, std::cout, stats);
+            printCacheStats(stats, std::cerr);
+        } else if (program) {
+            ClassTable* classTable = typeCheckProgram(program, options);
             // Uncomment the following line to print the class table after it is generated
             //print(*classTable);
-            CodeGenerator* codegen = new CodeGenerator();
-            codegen->classTable = classTable;
-            astRoot->accept(codegen);
+            if (layoutReport) {
+                printLayout(classTable, std::cerr);
+            }
+            if (deadCodeReport) {
+                // the code generator removes the same code again (which
+                // changes nothing) without counting it, along with the
+                // branches constant parameters make constant (see
+                // interproc.hpp)
+                DeadCodeStats stats;
+                std::set<std::string> reachable;
+                eliminateDeadCode(program, classTable, reachable, &stats);
+                printDeadCode(stats, std::cerr);
+            }
+            generateProgram(program, classTable, options, std::cout);
         }
+        printErrors(errors);
+    } catch (TypeErrorException& e) {
+        std::cout.flush();
+        std::cerr << typeErrorMessage(e.code) << std::endl;
+        return 1;
     }
 
     return 0;
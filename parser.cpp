@@ -0,0 +1,2226 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison implementation for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* C LALR(1) parser skeleton written by Richard Stallman, by
+   simplifying the original so-called "semantic" parser.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+/* All symbols defined below should begin with yy or YY, to avoid
+   infringing on user name space.  This should be done even for local
+   variables, as they might otherwise be expanded by user macros.
+   There are some unavoidable exceptions within include files to
+   define necessary library symbols; they are noted "INFRINGES ON
+   USER NAME SPACE" below.  */
+
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
+
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
+
+/* Skeleton name.  */
+#define YYSKELETON_NAME "yacc.c"
+
+/* Pure parsers.  */
+#define YYPURE 2
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
+#line 10 "parser.y"
+
+    #include <cstdlib>
+    #include <cstdio>
+    #include <iostream>
+
+    #include "ast.hpp"
+
+    #define YYDEBUG 1
+    #define YYINITDEPTH 10000
+
+#line 82 "parser.cpp"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
+#include "parser.hpp"
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_T_EXTENDS = 3,                  /* T_EXTENDS  */
+  YYSYMBOL_T_TRUE = 4,                     /* T_TRUE  */
+  YYSYMBOL_T_FALSE = 5,                    /* T_FALSE  */
+  YYSYMBOL_T_NEW = 6,                      /* T_NEW  */
+  YYSYMBOL_T_PRINT = 7,                    /* T_PRINT  */
+  YYSYMBOL_T_RETURN = 8,                   /* T_RETURN  */
+  YYSYMBOL_T_IF = 9,                       /* T_IF  */
+  YYSYMBOL_T_ELSE = 10,                    /* T_ELSE  */
+  YYSYMBOL_T_WHILE = 11,                   /* T_WHILE  */
+  YYSYMBOL_T_INTEGER = 12,                 /* T_INTEGER  */
+  YYSYMBOL_T_BOOLEAN = 13,                 /* T_BOOLEAN  */
+  YYSYMBOL_T_NONE = 14,                    /* T_NONE  */
+  YYSYMBOL_T_EQUALS = 15,                  /* T_EQUALS  */
+  YYSYMBOL_T_AND = 16,                     /* T_AND  */
+  YYSYMBOL_T_OR = 17,                      /* T_OR  */
+  YYSYMBOL_T_NOT = 18,                     /* T_NOT  */
+  YYSYMBOL_T_DO = 19,                      /* T_DO  */
+  YYSYMBOL_T_LBRACKET = 20,                /* T_LBRACKET  */
+  YYSYMBOL_T_RBRACKET = 21,                /* T_RBRACKET  */
+  YYSYMBOL_T_LPAREN = 22,                  /* T_LPAREN  */
+  YYSYMBOL_T_RPAREN = 23,                  /* T_RPAREN  */
+  YYSYMBOL_T_SEMICOLON = 24,               /* T_SEMICOLON  */
+  YYSYMBOL_T_ARROW = 25,                   /* T_ARROW  */
+  YYSYMBOL_T_COMMA = 26,                   /* T_COMMA  */
+  YYSYMBOL_T_DOT = 27,                     /* T_DOT  */
+  YYSYMBOL_T_ID = 28,                      /* T_ID  */
+  YYSYMBOL_T_NUMBER = 29,                  /* T_NUMBER  */
+  YYSYMBOL_T_GTHANE = 30,                  /* T_GTHANE  */
+  YYSYMBOL_T_GTHAN = 31,                   /* T_GTHAN  */
+  YYSYMBOL_T_PLUS = 32,                    /* T_PLUS  */
+  YYSYMBOL_T_MINUS = 33,                   /* T_MINUS  */
+  YYSYMBOL_T_TIMES = 34,                   /* T_TIMES  */
+  YYSYMBOL_T_DIVIDE = 35,                  /* T_DIVIDE  */
+  YYSYMBOL_T_ASSEQUALS = 36,               /* T_ASSEQUALS  */
+  YYSYMBOL_YYACCEPT = 37,                  /* $accept  */
+  YYSYMBOL_Program = 38,                   /* Program  */
+  YYSYMBOL_Class = 39,                     /* Class  */
+  YYSYMBOL_ClassBody = 40,                 /* ClassBody  */
+  YYSYMBOL_Members = 41,                   /* Members  */
+  YYSYMBOL_Methods = 42,                   /* Methods  */
+  YYSYMBOL_Parameters = 43,                /* Parameters  */
+  YYSYMBOL_Parameters2 = 44,               /* Parameters2  */
+  YYSYMBOL_Body = 45,                      /* Body  */
+  YYSYMBOL_Declarations = 46,              /* Declarations  */
+  YYSYMBOL_Declaration = 47,               /* Declaration  */
+  YYSYMBOL_VarName = 48,                   /* VarName  */
+  YYSYMBOL_Statements = 49,                /* Statements  */
+  YYSYMBOL_Statement = 50,                 /* Statement  */
+  YYSYMBOL_Assignment = 51,                /* Assignment  */
+  YYSYMBOL_MethodCallStatement = 52,       /* MethodCallStatement  */
+  YYSYMBOL_IfElse = 53,                    /* IfElse  */
+  YYSYMBOL_If = 54,                        /* If  */
+  YYSYMBOL_Else = 55,                      /* Else  */
+  YYSYMBOL_While = 56,                     /* While  */
+  YYSYMBOL_DoWhile = 57,                   /* DoWhile  */
+  YYSYMBOL_Block = 58,                     /* Block  */
+  YYSYMBOL_Print = 59,                     /* Print  */
+  YYSYMBOL_Return = 60,                    /* Return  */
+  YYSYMBOL_Expression = 61,                /* Expression  */
+  YYSYMBOL_MethodCall = 62,                /* MethodCall  */
+  YYSYMBOL_Arguments = 63,                 /* Arguments  */
+  YYSYMBOL_Arguments2 = 64,                /* Arguments2  */
+  YYSYMBOL_Type = 65,                      /* Type  */
+  YYSYMBOL_ReturnType = 66                 /* ReturnType  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
+
+
+/* Unqualified %code blocks.  */
+#line 21 "parser.y"
+
+    /* Methods and Statements are right recursive, so the parser stack
+       grows with the number of methods in a class and statements in a
+       block. The stack starts at YYINITDEPTH and is reallocated as it
+       grows (see YYSTYPE_IS_TRIVIAL in ast.hpp) up to this limit */
+    #define YYMAXDEPTH 10000000
+
+    int yylex(YYSTYPE* yylval, yyscan_t scanner);
+    void yyerror(yyscan_t scanner, ParseState* state, const char *);
+
+#line 194 "parser.cpp"
+
+#ifdef short
+# undef short
+#endif
+
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
+
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
+#else
+typedef short yytype_uint8;
+#endif
+
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
+#else
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
+#endif
+
+#ifndef YYSIZE_T
+# ifdef __SIZE_TYPE__
+#  define YYSIZE_T __SIZE_TYPE__
+# elif defined size_t
+#  define YYSIZE_T size_t
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYSIZE_T size_t
+# else
+#  define YYSIZE_T unsigned
+# endif
+#endif
+
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_uint8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
+#endif
+
+/* Suppress unused-variable warnings by "using" E.  */
+#if ! defined lint || defined __GNUC__
+# define YY_USE(E) ((void) (E))
+#else
+# define YY_USE(E) /* empty */
+#endif
+
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
+#else
+# define YY_INITIAL_VALUE(Value) Value
+#endif
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if 1
+
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
+
+# ifdef YYSTACK_USE_ALLOCA
+#  if YYSTACK_USE_ALLOCA
+#   ifdef __GNUC__
+#    define YYSTACK_ALLOC __builtin_alloca
+#   elif defined __BUILTIN_VA_ARG_INCR
+#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
+#   elif defined _AIX
+#    define YYSTACK_ALLOC __alloca
+#   elif defined _MSC_VER
+#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
+#    define alloca _alloca
+#   else
+#    define YYSTACK_ALLOC alloca
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
+#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
+#     endif
+#    endif
+#   endif
+#  endif
+# endif
+
+# ifdef YYSTACK_ALLOC
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
+#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
+#  endif
+# else
+#  define YYSTACK_ALLOC YYMALLOC
+#  define YYSTACK_FREE YYFREE
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
+#  endif
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
+       && ! ((defined YYMALLOC || defined malloc) \
+             && (defined YYFREE || defined free)))
+#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
+#   endif
+#  endif
+#  ifndef YYMALLOC
+#   define YYMALLOC malloc
+#   if ! defined malloc && ! defined EXIT_SUCCESS
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+#  ifndef YYFREE
+#   define YYFREE free
+#   if ! defined free && ! defined EXIT_SUCCESS
+void free (void *); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+# endif
+#endif /* 1 */
+
+#if (! defined yyoverflow \
+     && (! defined __cplusplus \
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+
+/* A type that is properly aligned for any stack member.  */
+union yyalloc
+{
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+};
+
+/* The size of the maximum gap between one aligned stack and the next.  */
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
+
+/* The size of an array large to enough to hold all stacks, each with
+   N elements.  */
+# define YYSTACK_BYTES(N) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
+      + YYSTACK_GAP_MAXIMUM)
+
+# define YYCOPY_NEEDED 1
+
+/* Relocate STACK from its old location to the new one.  The
+   local variables YYSIZE and YYSTACKSIZE give the old and new number of
+   elements in the stack, and YYPTR gives the new location of the
+   stack.  Advance YYPTR to a properly aligned location for the next
+   stack.  */
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
+
+#endif
+
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
+/* YYFINAL -- State number of the termination state.  */
+#define YYFINAL  6
+/* YYLAST -- Last index in YYTABLE.  */
+#define YYLAST   234
+
+/* YYNTOKENS -- Number of terminals.  */
+#define YYNTOKENS  37
+/* YYNNTS -- Number of nonterminals.  */
+#define YYNNTS  30
+/* YYNRULES -- Number of rules.  */
+#define YYNRULES  72
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  150
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   291
+
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
+{
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
+      25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
+      35,    36
+};
+
+#if YYDEBUG
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
+{
+       0,    91,    91,    98,   107,   109,   113,   117,   124,   128,
+     134,   138,   140,   144,   146,   150,   154,   156,   160,   164,
+     166,   170,   176,   180,   182,   184,   186,   188,   190,   194,
+     196,   200,   204,   206,   210,   214,   218,   222,   226,   234,
+     238,   240,   244,   246,   248,   250,   252,   254,   256,   258,
+     260,   262,   264,   266,   268,   270,   272,   274,   276,   278,
+     280,   282,   286,   288,   292,   294,   298,   300,   305,   307,
+     309,   313,   315
+};
+#endif
+
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if 1
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
+/* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
+   First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
+static const char *const yytname[] =
+{
+  "\"end of file\"", "error", "\"invalid token\"", "T_EXTENDS", "T_TRUE",
+  "T_FALSE", "T_NEW", "T_PRINT", "T_RETURN", "T_IF", "T_ELSE", "T_WHILE",
+  "T_INTEGER", "T_BOOLEAN", "T_NONE", "T_EQUALS", "T_AND", "T_OR", "T_NOT",
+  "T_DO", "T_LBRACKET", "T_RBRACKET", "T_LPAREN", "T_RPAREN",
+  "T_SEMICOLON", "T_ARROW", "T_COMMA", "T_DOT", "T_ID", "T_NUMBER",
+  "T_GTHANE", "T_GTHAN", "T_PLUS", "T_MINUS", "T_TIMES", "T_DIVIDE",
+  "T_ASSEQUALS", "$accept", "Program", "Class", "ClassBody", "Members",
+  "Methods", "Parameters", "Parameters2", "Body", "Declarations",
+  "Declaration", "VarName", "Statements", "Statement", "Assignment",
+  "MethodCallStatement", "IfElse", "If", "Else", "While", "DoWhile",
+  "Block", "Print", "Return", "Expression", "MethodCall", "Arguments",
+  "Arguments2", "Type", "ReturnType", YY_NULLPTR
+};
+
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  return yytname[yysymbol];
+}
+#endif
+
+#define YYPACT_NINF (-101)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-1)
+
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int16 yypact[] =
+{
+     -20,     4,     9,  -101,   -18,  -101,  -101,  -101,     7,    20,
+      35,  -101,  -101,  -101,  -101,    38,  -101,    34,    47,    64,
+      58,  -101,  -101,    49,  -101,    57,  -101,    77,    60,   161,
+      64,  -101,  -101,    83,  -101,  -101,    88,    33,    82,    10,
+      10,    10,    92,    48,  -101,   105,    62,  -101,  -101,  -101,
+     110,  -101,  -101,  -101,   113,   106,    38,  -101,  -101,  -101,
+     108,    10,    10,    61,  -101,    10,    63,  -101,    84,    91,
+      62,    10,   121,    10,    10,  -101,    48,  -101,   118,  -101,
+    -101,   135,   126,   140,  -101,   112,   149,  -101,    10,    10,
+      10,  -101,    10,    10,    10,    10,    10,    10,    62,    62,
+      62,   155,   178,   164,   162,    -5,   124,   136,    62,   106,
+    -101,    10,  -101,   168,    98,   199,   190,    98,    98,   -16,
+     -16,  -101,  -101,   170,   175,  -101,   186,  -101,    10,    10,
+      10,  -101,  -101,   177,  -101,   184,  -101,  -101,   193,   178,
+     194,   148,  -101,  -101,    10,  -101,  -101,   169,   192,  -101
+};
+
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
+{
+       0,     0,     0,     2,     0,     8,     1,     3,     0,     0,
+      10,     8,     4,    68,    69,    70,     6,     0,     0,    12,
+       0,     5,    70,     0,    11,     0,     7,     0,    13,     0,
+       0,    72,    71,     0,    14,    17,     0,    22,    10,     0,
+       0,     0,     0,    70,    16,    41,    22,    23,    24,    25,
+      32,    26,    27,    28,     0,     0,     0,     9,    58,    59,
+       0,     0,     0,    53,    57,     0,     0,    55,     0,     0,
+       0,    65,     0,     0,     0,    15,     0,    21,     0,    33,
+      31,    20,     0,    60,    51,     0,     0,    52,     0,     0,
+       0,    39,     0,     0,     0,     0,     0,     0,     0,     0,
+      22,     0,    67,     0,    64,     0,     0,     0,     0,     0,
+      18,    65,    56,    54,    48,    49,    50,    47,    46,    42,
+      43,    44,    45,     0,     0,    38,     0,    62,     0,    65,
+       0,    29,    40,     0,    19,     0,    34,    36,     0,    66,
+       0,     0,    35,    61,     0,    63,    30,     0,     0,    37
+};
+
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int16 yypgoto[] =
+{
+    -101,  -101,   216,   208,  -101,   188,  -101,   197,  -101,  -101,
+    -101,   119,   -41,   -33,  -101,  -101,  -101,  -101,  -101,  -101,
+    -101,   -78,  -101,  -101,   -39,   -34,  -100,  -101,    -4,  -101
+};
+
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_int8 yydefgoto[] =
+{
+       0,     2,     3,     9,    10,    16,    23,    24,    36,    37,
+      44,    82,    45,   100,    47,    48,    49,    50,    79,    51,
+      52,   101,    53,    75,   102,    67,   103,   104,    25,    33
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_uint8 yytable[] =
+{
+      66,    68,    69,    54,    46,    77,    17,     4,     1,     6,
+       8,   135,    54,    46,    58,    59,    60,   129,    96,    97,
+     123,   124,    84,    85,     5,    32,    87,    11,    61,   140,
+     133,   130,    62,    55,   106,   107,    54,     1,    63,    64,
+      39,    12,    40,    65,    41,    13,    14,    13,    14,   114,
+     115,   116,    42,   117,   118,   119,   120,   121,   122,   125,
+      19,    43,    20,    15,    54,    54,    54,    46,    21,    39,
+      71,    40,    27,    41,    54,    72,    13,    14,    88,    89,
+      90,    42,    26,    71,    73,    28,    30,    91,    86,   139,
+      76,   141,    22,    92,    93,    94,    95,    96,    97,    88,
+      89,    90,    29,    35,    98,   147,    88,    89,    90,    38,
+      56,    99,    70,    74,    92,    93,    94,    95,    96,    97,
+      78,    92,    93,    94,    95,    96,    97,    88,    89,    90,
+      94,    95,    96,    97,    81,   112,    83,    80,   108,    88,
+      89,    90,    92,    93,    94,    95,    96,    97,   131,   105,
+     110,    88,    89,    90,    92,    93,    94,    95,    96,    97,
+     132,   109,   111,    88,    89,    90,    92,    93,    94,    95,
+      96,    97,   146,    13,    14,    31,   126,   113,    92,    93,
+      94,    95,    96,    97,    88,    89,    90,   127,   128,    22,
+     129,   136,   148,    88,    89,    90,   137,   138,   142,    92,
+      93,    94,    95,    96,    97,    88,    89,   143,    92,    93,
+      94,    95,    96,    97,    88,   144,   149,   145,     7,    18,
+      92,    93,    94,    95,    96,    97,    57,    34,   134,    92,
+      93,    94,    95,    96,    97
+};
+
+static const yytype_uint8 yycheck[] =
+{
+      39,    40,    41,    37,    37,    46,    10,     3,    28,     0,
+      28,   111,    46,    46,     4,     5,     6,    22,    34,    35,
+      98,    99,    61,    62,    20,    29,    65,    20,    18,   129,
+     108,    36,    22,    37,    73,    74,    70,    28,    28,    29,
+       7,    21,     9,    33,    11,    12,    13,    12,    13,    88,
+      89,    90,    19,    92,    93,    94,    95,    96,    97,   100,
+      22,    28,    28,    28,    98,    99,   100,   100,    21,     7,
+      22,     9,    23,    11,   108,    27,    12,    13,    15,    16,
+      17,    19,    24,    22,    36,    28,    26,    24,    27,   128,
+      28,   130,    28,    30,    31,    32,    33,    34,    35,    15,
+      16,    17,    25,    20,    20,   144,    15,    16,    17,    21,
+      28,    20,    20,     8,    30,    31,    32,    33,    34,    35,
+      10,    30,    31,    32,    33,    34,    35,    15,    16,    17,
+      32,    33,    34,    35,    28,    23,    28,    24,    20,    15,
+      16,    17,    30,    31,    32,    33,    34,    35,    24,    28,
+      24,    15,    16,    17,    30,    31,    32,    33,    34,    35,
+      24,    26,    22,    15,    16,    17,    30,    31,    32,    33,
+      34,    35,    24,    12,    13,    14,    21,    28,    30,    31,
+      32,    33,    34,    35,    15,    16,    17,    23,    26,    28,
+      22,    21,    23,    15,    16,    17,    21,    11,    21,    30,
+      31,    32,    33,    34,    35,    15,    16,    23,    30,    31,
+      32,    33,    34,    35,    15,    22,    24,    23,     2,    11,
+      30,    31,    32,    33,    34,    35,    38,    30,   109,    30,
+      31,    32,    33,    34,    35
+};
+
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
+{
+       0,    28,    38,    39,     3,    20,     0,    39,    28,    40,
+      41,    20,    21,    12,    13,    28,    42,    65,    40,    22,
+      28,    21,    28,    43,    44,    65,    24,    23,    28,    25,
+      26,    14,    65,    66,    44,    20,    45,    46,    21,     7,
+       9,    11,    19,    28,    47,    49,    50,    51,    52,    53,
+      54,    56,    57,    59,    62,    65,    28,    42,     4,     5,
+       6,    18,    22,    28,    29,    33,    61,    62,    61,    61,
+      20,    22,    27,    36,     8,    60,    28,    49,    10,    55,
+      24,    28,    48,    28,    61,    61,    27,    61,    15,    16,
+      17,    24,    30,    31,    32,    33,    34,    35,    20,    20,
+      50,    58,    61,    63,    64,    28,    61,    61,    20,    26,
+      24,    22,    23,    28,    61,    61,    61,    61,    61,    61,
+      61,    61,    61,    58,    58,    49,    21,    23,    26,    22,
+      36,    24,    24,    58,    48,    63,    21,    21,    11,    61,
+      63,    61,    21,    23,    22,    23,    24,    61,    23,    24
+};
+
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
+{
+       0,    37,    38,    38,    39,    39,    40,    41,    41,    42,
+      42,    43,    43,    44,    44,    45,    46,    46,    47,    48,
+      48,    49,    49,    50,    50,    50,    50,    50,    50,    51,
+      51,    52,    53,    53,    54,    55,    56,    57,    58,    59,
+      60,    60,    61,    61,    61,    61,    61,    61,    61,    61,
+      61,    61,    61,    61,    61,    61,    61,    61,    61,    61,
+      61,    61,    62,    62,    63,    63,    64,    64,    65,    65,
+      65,    66,    66
+};
+
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     1,     2,     4,     6,     2,     4,     0,    10,
+       0,     1,     0,     2,     4,     3,     2,     0,     3,     3,
+       1,     2,     0,     1,     1,     1,     1,     1,     1,     4,
+       6,     2,     1,     2,     5,     4,     5,     9,     2,     3,
+       3,     0,     3,     3,     3,     3,     3,     3,     3,     3,
+       3,     2,     2,     1,     3,     1,     3,     1,     1,     1,
+       2,     5,     4,     6,     1,     0,     3,     1,     1,     1,
+       1,     1,     1
+};
+
+
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (scanner, state, YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
+
+
+/* Enable debugging if requested.  */
+#if YYDEBUG
+
+# ifndef YYFPRINTF
+#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYFPRINTF fprintf
+# endif
+
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value, scanner, state); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
+static void
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, yyscan_t scanner, ParseState* state)
+{
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (scanner);
+  YY_USE (state);
+  if (!yyvaluep)
+    return;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
+
+static void
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, yyscan_t scanner, ParseState* state)
+{
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
+
+  yy_symbol_value_print (yyo, yykind, yyvaluep, scanner, state);
+  YYFPRINTF (yyo, ")");
+}
+
+/*------------------------------------------------------------------.
+| yy_stack_print -- Print the state stack from its BOTTOM up to its |
+| TOP (included).                                                   |
+`------------------------------------------------------------------*/
+
+static void
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
+{
+  YYFPRINTF (stderr, "Stack now");
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
+  YYFPRINTF (stderr, "\n");
+}
+
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
+
+
+/*------------------------------------------------.
+| Report that the YYRULE is going to be reduced.  |
+`------------------------------------------------*/
+
+static void
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule, yyscan_t scanner, ParseState* state)
+{
+  int yylno = yyrline[yyrule];
+  int yynrhs = yyr2[yyrule];
+  int yyi;
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
+  /* The symbols being reduced.  */
+  for (yyi = 0; yyi < yynrhs; yyi++)
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)], scanner, state);
+      YYFPRINTF (stderr, "\n");
+    }
+}
+
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule, scanner, state); \
+} while (0)
+
+/* Nonzero means print parse trace.  It is left uninitialized so that
+   multiple parsers can coexist.  */
+int yydebug;
+#else /* !YYDEBUG */
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
+# define YY_STACK_PRINT(Bottom, Top)
+# define YY_REDUCE_PRINT(Rule)
+#endif /* !YYDEBUG */
+
+
+/* YYINITDEPTH -- initial size of the parser's stacks.  */
+#ifndef YYINITDEPTH
+# define YYINITDEPTH 200
+#endif
+
+/* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
+   if the built-in stack extension method is used).
+
+   Do not make this value too large; the results are undefined if
+   YYSTACK_ALLOC_MAXIMUM < YYSTACK_BYTES (YYMAXDEPTH)
+   evaluated with infinite-precision integer arithmetic.  */
+
+#ifndef YYMAXDEPTH
+# define YYMAXDEPTH 10000
+#endif
+
+
+/* Context of a parse error.  */
+typedef struct
+{
+  yy_state_t *yyssp;
+  yysymbol_kind_t yytoken;
+} yypcontext_t;
+
+/* Put in YYARG at most YYARGN of the expected tokens given the
+   current YYCTX, and return the number of tokens stored in YYARG.  If
+   YYARG is null, return the number of expected tokens (guaranteed to
+   be less than YYNTOKENS).  Return YYENOMEM on memory exhaustion.
+   Return 0 if there are more than YYARGN expected tokens, yet fill
+   YYARG up to YYARGN. */
+static int
+yypcontext_expected_tokens (const yypcontext_t *yyctx,
+                            yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  int yyn = yypact[+*yyctx->yyssp];
+  if (!yypact_value_is_default (yyn))
+    {
+      /* Start YYX at -YYN if negative to avoid negative indexes in
+         YYCHECK.  In other words, skip the first -YYN actions for
+         this state because they are default actions.  */
+      int yyxbegin = yyn < 0 ? -yyn : 0;
+      /* Stay within bounds of both yycheck and yytname.  */
+      int yychecklim = YYLAST - yyn + 1;
+      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
+      int yyx;
+      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
+        if (yycheck[yyx + yyn] == yyx && yyx != YYSYMBOL_YYerror
+            && !yytable_value_is_error (yytable[yyx + yyn]))
+          {
+            if (!yyarg)
+              ++yycount;
+            else if (yycount == yyargn)
+              return 0;
+            else
+              yyarg[yycount++] = YY_CAST (yysymbol_kind_t, yyx);
+          }
+    }
+  if (yyarg && yycount == 0 && 0 < yyargn)
+    yyarg[0] = YYSYMBOL_YYEMPTY;
+  return yycount;
+}
+
+
+
+
+#ifndef yystrlen
+# if defined __GLIBC__ && defined _STRING_H
+#  define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
+# else
+/* Return the length of YYSTR.  */
+static YYPTRDIFF_T
+yystrlen (const char *yystr)
+{
+  YYPTRDIFF_T yylen;
+  for (yylen = 0; yystr[yylen]; yylen++)
+    continue;
+  return yylen;
+}
+# endif
+#endif
+
+#ifndef yystpcpy
+# if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
+#  define yystpcpy stpcpy
+# else
+/* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
+   YYDEST.  */
+static char *
+yystpcpy (char *yydest, const char *yysrc)
+{
+  char *yyd = yydest;
+  const char *yys = yysrc;
+
+  while ((*yyd++ = *yys++) != '\0')
+    continue;
+
+  return yyd - 1;
+}
+# endif
+#endif
+
+#ifndef yytnamerr
+/* Copy to YYRES the contents of YYSTR after stripping away unnecessary
+   quotes and backslashes, so that it's suitable for yyerror.  The
+   heuristic is that double-quoting is unnecessary unless the string
+   contains an apostrophe, a comma, or backslash (other than
+   backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
+   null, do not copy; instead, return the length of what the result
+   would have been.  */
+static YYPTRDIFF_T
+yytnamerr (char *yyres, const char *yystr)
+{
+  if (*yystr == '"')
+    {
+      YYPTRDIFF_T yyn = 0;
+      char const *yyp = yystr;
+      for (;;)
+        switch (*++yyp)
+          {
+          case '\'':
+          case ',':
+            goto do_not_strip_quotes;
+
+          case '\\':
+            if (*++yyp != '\\')
+              goto do_not_strip_quotes;
+            else
+              goto append;
+
+          append:
+          default:
+            if (yyres)
+              yyres[yyn] = *yyp;
+            yyn++;
+            break;
+
+          case '"':
+            if (yyres)
+              yyres[yyn] = '\0';
+            return yyn;
+          }
+    do_not_strip_quotes: ;
+    }
+
+  if (yyres)
+    return yystpcpy (yyres, yystr) - yyres;
+  else
+    return yystrlen (yystr);
+}
+#endif
+
+
+static int
+yy_syntax_error_arguments (const yypcontext_t *yyctx,
+                           yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  /* There are many possibilities here to consider:
+     - If this state is a consistent state with a default action, then
+       the only way this function was invoked is if the default action
+       is an error action.  In that case, don't check for expected
+       tokens because there are none.
+     - The only way there can be no lookahead present (in yychar) is if
+       this state is a consistent state with a default action.  Thus,
+       detecting the absence of a lookahead is sufficient to determine
+       that there is no unexpected or expected token to report.  In that
+       case, just report a simple "syntax error".
+     - Don't assume there isn't a lookahead just because this state is a
+       consistent state with a default action.  There might have been a
+       previous inconsistent state, consistent state with a non-default
+       action, or user semantic action that manipulated yychar.
+     - Of course, the expected token list depends on states to have
+       correct lookahead information, and it depends on the parser not
+       to perform extra reductions after fetching a lookahead from the
+       scanner and before detecting a syntax error.  Thus, state merging
+       (from LALR or IELR) and default reductions corrupt the expected
+       token list.  However, the list is correct for canonical LR with
+       one exception: it will still contain any token that will not be
+       accepted due to an error action in a later state.
+  */
+  if (yyctx->yytoken != YYSYMBOL_YYEMPTY)
+    {
+      int yyn;
+      if (yyarg)
+        yyarg[yycount] = yyctx->yytoken;
+      ++yycount;
+      yyn = yypcontext_expected_tokens (yyctx,
+                                        yyarg ? yyarg + 1 : yyarg, yyargn - 1);
+      if (yyn == YYENOMEM)
+        return YYENOMEM;
+      else
+        yycount += yyn;
+    }
+  return yycount;
+}
+
+/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
+   about the unexpected token YYTOKEN for the state stack whose top is
+   YYSSP.
+
+   Return 0 if *YYMSG was successfully written.  Return -1 if *YYMSG is
+   not large enough to hold the message.  In that case, also set
+   *YYMSG_ALLOC to the required number of bytes.  Return YYENOMEM if the
+   required number of bytes is too large to store.  */
+static int
+yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
+                const yypcontext_t *yyctx)
+{
+  enum { YYARGS_MAX = 5 };
+  /* Internationalized format string. */
+  const char *yyformat = YY_NULLPTR;
+  /* Arguments of yyformat: reported tokens (one for the "unexpected",
+     one per "expected"). */
+  yysymbol_kind_t yyarg[YYARGS_MAX];
+  /* Cumulated lengths of YYARG.  */
+  YYPTRDIFF_T yysize = 0;
+
+  /* Actual size of YYARG. */
+  int yycount = yy_syntax_error_arguments (yyctx, yyarg, YYARGS_MAX);
+  if (yycount == YYENOMEM)
+    return YYENOMEM;
+
+  switch (yycount)
+    {
+#define YYCASE_(N, S)                       \
+      case N:                               \
+        yyformat = S;                       \
+        break
+    default: /* Avoid compiler warnings. */
+      YYCASE_(0, YY_("syntax error"));
+      YYCASE_(1, YY_("syntax error, unexpected %s"));
+      YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
+      YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
+      YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
+      YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
+#undef YYCASE_
+    }
+
+  /* Compute error message size.  Don't count the "%s"s, but reserve
+     room for the terminator.  */
+  yysize = yystrlen (yyformat) - 2 * yycount + 1;
+  {
+    int yyi;
+    for (yyi = 0; yyi < yycount; ++yyi)
+      {
+        YYPTRDIFF_T yysize1
+          = yysize + yytnamerr (YY_NULLPTR, yytname[yyarg[yyi]]);
+        if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
+          yysize = yysize1;
+        else
+          return YYENOMEM;
+      }
+  }
+
+  if (*yymsg_alloc < yysize)
+    {
+      *yymsg_alloc = 2 * yysize;
+      if (! (yysize <= *yymsg_alloc
+             && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
+        *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
+      return -1;
+    }
+
+  /* Avoid sprintf, as that infringes on the user's name space.
+     Don't have undefined behavior even if the translation
+     produced a string with the wrong number of "%s"s.  */
+  {
+    char *yyp = *yymsg;
+    int yyi = 0;
+    while ((*yyp = *yyformat) != '\0')
+      if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
+        {
+          yyp += yytnamerr (yyp, yytname[yyarg[yyi++]]);
+          yyformat += 2;
+        }
+      else
+        {
+          ++yyp;
+          ++yyformat;
+        }
+  }
+  return 0;
+}
+
+
+/*-----------------------------------------------.
+| Release the memory associated to this symbol.  |
+`-----------------------------------------------*/
+
+static void
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, yyscan_t scanner, ParseState* state)
+{
+  YY_USE (yyvaluep);
+  YY_USE (scanner);
+  YY_USE (state);
+  if (!yymsg)
+    yymsg = "Deleting";
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+
+
+
+
+/*----------.
+| yyparse.  |
+`----------*/
+
+int
+yyparse (yyscan_t scanner, ParseState* state)
+{
+/* Lookahead token kind.  */
+int yychar;
+
+
+/* The semantic value of the lookahead symbol.  */
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
+
+    /* Number of syntax errors so far.  */
+    int yynerrs = 0;
+
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
+
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
+
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
+
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
+
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
+  /* The variables used to return semantic value and location from the
+     action routines.  */
+  YYSTYPE yyval;
+
+  /* Buffer for error messages, and its allocated size.  */
+  char yymsgbuf[128];
+  char *yymsg = yymsgbuf;
+  YYPTRDIFF_T yymsg_alloc = sizeof yymsgbuf;
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+
+  /* The number of symbols on the RHS of the reduced rule.
+     Keep to zero when no symbol should be popped.  */
+  int yylen = 0;
+
+  YYDPRINTF ((stderr, "Starting parse\n"));
+
+  yychar = YYEMPTY; /* Cause a token to be read.  */
+
+  goto yysetstate;
+
+
+/*------------------------------------------------------------.
+| yynewstate -- push a new state, which is found in yystate.  |
+`------------------------------------------------------------*/
+yynewstate:
+  /* In all cases, when you get here, the value and location stacks
+     have just been pushed.  So pushing a state here evens the stacks.  */
+  yyssp++;
+
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
+
+  if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
+    {
+      /* Get the current used size of the three stacks, in elements.  */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
+
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+      }
+# else /* defined YYSTACK_RELOCATE */
+      /* Extend the stack our own way.  */
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
+      yystacksize *= 2;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
+
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+#  undef YYSTACK_RELOCATE
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
+# endif
+
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
+
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
+
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
+    }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
+
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
+
+  goto yybackup;
+
+
+/*-----------.
+| yybackup.  |
+`-----------*/
+yybackup:
+  /* Do appropriate processing given the current state.  Read a
+     lookahead token if we need one and don't already have one.  */
+
+  /* First try to decide what to do without reference to lookahead token.  */
+  yyn = yypact[yystate];
+  if (yypact_value_is_default (yyn))
+    goto yydefault;
+
+  /* Not known => get a lookahead token if don't already have one.  */
+
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
+  if (yychar == YYEMPTY)
+    {
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex (&yylval, scanner);
+    }
+
+  if (yychar <= YYEOF)
+    {
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
+    }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
+  else
+    {
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
+    }
+
+  /* If the proper action on seeing token YYTOKEN is to reduce or to
+     detect an error, take that action.  */
+  yyn += yytoken;
+  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
+    goto yydefault;
+  yyn = yytable[yyn];
+  if (yyn <= 0)
+    {
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
+      yyn = -yyn;
+      goto yyreduce;
+    }
+
+  /* Count tokens shifted since error; after three, turn off error
+     status.  */
+  if (yyerrstatus)
+    yyerrstatus--;
+
+  /* Shift the lookahead token.  */
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
+  yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
+  goto yynewstate;
+
+
+/*-----------------------------------------------------------.
+| yydefault -- do the default action for the current state.  |
+`-----------------------------------------------------------*/
+yydefault:
+  yyn = yydefact[yystate];
+  if (yyn == 0)
+    goto yyerrlab;
+  goto yyreduce;
+
+
+/*-----------------------------.
+| yyreduce -- do a reduction.  |
+`-----------------------------*/
+yyreduce:
+  /* yyn is the number of a rule to reduce with.  */
+  yylen = yyr2[yyn];
+
+  /* If YYLEN is nonzero, implement the default value of the action:
+     '$$ = $1'.
+
+     Otherwise, the following line sets YYVAL to garbage.
+     This behavior is undocumented and Bison
+     users should not rely upon it.  Assigning to YYVAL
+     unconditionally makes the parser a bit smaller, and it avoids a
+     GCC warning that YYVAL may be used uninitialized.  */
+  yyval = yyvsp[1-yylen];
+
+
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
+    {
+  case 2: /* Program: Class  */
+#line 92 "parser.y"
+                { 
+		(yyval.program_ptr) = new ProgramNode(new std::list<ClassNode*>());
+		state->root = (yyval.program_ptr);
+		if (state->onClass) { state->onClass((yyvsp[0].class_ptr)); }
+		else { (yyval.program_ptr)->class_list->push_back((yyvsp[0].class_ptr)); }
+		}
+#line 1546 "parser.cpp"
+    break;
+
+  case 3: /* Program: Program Class  */
+#line 99 "parser.y"
+                {
+		(yyval.program_ptr) = (yyvsp[-1].program_ptr);
+		if (state->onClass) { state->onClass((yyvsp[0].class_ptr)); }
+		else { (yyval.program_ptr)->class_list->push_back((yyvsp[0].class_ptr)); }
+		}
+#line 1556 "parser.cpp"
+    break;
+
+  case 4: /* Class: T_ID T_LBRACKET ClassBody T_RBRACKET  */
+#line 108 "parser.y"
+                { (yyval.class_ptr) = (yyvsp[-1].class_ptr); (yyval.class_ptr)->identifier_1 = (yyvsp[-3].identifier_ptr); (yyval.class_ptr)->identifier_2 = NULL; }
+#line 1562 "parser.cpp"
+    break;
+
+  case 5: /* Class: T_ID T_EXTENDS T_ID T_LBRACKET ClassBody T_RBRACKET  */
+#line 110 "parser.y"
+                { (yyval.class_ptr) = (yyvsp[-1].class_ptr); (yyval.class_ptr)->identifier_1 = (yyvsp[-5].identifier_ptr); (yyval.class_ptr)->identifier_2 = (yyvsp[-3].identifier_ptr); }
+#line 1568 "parser.cpp"
+    break;
+
+  case 6: /* ClassBody: Members Methods  */
+#line 114 "parser.y"
+                { (yyval.class_ptr) = new ClassNode(NULL, NULL, (yyvsp[-1].declaration_list_ptr), (yyvsp[0].method_list_ptr)); }
+#line 1574 "parser.cpp"
+    break;
+
+  case 7: /* Members: Members Type T_ID T_SEMICOLON  */
+#line 118 "parser.y"
+                { 
+		(yyval.declaration_list_ptr) = (yyvsp[-3].declaration_list_ptr); 
+		std::list<IdentifierNode*>* id = new std::list<IdentifierNode*>();
+		id->push_front((yyvsp[-1].identifier_ptr));
+		(yyval.declaration_list_ptr)->push_back(new DeclarationNode((yyvsp[-2].type_ptr), id)); 
+		}
+#line 1585 "parser.cpp"
+    break;
+
+  case 8: /* Members: %empty  */
+#line 125 "parser.y"
+                { (yyval.declaration_list_ptr) = new std::list<DeclarationNode*>(); }
+#line 1591 "parser.cpp"
+    break;
+
+  case 9: /* Methods: T_ID T_LPAREN Parameters T_RPAREN T_ARROW ReturnType T_LBRACKET Body T_RBRACKET Methods  */
+#line 129 "parser.y"
+                {
+		(yyval.method_list_ptr) = (yyvsp[0].method_list_ptr);
+		(yyval.method_list_ptr)->push_front(new MethodNode((yyvsp[-9].identifier_ptr), (yyvsp[-7].parameter_list_ptr), (yyvsp[-4].type_ptr), (yyvsp[-2].methodbody_ptr)));
+		(yyval.method_list_ptr)->front()->lineno = (yyvsp[-9].identifier_ptr)->lineno;
+		}
+#line 1601 "parser.cpp"
+    break;
+
+  case 10: /* Methods: %empty  */
+#line 135 "parser.y"
+                { (yyval.method_list_ptr) = new std::list<MethodNode*>(); }
+#line 1607 "parser.cpp"
+    break;
+
+  case 11: /* Parameters: Parameters2  */
+#line 139 "parser.y"
+                { (yyval.parameter_list_ptr) = (yyvsp[0].parameter_list_ptr); }
+#line 1613 "parser.cpp"
+    break;
+
+  case 12: /* Parameters: %empty  */
+#line 141 "parser.y"
+                { (yyval.parameter_list_ptr) = NULL; }
+#line 1619 "parser.cpp"
+    break;
+
+  case 13: /* Parameters2: Type T_ID  */
+#line 145 "parser.y"
+                { (yyval.parameter_list_ptr) = new std::list<ParameterNode*>(); (yyval.parameter_list_ptr)->push_front(new ParameterNode((yyvsp[-1].type_ptr), (yyvsp[0].identifier_ptr))); }
+#line 1625 "parser.cpp"
+    break;
+
+  case 14: /* Parameters2: Type T_ID T_COMMA Parameters2  */
+#line 147 "parser.y"
+                { (yyval.parameter_list_ptr) = (yyvsp[0].parameter_list_ptr); (yyval.parameter_list_ptr)->push_front(new ParameterNode((yyvsp[-3].type_ptr), (yyvsp[-2].identifier_ptr))); }
+#line 1631 "parser.cpp"
+    break;
+
+  case 15: /* Body: Declarations Statements Return  */
+#line 151 "parser.y"
+                { (yyval.methodbody_ptr) = new MethodBodyNode((yyvsp[-2].declaration_list_ptr), (yyvsp[-1].statement_list_ptr), (yyvsp[0].returnstatement_ptr)); }
+#line 1637 "parser.cpp"
+    break;
+
+  case 16: /* Declarations: Declarations Declaration  */
+#line 155 "parser.y"
+                { (yyval.declaration_list_ptr) = (yyvsp[-1].declaration_list_ptr); (yyval.declaration_list_ptr)->push_back((yyvsp[0].declaration_ptr)); }
+#line 1643 "parser.cpp"
+    break;
+
+  case 17: /* Declarations: %empty  */
+#line 157 "parser.y"
+                { (yyval.declaration_list_ptr) = new std::list<DeclarationNode*>(); }
+#line 1649 "parser.cpp"
+    break;
+
+  case 18: /* Declaration: Type VarName T_SEMICOLON  */
+#line 161 "parser.y"
+                { (yyval.declaration_ptr) = new DeclarationNode((yyvsp[-2].type_ptr), (yyvsp[-1].identifier_list_ptr)); }
+#line 1655 "parser.cpp"
+    break;
+
+  case 19: /* VarName: T_ID T_COMMA VarName  */
+#line 165 "parser.y"
+                { (yyval.identifier_list_ptr) = (yyvsp[0].identifier_list_ptr); (yyval.identifier_list_ptr)->push_front((yyvsp[-2].identifier_ptr)); }
+#line 1661 "parser.cpp"
+    break;
+
+  case 20: /* VarName: T_ID  */
+#line 167 "parser.y"
+                { (yyval.identifier_list_ptr) = new std::list<IdentifierNode*>(); (yyval.identifier_list_ptr)->push_front((yyvsp[0].identifier_ptr)); }
+#line 1667 "parser.cpp"
+    break;
+
+  case 21: /* Statements: Statement Statements  */
+#line 171 "parser.y"
+                {
+		if ((yyvsp[0].statement_list_ptr) != NULL) { (yyval.statement_list_ptr) = (yyvsp[0].statement_list_ptr); }
+		else { (yyval.statement_list_ptr) = new std::list<StatementNode*>(); }
+		(yyval.statement_list_ptr)->push_front((yyvsp[-1].statement_ptr));
+		}
+#line 1677 "parser.cpp"
+    break;
+
+  case 22: /* Statements: %empty  */
+#line 177 "parser.y"
+                { (yyval.statement_list_ptr) = NULL; }
+#line 1683 "parser.cpp"
+    break;
+
+  case 23: /* Statement: Assignment  */
+#line 181 "parser.y"
+                { (yyval.statement_ptr) = (yyvsp[0].assignment_ptr); }
+#line 1689 "parser.cpp"
+    break;
+
+  case 24: /* Statement: MethodCallStatement  */
+#line 183 "parser.y"
+                { (yyval.statement_ptr) = (yyvsp[0].call_ptr); }
+#line 1695 "parser.cpp"
+    break;
+
+  case 25: /* Statement: IfElse  */
+#line 185 "parser.y"
+                { (yyval.statement_ptr) = (yyvsp[0].ifelse_ptr); }
+#line 1701 "parser.cpp"
+    break;
+
+  case 26: /* Statement: While  */
+#line 187 "parser.y"
+                { (yyval.statement_ptr) = (yyvsp[0].while_ptr); }
+#line 1707 "parser.cpp"
+    break;
+
+  case 27: /* Statement: DoWhile  */
+#line 189 "parser.y"
+                { (yyval.statement_ptr) = (yyvsp[0].dowhile_ptr); }
+#line 1713 "parser.cpp"
+    break;
+
+  case 28: /* Statement: Print  */
+#line 191 "parser.y"
+                { (yyval.statement_ptr) = (yyvsp[0].print_ptr); }
+#line 1719 "parser.cpp"
+    break;
+
+  case 29: /* Assignment: T_ID T_ASSEQUALS Expression T_SEMICOLON  */
+#line 195 "parser.y"
+                { (yyval.assignment_ptr) = new AssignmentNode((yyvsp[-3].identifier_ptr), NULL, (yyvsp[-1].expression_ptr)); }
+#line 1725 "parser.cpp"
+    break;
+
+  case 30: /* Assignment: T_ID T_DOT T_ID T_ASSEQUALS Expression T_SEMICOLON  */
+#line 197 "parser.y"
+                { (yyval.assignment_ptr) = new AssignmentNode((yyvsp[-5].identifier_ptr), (yyvsp[-3].identifier_ptr), (yyvsp[-1].expression_ptr)); }
+#line 1731 "parser.cpp"
+    break;
+
+  case 31: /* MethodCallStatement: MethodCall T_SEMICOLON  */
+#line 201 "parser.y"
+                { (yyval.call_ptr) = new CallNode((yyvsp[-1].methodcall_ptr)); }
+#line 1737 "parser.cpp"
+    break;
+
+  case 32: /* IfElse: If  */
+#line 205 "parser.y"
+                { (yyval.ifelse_ptr) = (yyvsp[0].ifelse_ptr); }
+#line 1743 "parser.cpp"
+    break;
+
+  case 33: /* IfElse: If Else  */
+#line 207 "parser.y"
+                { (yyval.ifelse_ptr) = (yyvsp[-1].ifelse_ptr); (yyval.ifelse_ptr)->statement_list_2 = (yyvsp[0].statement_list_ptr); }
+#line 1749 "parser.cpp"
+    break;
+
+  case 34: /* If: T_IF Expression T_LBRACKET Block T_RBRACKET  */
+#line 211 "parser.y"
+                { (yyval.ifelse_ptr) = new IfElseNode((yyvsp[-3].expression_ptr), (yyvsp[-1].statement_list_ptr), NULL); (yyval.ifelse_ptr)->lineno = (yyvsp[-4].base_int); }
+#line 1755 "parser.cpp"
+    break;
+
+  case 35: /* Else: T_ELSE T_LBRACKET Block T_RBRACKET  */
+#line 215 "parser.y"
+                { (yyval.statement_list_ptr) = (yyvsp[-1].statement_list_ptr); }
+#line 1761 "parser.cpp"
+    break;
+
+  case 36: /* While: T_WHILE Expression T_LBRACKET Block T_RBRACKET  */
+#line 219 "parser.y"
+                { (yyval.while_ptr) = new WhileNode((yyvsp[-3].expression_ptr), (yyvsp[-1].statement_list_ptr)); (yyval.while_ptr)->lineno = (yyvsp[-4].base_int); }
+#line 1767 "parser.cpp"
+    break;
+
+  case 37: /* DoWhile: T_DO T_LBRACKET Block T_RBRACKET T_WHILE T_LPAREN Expression T_RPAREN T_SEMICOLON  */
+#line 223 "parser.y"
+                { (yyval.dowhile_ptr) = new DoWhileNode((yyvsp[-6].statement_list_ptr), (yyvsp[-2].expression_ptr)); (yyval.dowhile_ptr)->lineno = (yyvsp[-8].base_int); }
+#line 1773 "parser.cpp"
+    break;
+
+  case 38: /* Block: Statement Statements  */
+#line 227 "parser.y"
+                {
+		if ((yyvsp[0].statement_list_ptr) != NULL) { (yyval.statement_list_ptr) = (yyvsp[0].statement_list_ptr); }
+		else { (yyval.statement_list_ptr) = new std::list<StatementNode*>(); }
+		(yyval.statement_list_ptr)->push_front((yyvsp[-1].statement_ptr));
+		}
+#line 1783 "parser.cpp"
+    break;
+
+  case 39: /* Print: T_PRINT Expression T_SEMICOLON  */
+#line 235 "parser.y"
+                { (yyval.print_ptr) = new PrintNode((yyvsp[-1].expression_ptr)); }
+#line 1789 "parser.cpp"
+    break;
+
+  case 40: /* Return: T_RETURN Expression T_SEMICOLON  */
+#line 239 "parser.y"
+                { (yyval.returnstatement_ptr) = new ReturnStatementNode((yyvsp[-1].expression_ptr)); }
+#line 1795 "parser.cpp"
+    break;
+
+  case 41: /* Return: %empty  */
+#line 241 "parser.y"
+                { (yyval.returnstatement_ptr) = NULL; }
+#line 1801 "parser.cpp"
+    break;
+
+  case 42: /* Expression: Expression T_PLUS Expression  */
+#line 245 "parser.y"
+                { (yyval.expression_ptr) = new PlusNode((yyvsp[-2].expression_ptr), (yyvsp[0].expression_ptr)); }
+#line 1807 "parser.cpp"
+    break;
+
+  case 43: /* Expression: Expression T_MINUS Expression  */
+#line 247 "parser.y"
+                { (yyval.expression_ptr) = new MinusNode((yyvsp[-2].expression_ptr), (yyvsp[0].expression_ptr)); }
+#line 1813 "parser.cpp"
+    break;
+
+  case 44: /* Expression: Expression T_TIMES Expression  */
+#line 249 "parser.y"
+                { (yyval.expression_ptr) = new TimesNode((yyvsp[-2].expression_ptr), (yyvsp[0].expression_ptr)); }
+#line 1819 "parser.cpp"
+    break;
+
+  case 45: /* Expression: Expression T_DIVIDE Expression  */
+#line 251 "parser.y"
+                { (yyval.expression_ptr) = new DivideNode((yyvsp[-2].expression_ptr), (yyvsp[0].expression_ptr)); }
+#line 1825 "parser.cpp"
+    break;
+
+  case 46: /* Expression: Expression T_GTHAN Expression  */
+#line 253 "parser.y"
+                { (yyval.expression_ptr) = new GreaterNode((yyvsp[-2].expression_ptr), (yyvsp[0].expression_ptr)); }
+#line 1831 "parser.cpp"
+    break;
+
+  case 47: /* Expression: Expression T_GTHANE Expression  */
+#line 255 "parser.y"
+                { (yyval.expression_ptr) = new GreaterEqualNode((yyvsp[-2].expression_ptr), (yyvsp[0].expression_ptr)); }
+#line 1837 "parser.cpp"
+    break;
+
+  case 48: /* Expression: Expression T_EQUALS Expression  */
+#line 257 "parser.y"
+                { (yyval.expression_ptr) = new EqualNode((yyvsp[-2].expression_ptr), (yyvsp[0].expression_ptr)); }
+#line 1843 "parser.cpp"
+    break;
+
+  case 49: /* Expression: Expression T_AND Expression  */
+#line 259 "parser.y"
+                { (yyval.expression_ptr) = new AndNode((yyvsp[-2].expression_ptr), (yyvsp[0].expression_ptr)); }
+#line 1849 "parser.cpp"
+    break;
+
+  case 50: /* Expression: Expression T_OR Expression  */
+#line 261 "parser.y"
+                { (yyval.expression_ptr) = new OrNode((yyvsp[-2].expression_ptr), (yyvsp[0].expression_ptr)); }
+#line 1855 "parser.cpp"
+    break;
+
+  case 51: /* Expression: T_NOT Expression  */
+#line 263 "parser.y"
+                { (yyval.expression_ptr) = new NotNode((yyvsp[0].expression_ptr)); }
+#line 1861 "parser.cpp"
+    break;
+
+  case 52: /* Expression: T_MINUS Expression  */
+#line 265 "parser.y"
+                { (yyval.expression_ptr) = new NegationNode((yyvsp[0].expression_ptr)); }
+#line 1867 "parser.cpp"
+    break;
+
+  case 53: /* Expression: T_ID  */
+#line 267 "parser.y"
+                { (yyval.expression_ptr) = new VariableNode((yyvsp[0].identifier_ptr)); }
+#line 1873 "parser.cpp"
+    break;
+
+  case 54: /* Expression: T_ID T_DOT T_ID  */
+#line 269 "parser.y"
+                { (yyval.expression_ptr) = new MemberAccessNode((yyvsp[-2].identifier_ptr), (yyvsp[0].identifier_ptr)); }
+#line 1879 "parser.cpp"
+    break;
+
+  case 55: /* Expression: MethodCall  */
+#line 271 "parser.y"
+                { (yyval.expression_ptr) = (yyvsp[0].methodcall_ptr); }
+#line 1885 "parser.cpp"
+    break;
+
+  case 56: /* Expression: T_LPAREN Expression T_RPAREN  */
+#line 273 "parser.y"
+                { (yyval.expression_ptr) = (yyvsp[-1].expression_ptr); }
+#line 1891 "parser.cpp"
+    break;
+
+  case 57: /* Expression: T_NUMBER  */
+#line 275 "parser.y"
+                { (yyval.expression_ptr) = new IntegerLiteralNode(new IntegerNode((yyvsp[0].base_int))); }
+#line 1897 "parser.cpp"
+    break;
+
+  case 58: /* Expression: T_TRUE  */
+#line 277 "parser.y"
+                { (yyval.expression_ptr) = new BooleanLiteralNode(new IntegerNode(1)); }
+#line 1903 "parser.cpp"
+    break;
+
+  case 59: /* Expression: T_FALSE  */
+#line 279 "parser.y"
+                { (yyval.expression_ptr) = new BooleanLiteralNode(new IntegerNode(0)); }
+#line 1909 "parser.cpp"
+    break;
+
+  case 60: /* Expression: T_NEW T_ID  */
+#line 281 "parser.y"
+                { (yyval.expression_ptr) = new NewNode((yyvsp[0].identifier_ptr), NULL); }
+#line 1915 "parser.cpp"
+    break;
+
+  case 61: /* Expression: T_NEW T_ID T_LPAREN Arguments T_RPAREN  */
+#line 283 "parser.y"
+                { (yyval.expression_ptr) = new NewNode((yyvsp[-3].identifier_ptr), (yyvsp[-1].expression_list_ptr)); }
+#line 1921 "parser.cpp"
+    break;
+
+  case 62: /* MethodCall: T_ID T_LPAREN Arguments T_RPAREN  */
+#line 287 "parser.y"
+                { (yyval.methodcall_ptr) = new MethodCallNode((yyvsp[-3].identifier_ptr), NULL, (yyvsp[-1].expression_list_ptr)); }
+#line 1927 "parser.cpp"
+    break;
+
+  case 63: /* MethodCall: T_ID T_DOT T_ID T_LPAREN Arguments T_RPAREN  */
+#line 289 "parser.y"
+                { (yyval.methodcall_ptr) = new MethodCallNode((yyvsp[-5].identifier_ptr), (yyvsp[-3].identifier_ptr), (yyvsp[-1].expression_list_ptr)); }
+#line 1933 "parser.cpp"
+    break;
+
+  case 64: /* Arguments: Arguments2  */
+#line 293 "parser.y"
+                { (yyval.expression_list_ptr) = (yyvsp[0].expression_list_ptr); }
+#line 1939 "parser.cpp"
+    break;
+
+  case 65: /* Arguments: %empty  */
+#line 295 "parser.y"
+                { (yyval.expression_list_ptr) = NULL; }
+#line 1945 "parser.cpp"
+    break;
+
+  case 66: /* Arguments2: Arguments2 T_COMMA Expression  */
+#line 299 "parser.y"
+                { (yyval.expression_list_ptr) = (yyvsp[-2].expression_list_ptr); (yyval.expression_list_ptr)->push_back((yyvsp[0].expression_ptr)); }
+#line 1951 "parser.cpp"
+    break;
+
+  case 67: /* Arguments2: Expression  */
+#line 301 "parser.y"
+                { (yyval.expression_list_ptr) = new std::list<ExpressionNode*>(); (yyval.expression_list_ptr)->push_back((yyvsp[0].expression_ptr)); }
+#line 1957 "parser.cpp"
+    break;
+
+  case 68: /* Type: T_INTEGER  */
+#line 306 "parser.y"
+                { (yyval.type_ptr) = new IntegerTypeNode(); }
+#line 1963 "parser.cpp"
+    break;
+
+  case 69: /* Type: T_BOOLEAN  */
+#line 308 "parser.y"
+                { (yyval.type_ptr) = new BooleanTypeNode(); }
+#line 1969 "parser.cpp"
+    break;
+
+  case 70: /* Type: T_ID  */
+#line 310 "parser.y"
+                { (yyval.type_ptr) = new ObjectTypeNode((yyvsp[0].identifier_ptr)); }
+#line 1975 "parser.cpp"
+    break;
+
+  case 71: /* ReturnType: Type  */
+#line 314 "parser.y"
+                { (yyval.type_ptr) = (yyvsp[0].type_ptr); }
+#line 1981 "parser.cpp"
+    break;
+
+  case 72: /* ReturnType: T_NONE  */
+#line 316 "parser.y"
+                { (yyval.type_ptr) = new NoneNode(); }
+#line 1987 "parser.cpp"
+    break;
+
+
+#line 1991 "parser.cpp"
+
+      default: break;
+    }
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
+
+  YYPOPSTACK (yylen);
+  yylen = 0;
+
+  *++yyvsp = yyval;
+
+  /* Now 'shift' the result of the reduction.  Determine what state
+     that goes to, based on the state we popped back to and the rule
+     number reduced by.  */
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
+
+  goto yynewstate;
+
+
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
+yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
+  /* If not already recovering from an error, report this error.  */
+  if (!yyerrstatus)
+    {
+      ++yynerrs;
+      {
+        yypcontext_t yyctx
+          = {yyssp, yytoken};
+        char const *yymsgp = YY_("syntax error");
+        int yysyntax_error_status;
+        yysyntax_error_status = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+        if (yysyntax_error_status == 0)
+          yymsgp = yymsg;
+        else if (yysyntax_error_status == -1)
+          {
+            if (yymsg != yymsgbuf)
+              YYSTACK_FREE (yymsg);
+            yymsg = YY_CAST (char *,
+                             YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
+            if (yymsg)
+              {
+                yysyntax_error_status
+                  = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+                yymsgp = yymsg;
+              }
+            else
+              {
+                yymsg = yymsgbuf;
+                yymsg_alloc = sizeof yymsgbuf;
+                yysyntax_error_status = YYENOMEM;
+              }
+          }
+        yyerror (scanner, state, yymsgp);
+        if (yysyntax_error_status == YYENOMEM)
+          YYNOMEM;
+      }
+    }
+
+  if (yyerrstatus == 3)
+    {
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
+
+      if (yychar <= YYEOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
+      else
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval, scanner, state);
+          yychar = YYEMPTY;
+        }
+    }
+
+  /* Else will try to reuse lookahead token after shifting the error
+     token.  */
+  goto yyerrlab1;
+
+
+/*---------------------------------------------------.
+| yyerrorlab -- error raised explicitly by YYERROR.  |
+`---------------------------------------------------*/
+yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
+
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYERROR.  */
+  YYPOPSTACK (yylen);
+  yylen = 0;
+  YY_STACK_PRINT (yyss, yyssp);
+  yystate = *yyssp;
+  goto yyerrlab1;
+
+
+/*-------------------------------------------------------------.
+| yyerrlab1 -- common code for both syntax error and YYERROR.  |
+`-------------------------------------------------------------*/
+yyerrlab1:
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
+
+  /* Pop stack until we find a state that shifts the error token.  */
+  for (;;)
+    {
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
+
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
+
+
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, scanner, state);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
+    }
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+
+  /* Shift the error token.  */
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
+
+  yystate = yyn;
+  goto yynewstate;
+
+
+/*-------------------------------------.
+| yyacceptlab -- YYACCEPT comes here.  |
+`-------------------------------------*/
+yyacceptlab:
+  yyresult = 0;
+  goto yyreturnlab;
+
+
+/*-----------------------------------.
+| yyabortlab -- YYABORT comes here.  |
+`-----------------------------------*/
+yyabortlab:
+  yyresult = 1;
+  goto yyreturnlab;
+
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
+yyexhaustedlab:
+  yyerror (scanner, state, YY_("memory exhausted"));
+  yyresult = 2;
+  goto yyreturnlab;
+
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval, scanner, state);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYABORT or YYACCEPT.  */
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
+  while (yyssp != yyss)
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, scanner, state);
+      YYPOPSTACK (1);
+    }
+#ifndef yyoverflow
+  if (yyss != yyssa)
+    YYSTACK_FREE (yyss);
+#endif
+  if (yymsg != yymsgbuf)
+    YYSTACK_FREE (yymsg);
+  return yyresult;
+}
+
+#line 319 "parser.y"
+
+
+int yyget_lineno(yyscan_t scanner);
+
+// Records a syntax error. Only the first error is kept: after the
+// lexer reports an invalid character it ends the input, and the
+// parser's complaint about the early end of file is not useful.
+void yyerror(yyscan_t scanner, ParseState* state, const char *s) {
+  if (state->errors.empty()) {
+    state->errors.push_back(std::string(s) + " at line " + std::to_string(yyget_lineno(scanner)));
+  }
+}
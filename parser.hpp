@@ -0,0 +1,114 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison interface for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_PARSER_HPP_INCLUDED
+# define YY_YY_PARSER_HPP_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+/* "%code requires" blocks.  */
+#line 1 "parser.y"
+
+    #include "compiler.hpp"
+
+    #ifndef YY_TYPEDEF_YY_SCANNER_T
+    #define YY_TYPEDEF_YY_SCANNER_T
+    typedef void* yyscan_t;
+    #endif
+
+#line 58 "parser.hpp"
+
+/* Token kinds.  */
+#ifndef YYTOKENTYPE
+# define YYTOKENTYPE
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    T_EXTENDS = 258,               /* T_EXTENDS  */
+    T_TRUE = 259,                  /* T_TRUE  */
+    T_FALSE = 260,                 /* T_FALSE  */
+    T_NEW = 261,                   /* T_NEW  */
+    T_PRINT = 262,                 /* T_PRINT  */
+    T_RETURN = 263,                /* T_RETURN  */
+    T_IF = 264,                    /* T_IF  */
+    T_ELSE = 265,                  /* T_ELSE  */
+    T_WHILE = 266,                 /* T_WHILE  */
+    T_INTEGER = 267,               /* T_INTEGER  */
+    T_BOOLEAN = 268,               /* T_BOOLEAN  */
+    T_NONE = 269,                  /* T_NONE  */
+    T_EQUALS = 270,                /* T_EQUALS  */
+    T_AND = 271,                   /* T_AND  */
+    T_OR = 272,                    /* T_OR  */
+    T_NOT = 273,                   /* T_NOT  */
+    T_DO = 274,                    /* T_DO  */
+    T_LBRACKET = 275,              /* T_LBRACKET  */
+    T_RBRACKET = 276,              /* T_RBRACKET  */
+    T_LPAREN = 277,                /* T_LPAREN  */
+    T_RPAREN = 278,                /* T_RPAREN  */
+    T_SEMICOLON = 279,             /* T_SEMICOLON  */
+    T_ARROW = 280,                 /* T_ARROW  */
+    T_COMMA = 281,                 /* T_COMMA  */
+    T_DOT = 282,                   /* T_DOT  */
+    T_ID = 283,                    /* T_ID  */
+    T_NUMBER = 284,                /* T_NUMBER  */
+    T_GTHANE = 285,                /* T_GTHANE  */
+    T_GTHAN = 286,                 /* T_GTHAN  */
+    T_PLUS = 287,                  /* T_PLUS  */
+    T_MINUS = 288,                 /* T_MINUS  */
+    T_TIMES = 289,                 /* T_TIMES  */
+    T_DIVIDE = 290,                /* T_DIVIDE  */
+    T_ASSEQUALS = 291              /* T_ASSEQUALS  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
+#endif
+
+/* Value type.  */
+
+
+
+
+int yyparse (yyscan_t scanner, ParseState* state);
+
+
+#endif /* !YY_YY_PARSER_HPP_INCLUDED  */
@@ -1,3 +1,12 @@
+%code requires {
+    #include "compiler.hpp"
+
+    #ifndef YY_TYPEDEF_YY_SCANNER_T
+    #define YY_TYPEDEF_YY_SCANNER_T
+    typedef void* yyscan_t;
+    #endif
+}
+
 %{
     #include <cstdlib>
     #include <cstdio>
@@ -7,12 +16,25 @@
 
     #define YYDEBUG 1
     #define YYINITDEPTH 10000
-    int yylex(void);
-    void yyerror(const char *);
-
-    extern ASTNode* astRoot;
 %}
 
+%code {
+    /* Methods and Statements are right recursive, so the parser stack
+       grows with the number of methods in a class and statements in a
+       block. The stack starts at YYINITDEPTH and is reallocated as it
+       grows (see YYSTYPE_IS_TRIVIAL in ast.hpp) up to this limit */
+    #define YYMAXDEPTH 10000000
+
+    int yylex(YYSTYPE* yylval, yyscan_t scanner);
+    void yyerror(yyscan_t scanner, ParseState* state, const char *);
+}
+
+/* The parser is reentrant: the scanner and the ParseState (which
+   receives the program and any syntax errors) are passed to yyparse */
+%define api.pure full
+%lex-param { yyscan_t scanner }
+%parse-param { yyscan_t scanner } { ParseState* state }
+
 %error-verbose
 
 /* WRITEME: List all your tokens here */
@@ -56,7 +78,7 @@
 %type <methodcall_ptr> MethodCall 
 %type <expression_list_ptr> Arguments Arguments2
 %type <identifier_ptr> T_ID
-%type <base_int> T_NUMBER
+%type <base_int> T_NUMBER T_IF T_WHILE T_DO
 %type <type_ptr> Type ReturnType
 
 
@@ -64,14 +86,21 @@
 
 /* WRITME: Write your Bison grammar specification here */
 
+/* Program is left recursive so that each class is reduced (and, when
+   streaming, handed to state->onClass) as soon as its closing bracket is read */
 Program : Class
 		{ 
 		$$ = new ProgramNode(new std::list<ClassNode*>());
-		$$->class_list->push_front($1);
-		astRoot = $$;
+		state->root = $$;
+		if (state->onClass) { state->onClass($1); }
+		else { $$->class_list->push_back($1); }
+		}
+	| Program Class
+		{
+		$$ = $1;
+		if (state->onClass) { state->onClass($2); }
+		else { $$->class_list->push_back($2); }
 		}
-	| Class Program
-		{ $$ = $2; $$->class_list->push_front($1); }
 	;
 	
 
@@ -97,7 +126,11 @@ Members : Members Type T_ID T_SEMICOLON
 	;
 
 Methods : T_ID T_LPAREN Parameters T_RPAREN T_ARROW ReturnType T_LBRACKET Body T_RBRACKET Methods
-		{ $$ = $10; $$->push_front(new MethodNode($1, $3, $6, $8)); }
+		{
+		$$ = $10;
+		$$->push_front(new MethodNode($1, $3, $6, $8));
+		$$->front()->lineno = $1->lineno;
+		}
 	| %empty
 		{ $$ = new std::list<MethodNode*>(); }
 	;
@@ -175,7 +208,7 @@ IfElse : If
 	;
 
 If : T_IF Expression T_LBRACKET Block T_RBRACKET
-		{ $$ = new IfElseNode($2, $4, NULL); }
+		{ $$ = new IfElseNode($2, $4, NULL); $$->lineno = $1; }
 	;
 
 Else : T_ELSE T_LBRACKET Block T_RBRACKET
@@ -183,11 +216,11 @@ Else : T_ELSE T_LBRACKET Block T_RBRACKET
 	;
 
 While : T_WHILE Expression T_LBRACKET Block T_RBRACKET
-		{ $$ = new WhileNode($2, $4); }
+		{ $$ = new WhileNode($2, $4); $$->lineno = $1; }
 	;
 
 DoWhile : T_DO T_LBRACKET Block T_RBRACKET T_WHILE T_LPAREN Expression T_RPAREN T_SEMICOLON
-		{ $$ = new DoWhileNode($3, $7); }
+		{ $$ = new DoWhileNode($3, $7); $$->lineno = $1; }
 	;
 
 Block : Statement Statements
@@ -285,9 +318,13 @@ ReturnType : Type
 
 %%
 
-extern int yylineno;
+int yyget_lineno(yyscan_t scanner);
 
-void yyerror(const char *s) {
-  fprintf(stderr, "%s at line %d\n", s, yylineno);
-  exit(0);
+// Records a syntax error. Only the first error is kept: after the
+// lexer reports an invalid character it ends the input, and the
+// parser's complaint about the early end of file is not useful.
+void yyerror(yyscan_t scanner, ParseState* state, const char *s) {
+  if (state->errors.empty()) {
+    state->errors.push_back(std::string(s) + " at line " + std::to_string(yyget_lineno(scanner)));
+  }
 }
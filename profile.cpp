@@ -0,0 +1,61 @@
+#include "profile.hpp"
+
+#include <fstream>
+#include <sstream>
+
+static const char* kindNames[] = { "method", "loop", "then", "else" };
+
+const char* profileCounterKindName(ProfileCounterKind kind) {
+  return kindNames[kind];
+}
+
+static std::string blockKey(const std::string& method, int line, const std::string& kind) {
+  return method + " " + std::to_string(line) + " " + kind;
+}
+
+long long ProfileData::methodCount(const std::string& method) const {
+  std::map<std::string, long long>::const_iterator it = methods.find(method);
+  return it == methods.end() ? -1 : it->second;
+}
+
+long long ProfileData::blockCount(const std::string& method, int line, ProfileCounterKind kind) const {
+  std::map<std::string, long long>::const_iterator it = blocks.find(blockKey(method, line, kindNames[kind]));
+  return it == blocks.end() ? -1 : it->second;
+}
+
+bool readProfile(const std::string& path, ProfileData& profile, std::vector<std::string>& warnings) {
+  std::ifstream in(path.c_str());
+  if (!in) {
+    return false;
+  }
+  std::ostringstream buffer;
+  buffer << in.rdbuf();
+  profile.text = buffer.str();
+
+  std::istringstream lines(profile.text);
+  std::string line;
+  for (int number = 1; std::getline(lines, line); number++) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    std::string method, kind;
+    int sourceLine;
+    long long count;
+    if (!(fields >> method >> sourceLine >> kind >> count) || count < 0) {
+      warnings.push_back(path + ":" + std::to_string(number) + ": invalid profile line");
+      continue;
+    }
+
+    // several counters on one line (or stale counters) are added up
+    if (kind == kindNames[pc_method]) {
+      profile.methods[method] += count;
+    } else {
+      profile.blocks[blockKey(method, sourceLine, kind)] += count;
+    }
+    if (count > profile.hottest) {
+      profile.hottest = count;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,51 @@
+#ifndef __PROFILE_HPP
+#define __PROFILE_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+
+// This file defines execution profiles: the counts written by
+// programs compiled with --profile (see tester.c), which a later
+// compilation reads back with --use-profile to guide its
+// optimizations (see CodeGenerator).
+//
+// A profile has one line for every counter:
+//   Class_method <tab> line <tab> kind <tab> count <tab> cycles
+// Counters are matched by the Class_method name and, for blocks, by
+// their source line and kind. A profile of an older version of the
+// program is still usable: counters that no longer match anything are
+// ignored, and code without a matching counter is compiled as it
+// would be without a profile.
+
+// The kinds of profile counters: the calls of a method, the
+// iterations of a loop, and the two arms of an if.
+enum ProfileCounterKind { pc_method, pc_loop, pc_then, pc_else };
+
+// Returns the name of a kind of counter as written in profiles.
+const char* profileCounterKindName(ProfileCounterKind kind);
+
+// Defines a profile read from a file.
+struct ProfileData {
+  // The number of calls of every method, by Class_method name
+  std::map<std::string, long long> methods;
+  // The count of every block, by Class_method name, line and kind
+  std::map<std::string, long long> blocks;
+  // The largest count in the profile
+  long long hottest;
+  // The contents of the file (part of the cache key of a compilation)
+  std::string text;
+
+  ProfileData() : hottest(0) {}
+
+  // These return the count of a method or block, or -1 if the
+  // profile has no count for it.
+  long long methodCount(const std::string& method) const;
+  long long blockCount(const std::string& method, int line, ProfileCounterKind kind) const;
+};
+
+// Reads a profile. Returns false if the file cannot be read; lines
+// that cannot be parsed are skipped with a warning.
+bool readProfile(const std::string& path, ProfileData& profile, std::vector<std::string>& warnings);
+
+#endif
@@ -1,6 +1,6 @@
 from subprocess import Popen, PIPE
 from os import listdir, path, remove
-from sys import platform
+from sys import platform, argv
 from functools import total_ordering
 
 @total_ordering
@@ -19,7 +19,9 @@ class NameOrder(object):
 		else:
 			return int(firstNumber) < int(secondNumber)
 
-def runTests():
+# The arguments of runtests.py are passed on to lang, so the tests can
+# be run under other code generation options (see make diffmodes).
+def runTests(options):
 	if (not path.isdir("tests/")):
 		print("No tests directory.")
 		return
@@ -36,7 +38,7 @@ def runTests():
 		outfile = open(asm, 'w')
 
 		print("./lang < " + f + ":")
-		p = Popen(["./lang"], stdin=infile, stdout=outfile, stderr=PIPE)
+		p = Popen(["./lang"] + options, stdin=infile, stdout=outfile, stderr=PIPE)
 		(out, err) = p.communicate()
 
 		try:
@@ -76,7 +78,7 @@ def runTests():
 			print("Invalid characters in output.\n")
 
 def main():
-	runTests()
+	runTests(argv[1:])
 
 if __name__ == "__main__":
 	main()
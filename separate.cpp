@@ -0,0 +1,319 @@
+#include "separate.hpp"
+#include "cache.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+static const char* interfaceHeader = "lang-interface 1";
+
+// Defines one source file being compiled. A unit can be compiled
+// once every unit it depends on has written its interface file.
+struct Unit {
+  std::string path;
+  // the path without its extension, used to name the output files
+  std::string base;
+  ProgramNode* program;
+  std::vector<std::string> errors;
+  std::vector<size_t> dependencies;
+  std::vector<size_t> dependents;
+  int waiting;
+  bool failed;
+
+  Unit() : program(NULL), waiting(0), failed(false) {}
+};
+
+static std::string extension(const std::string& path) {
+  size_t dot = path.rfind('.');
+  if (dot == std::string::npos || path.find('/', dot) != std::string::npos) {
+    return "";
+  }
+  return path.substr(dot);
+}
+
+static std::string withoutExtension(const std::string& path) {
+  return path.substr(0, path.size() - extension(path).size());
+}
+
+// Adds every class in an interface file to the class table.
+static bool readInterface(const std::string& path, ClassTable* classTable) {
+  std::ifstream in(path.c_str());
+  std::string header;
+  if (!std::getline(in, header) || header != interfaceHeader) {
+    return false;
+  }
+  while (in >> std::ws && !in.eof()) {
+    std::string name;
+    ClassInfo info;
+    if (!readClassInfo(in, name, info)) {
+      return false;
+    }
+    classTable->insert(std::pair<std::string, ClassInfo>(name, info));
+  }
+  return true;
+}
+
+// Reads the names of the classes in an interface file.
+static bool readInterfaceClasses(const std::string& path, std::vector<std::string>& names) {
+  ClassTable* classTable = new ClassTable();
+  bool ok = readInterface(path, classTable);
+  for (ClassTable::iterator it = classTable->begin(); it != classTable->end(); it++) {
+    names.push_back(it->first);
+  }
+  deleteClassTable(classTable);
+  return ok;
+}
+
+static void compileUnit(Unit& unit, const std::vector<std::string>& imports, const CompileOptions& options) {
+  TypeCheck typecheck;
+  typecheck.beginProgram();
+  std::list<ClassNode*>* classes = unit.program->class_list;
+
+  for (size_t i = 0; i < imports.size(); i++) {
+    if (!readInterface(imports[i], typecheck.classTable)) {
+      unit.errors.push_back(imports[i] + ": not a valid interface file");
+      deleteClassTable(typecheck.classTable);
+      return;
+    }
+  }
+
+  try {
+    for (std::list<ClassNode*>::iterator it = classes->begin(); it != classes->end(); it++) {
+      typecheck.visitClassNode(*it);
+    }
+  } catch (TypeErrorException& e) {
+    unit.errors.push_back(unit.path + ": " + typeErrorMessage(e.code));
+    deleteClassTable(typecheck.classTable);
+    return;
+  }
+
+  std::ofstream exports((unit.base + ".iface").c_str());
+  exports << interfaceHeader << std::endl;
+  for (std::list<ClassNode*>::iterator it = classes->begin(); it != classes->end(); it++) {
+    std::string name = (*it)->identifier_1->name;
+    writeClassInfo(exports, name, typecheck.classTable->at(name), false);
+  }
+  exports.close();
+
+  std::ofstream assembly((unit.base + ".s").c_str());
+  CodeGenerator codegen;
+  codegen.classTable = typecheck.classTable;
+  codegen.methodLabels = true;
+  codegen.exportMethods = true;
+  codegen.options = options.codegen;
+  codegen.out = &assembly;
+  codegen.genProgramPrologue();
+  for (std::list<ClassNode*>::iterator it = classes->begin(); it != classes->end(); it++) {
+    (*it)->accept(&codegen);
+  }
+  codegen.genProgramEpilogue();
+  assembly.close();
+
+  if (!exports || !assembly) {
+    unit.errors.push_back(unit.base + ".s: could not write the output files");
+  }
+  deleteClassTable(typecheck.classTable);
+}
+
+// Collects the interface files a unit imports: those of every unit
+// it depends on, directly or through another unit.
+static void collectImports(std::vector<Unit>& units, size_t unit, std::set<size_t>& visited, std::vector<std::string>& imports) {
+  for (size_t i = 0; i < units[unit].dependencies.size(); i++) {
+    size_t dependency = units[unit].dependencies[i];
+    if (visited.insert(dependency).second) {
+      imports.push_back(units[dependency].base + ".iface");
+      collectImports(units, dependency, visited, imports);
+    }
+  }
+}
+
+int compileFiles(const std::vector<std::string>& paths, const CompileOptions& options) {
+  std::vector<Unit> units;
+  std::vector<std::string> interfaces;
+  for (size_t i = 0; i < paths.size(); i++) {
+    if (extension(paths[i]) == ".iface") {
+      interfaces.push_back(paths[i]);
+    } else {
+      Unit unit;
+      unit.path = paths[i];
+      unit.base = withoutExtension(paths[i]);
+      units.push_back(unit);
+    }
+  }
+
+  // find the file that defines every class
+  std::map<std::string, std::string> definedIn;
+  std::map<std::string, size_t> definingUnit;
+  bool failed = false;
+  for (size_t i = 0; i < interfaces.size(); i++) {
+    std::vector<std::string> names;
+    if (!readInterfaceClasses(interfaces[i], names)) {
+      std::cerr << interfaces[i] << ": not a valid interface file" << std::endl;
+      failed = true;
+    }
+    for (size_t j = 0; j < names.size(); j++) {
+      definedIn[names[j]] = interfaces[i];
+    }
+  }
+
+  for (size_t i = 0; i < units.size(); i++) {
+    FILE* input = fopen(units[i].path.c_str(), "r");
+    if (!input) {
+      std::cerr << units[i].path << ": could not open the file" << std::endl;
+      failed = true;
+      continue;
+    }
+    std::vector<std::string> errors;
+    units[i].program = parseProgram(input, errors);
+    fclose(input);
+    for (size_t j = 0; j < errors.size(); j++) {
+      std::cerr << units[i].path << ": " << errors[j] << std::endl;
+    }
+    if (!units[i].program) {
+      failed = true;
+      continue;
+    }
+
+    std::list<ClassNode*>* classes = units[i].program->class_list;
+    for (std::list<ClassNode*>::iterator it = classes->begin(); it != classes->end(); it++) {
+      std::string name = (*it)->identifier_1->name;
+      if (definedIn.count(name)) {
+        std::cerr << units[i].path << ": class " << name << " is already defined in " << definedIn[name] << std::endl;
+        failed = true;
+      }
+      definedIn[name] = units[i].path;
+      definingUnit[name] = i;
+    }
+  }
+
+  if (failed) {
+    for (size_t i = 0; i < units.size(); i++) {
+      delete units[i].program;
+    }
+    return 1;
+  }
+
+  // a unit depends on the units that define the classes it uses
+  for (size_t i = 0; i < units.size(); i++) {
+    std::set<std::string> names;
+    std::list<ClassNode*>* classes = units[i].program->class_list;
+    for (std::list<ClassNode*>::iterator it = classes->begin(); it != classes->end(); it++) {
+      referencedClasses(*it, names);
+    }
+    std::set<size_t> dependencies;
+    for (std::set<std::string>::iterator it = names.begin(); it != names.end(); it++) {
+      if (definingUnit.count(*it) && definingUnit[*it] != i) {
+        dependencies.insert(definingUnit[*it]);
+      }
+    }
+    for (std::set<size_t>::iterator it = dependencies.begin(); it != dependencies.end(); it++) {
+      units[i].dependencies.push_back(*it);
+      units[*it].dependents.push_back(i);
+    }
+    units[i].waiting = units[i].dependencies.size();
+  }
+
+  // every unit must be reachable from the units without dependencies
+  std::vector<int> waiting(units.size());
+  std::deque<size_t> ready;
+  for (size_t i = 0; i < units.size(); i++) {
+    waiting[i] = units[i].waiting;
+    if (waiting[i] == 0) {
+      ready.push_back(i);
+    }
+  }
+  size_t ordered = 0;
+  for (; !ready.empty(); ready.pop_front(), ordered++) {
+    std::vector<size_t>& dependents = units[ready.front()].dependents;
+    for (size_t i = 0; i < dependents.size(); i++) {
+      if (--waiting[dependents[i]] == 0) {
+        ready.push_back(dependents[i]);
+      }
+    }
+  }
+  if (ordered != units.size()) {
+    std::cerr << "Circular dependency between files:";
+    for (size_t i = 0; i < units.size(); i++) {
+      if (waiting[i] > 0) {
+        std::cerr << " " << units[i].path;
+      }
+    }
+    std::cerr << std::endl;
+    for (size_t i = 0; i < units.size(); i++) {
+      delete units[i].program;
+    }
+    return 1;
+  }
+
+  // compile the units on a pool of threads, starting each one as
+  // soon as all of its dependencies are done
+  std::mutex mutex;
+  std::condition_variable changed;
+  size_t finished = 0;
+  for (size_t i = 0; i < units.size(); i++) {
+    if (units[i].waiting == 0) {
+      ready.push_back(i);
+    }
+  }
+
+  auto worker = [&]() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+      changed.wait(lock, [&]() { return !ready.empty() || finished == units.size(); });
+      if (ready.empty()) {
+        return;
+      }
+      size_t i = ready.front();
+      ready.pop_front();
+
+      bool skip = false;
+      for (size_t j = 0; j < units[i].dependencies.size(); j++) {
+        skip = skip || units[units[i].dependencies[j]].failed;
+      }
+      lock.unlock();
+
+      if (!skip) {
+        std::vector<std::string> imports = interfaces;
+        std::set<size_t> visited;
+        collectImports(units, i, visited, imports);
+        compileUnit(units[i], imports, options);
+      }
+
+      lock.lock();
+      units[i].failed = skip || !units[i].errors.empty();
+      finished++;
+      for (size_t j = 0; j < units[i].dependents.size(); j++) {
+        if (--units[units[i].dependents[j]].waiting == 0) {
+          ready.push_back(units[i].dependents[j]);
+        }
+      }
+      changed.notify_all();
+    }
+  };
+
+  int threads = options.jobs ? options.jobs : std::thread::hardware_concurrency();
+  std::vector<std::thread> pool;
+  for (int i = 1; i < threads && i < (int)units.size(); i++) {
+    pool.push_back(std::thread(worker));
+  }
+  worker();
+  for (size_t i = 0; i < pool.size(); i++) {
+    pool[i].join();
+  }
+
+  int status = 0;
+  for (size_t i = 0; i < units.size(); i++) {
+    for (size_t j = 0; j < units[i].errors.size(); j++) {
+      std::cerr << units[i].errors[j] << std::endl;
+    }
+    if (units[i].failed) {
+      status = 1;
+    }
+    delete units[i].program;
+  }
+  return status;
+}
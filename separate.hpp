@@ -0,0 +1,28 @@
+#ifndef __SEPARATE_HPP
+#define __SEPARATE_HPP
+
+#include "compiler.hpp"
+
+#include <string>
+#include <vector>
+
+// This file defines separate compilation. Every source file
+// (NAME.lang) is compiled to its own assembly file (NAME.s) and
+// exports an interface file (NAME.iface) holding the class table
+// entries of its classes: names, superclasses, member offsets and
+// method signatures. A file that uses classes from other files
+// imports their interface files instead of parsing them again.
+//
+// Interface files may also be given as inputs, to compile against
+// files that were compiled earlier. Files that do not depend on
+// each other are compiled in parallel on options.jobs threads (one
+// per core if jobs is 0). Every method is exported, so the
+// assembly files can be linked together; there is no check that
+// some file defines Main, since a missing Main_main is only an
+// error when the files are linked into a program.
+
+// Compiles the given source and interface files, reporting any
+// errors on std::cerr. Returns the exit status for the compiler.
+int compileFiles(const std::vector<std::string>& paths, const CompileOptions& options);
+
+#endif
@@ -0,0 +1,136 @@
+#include "server.hpp"
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Programs larger than this are rejected rather than buffered.
+static const size_t maxSourceSize = 64 * 1024 * 1024;
+
+// Defines the queue of accepted connections waiting for a worker.
+struct ConnectionQueue {
+  std::mutex mutex;
+  std::condition_variable ready;
+  std::deque<int> connections;
+};
+
+static bool readSource(int fd, std::string& source) {
+  char buffer[65536];
+  for (;;) {
+    ssize_t n = read(fd, buffer, sizeof(buffer));
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      return false;
+    }
+    if (n == 0) {
+      return true;
+    }
+    source.append(buffer, n);
+    if (source.size() > maxSourceSize) {
+      return false;
+    }
+  }
+}
+
+static void writeAll(int fd, const std::string& data) {
+  size_t written = 0;
+  while (written < data.size()) {
+    ssize_t n = write(fd, data.data() + written, data.size() - written);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return;
+    }
+    written += n;
+  }
+}
+
+static void serveConnection(int fd, const CompileOptions& options) {
+  std::string source;
+  std::string response;
+  if (!readSource(fd, source)) {
+    response = "ERROR\nCould not read the program.\n";
+  } else {
+    CompileResult result = compile(source, options);
+    if (result.errors.empty()) {
+      response = "OK\n" + result.assembly;
+    } else {
+      response = "ERROR\n";
+      for (size_t i = 0; i < result.errors.size(); i++) {
+        response += result.errors[i] + "\n";
+      }
+    }
+  }
+  writeAll(fd, response);
+  close(fd);
+}
+
+static void worker(ConnectionQueue* queue, const CompileOptions* options) {
+  for (;;) {
+    int fd;
+    {
+      std::unique_lock<std::mutex> lock(queue->mutex);
+      queue->ready.wait(lock, [queue]() { return !queue->connections.empty(); });
+      fd = queue->connections.front();
+      queue->connections.pop_front();
+    }
+    serveConnection(fd, *options);
+  }
+}
+
+int runServer(const std::string& socketPath, int workers, const CompileOptions& options) {
+  // a client that disconnects early must not kill the server
+  signal(SIGPIPE, SIG_IGN);
+
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (socketPath.size() >= sizeof(address.sun_path)) {
+    std::cerr << "Socket path is too long: " << socketPath << std::endl;
+    return 1;
+  }
+  strcpy(address.sun_path, socketPath.c_str());
+
+  int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listener < 0) {
+    std::cerr << "socket: " << strerror(errno) << std::endl;
+    return 1;
+  }
+  unlink(socketPath.c_str());
+  if (bind(listener, (struct sockaddr*)&address, sizeof(address)) < 0 || listen(listener, SOMAXCONN) < 0) {
+    std::cerr << socketPath << ": " << strerror(errno) << std::endl;
+    close(listener);
+    return 1;
+  }
+
+  ConnectionQueue queue;
+  std::vector<std::thread> pool;
+  for (int i = 0; i < workers; i++) {
+    pool.push_back(std::thread(worker, &queue, &options));
+  }
+
+  for (;;) {
+    int fd = accept(listener, NULL, NULL);
+    if (fd < 0) {
+      if (errno != EINTR && errno != ECONNABORTED) {
+        std::cerr << "accept: " << strerror(errno) << std::endl;
+      }
+      continue;
+    }
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.connections.push_back(fd);
+    queue.ready.notify_one();
+  }
+}
@@ -0,0 +1,22 @@
+#ifndef __SERVER_HPP
+#define __SERVER_HPP
+
+#include "compiler.hpp"
+
+#include <string>
+
+// This file defines the compile server, which keeps the compiler
+// loaded and compiles programs sent to it over a Unix domain socket.
+//
+// The protocol is one compilation per connection: the client writes
+// the program source and shuts down its side of the connection for
+// writing; the server answers with a status line, "OK" or "ERROR",
+// followed by the generated assembly or by the error messages (one
+// per line), and closes the connection.
+
+// Listens on the socket at the given path (replacing any stale
+// socket file) and serves compilations on a pool of worker threads.
+// Only returns if the socket cannot be set up.
+int runServer(const std::string& socketPath, int workers, const CompileOptions& options);
+
+#endif
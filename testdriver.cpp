@@ -0,0 +1,296 @@
+// langtest: the parallel test driver.
+//
+// Usage: langtest [-j N] [--output] [--expected FILE] [--link COMMAND]
+//                 [--timeout SECONDS] [TEST...]
+//
+// Compiles every tests/*.lang (or the tests given) in this process
+// with the compiler library, then assembles, links and runs the
+// programs on N threads (one per core by default). Every test works
+// in its own temporary directory, so tests never share files.
+//
+// Without --output, the output of every test is compared with its
+// entry in output.txt (ignoring blank lines, as compare.py does),
+// the differences are shown, and the exit status is 1 if any test
+// failed. With --output, the output is printed exactly as
+// runtests.py prints it instead.
+//
+// The link command is run by the shell with %s replaced by the
+// assembly file and %o by the program to create; the default is
+// gcc -m32 with tester.c, as in runtests.py.
+
+#include "compiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Defines one test: its file and the output it produced, in the
+// format of runtests.py (without the header line).
+struct Test {
+  std::string path;
+  std::string output;
+};
+
+// Orders tests as runtests.py does: good tests before bad tests,
+// then by number.
+static bool testOrder(const std::string& a, const std::string& b) {
+  std::string nameA = a.substr(a.rfind('/') + 1);
+  std::string nameB = b.substr(b.rfind('/') + 1);
+  std::string endingA = nameA.substr(nameA.find('.') + 1);
+  std::string endingB = nameB.substr(nameB.find('.') + 1);
+  if (endingA != endingB) {
+    return endingA > endingB;
+  }
+  return atoi(nameA.c_str()) < atoi(nameB.c_str());
+}
+
+static bool readFile(const std::string& path, std::string& contents) {
+  std::ifstream in(path.c_str(), std::ios::binary);
+  if (!in) {
+    return false;
+  }
+  std::ostringstream buffer;
+  buffer << in.rdbuf();
+  contents = buffer.str();
+  return true;
+}
+
+static std::string replaceAll(std::string text, const std::string& from, const std::string& to) {
+  for (size_t i = text.find(from); i != std::string::npos; i = text.find(from, i + to.size())) {
+    text.replace(i, from.size(), to);
+  }
+  return text;
+}
+
+// Runs a command and returns its exit status. If output is given,
+// it receives the command's standard output; the command is killed
+// after timeout seconds.
+static int run(const std::string& command, std::string* output, int timeout) {
+  int pipeFds[2];
+  if (output && pipe(pipeFds) < 0) {
+    return -1;
+  }
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    return -1;
+  }
+  if (pid == 0) {
+    int devnull = open("/dev/null", O_RDWR);
+    dup2(devnull, 0);
+    dup2(output ? pipeFds[1] : devnull, 1);
+    dup2(devnull, 2);
+    if (output) {
+      close(pipeFds[0]);
+      close(pipeFds[1]);
+    }
+    alarm(timeout);
+    execl("/bin/sh", "sh", "-c", command.c_str(), (char*)NULL);
+    _exit(127);
+  }
+
+  if (output) {
+    close(pipeFds[1]);
+    char buffer[4096];
+    ssize_t n;
+    while ((n = read(pipeFds[0], buffer, sizeof(buffer))) != 0) {
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n < 0) {
+        break;
+      }
+      output->append(buffer, n);
+    }
+    close(pipeFds[0]);
+  }
+
+  int status;
+  while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+  }
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+static void runTest(Test& test, const std::string& linkCommand, int timeout) {
+  std::string source;
+  if (!readFile(test.path, source)) {
+    test.output = "Could not read the test.\n";
+    return;
+  }
+
+  CompileResult result = compile(source);
+  if (!result.errors.empty()) {
+    for (size_t i = 0; i < result.errors.size(); i++) {
+      test.output += result.errors[i] + "\n";
+    }
+    return;
+  }
+
+  char directory[] = "/tmp/langtest-XXXXXX";
+  if (!mkdtemp(directory)) {
+    test.output = "Could not create a temporary directory.\n";
+    return;
+  }
+  std::string assembly = std::string(directory) + "/test.s";
+  std::string program = std::string(directory) + "/test";
+  std::ofstream(assembly.c_str()) << result.assembly;
+
+  std::string command = replaceAll(replaceAll(linkCommand, "%s", assembly), "%o", program);
+  std::string output;
+  if (run(command, NULL, timeout) != 0) {
+    test.output = "Assembling and linking failed.\n\n";
+  } else if (run(program, &output, timeout) != 0) {
+    test.output = "Exited with an error.\n\n";
+  } else {
+    test.output = "Output:\n" + output + "\n";
+  }
+
+  // the link command may have left other files behind
+  run("rm -rf " + std::string(directory), NULL, timeout);
+}
+
+// Splits runtests.py output into the lines of every test, skipping
+// blank lines and "Output:" lines like compare.py.
+static std::map<std::string, std::vector<std::string> > splitOutput(const std::string& text) {
+  std::map<std::string, std::vector<std::string> > tests;
+  std::vector<std::string>* current = NULL;
+  std::istringstream in(text);
+  std::string line;
+  while (std::getline(in, line)) {
+    size_t first = line.find_first_not_of(" \t\r");
+    size_t last = line.find_last_not_of(" \t\r");
+    line = first == std::string::npos ? "" : line.substr(first, last - first + 1);
+    if (line.compare(0, 9, "./lang < ") == 0 && line[line.size() - 1] == ':') {
+      current = &tests[line.substr(9, line.size() - 10)];
+    } else if (current && !line.empty() && line != "Output:") {
+      current->push_back(line);
+    }
+  }
+  return tests;
+}
+
+static void printDifference(const std::vector<std::string>& expected, const std::vector<std::string>& actual) {
+  size_t common = 0;
+  while (common < expected.size() && common < actual.size() && expected[common] == actual[common]) {
+    common++;
+  }
+  std::cout << "  first difference at output line " << common + 1 << std::endl;
+  for (size_t i = common; i < expected.size() && i < common + 5; i++) {
+    std::cout << "  - " << expected[i] << std::endl;
+  }
+  for (size_t i = common; i < actual.size() && i < common + 5; i++) {
+    std::cout << "  + " << actual[i] << std::endl;
+  }
+}
+
+int main(int argc, char** argv) {
+  int jobs = std::thread::hardware_concurrency();
+  int timeout = 10;
+  bool printOutput = false;
+  std::string expectedPath = "output.txt";
+#ifdef __APPLE__
+  std::string linkCommand = "gcc -Wl,-no_pie -m32 -o %o tester.c %s";
+#else
+  std::string linkCommand = "gcc -m32 -o %o tester.c %s";
+#endif
+  std::vector<std::string> paths;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-j") && i + 1 < argc) {
+      jobs = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--output")) {
+      printOutput = true;
+    } else if (!strcmp(argv[i], "--expected") && i + 1 < argc) {
+      expectedPath = argv[++i];
+    } else if (!strcmp(argv[i], "--link") && i + 1 < argc) {
+      linkCommand = argv[++i];
+    } else if (!strcmp(argv[i], "--timeout") && i + 1 < argc) {
+      timeout = atoi(argv[++i]);
+    } else if (argv[i][0] != '-') {
+      paths.push_back(argv[i]);
+    } else {
+      std::cerr << "Unknown option: " << argv[i] << std::endl;
+      return 2;
+    }
+  }
+
+  if (paths.empty()) {
+    DIR* dir = opendir("tests");
+    if (!dir) {
+      std::cout << "No tests directory." << std::endl;
+      return 2;
+    }
+    for (struct dirent* entry = readdir(dir); entry; entry = readdir(dir)) {
+      std::string name = entry->d_name;
+      if (name.size() > 5 && name.compare(name.size() - 5, 5, ".lang") == 0) {
+        paths.push_back("tests/" + name);
+      }
+    }
+    closedir(dir);
+  }
+  std::sort(paths.begin(), paths.end(), testOrder);
+
+  std::vector<Test> tests(paths.size());
+  for (size_t i = 0; i < paths.size(); i++) {
+    tests[i].path = paths[i];
+  }
+
+  std::atomic<size_t> next(0);
+  auto worker = [&]() {
+    for (size_t i = next++; i < tests.size(); i = next++) {
+      runTest(tests[i], linkCommand, timeout);
+    }
+  };
+  std::vector<std::thread> pool;
+  for (int i = 1; i < jobs && i < (int)tests.size(); i++) {
+    pool.push_back(std::thread(worker));
+  }
+  worker();
+  for (size_t i = 0; i < pool.size(); i++) {
+    pool[i].join();
+  }
+
+  std::ostringstream all;
+  for (size_t i = 0; i < tests.size(); i++) {
+    all << "./lang < " << tests[i].path << ":" << std::endl << tests[i].output;
+  }
+  if (printOutput) {
+    std::cout << all.str();
+    return 0;
+  }
+
+  std::string expectedText;
+  if (!readFile(expectedPath, expectedText)) {
+    std::cout << "Could not read " << expectedPath << "." << std::endl;
+    return 2;
+  }
+  std::map<std::string, std::vector<std::string> > expected = splitOutput(expectedText);
+  std::map<std::string, std::vector<std::string> > actual = splitOutput(all.str());
+
+  int passed = 0;
+  for (size_t i = 0; i < tests.size(); i++) {
+    if (!expected.count(tests[i].path)) {
+      std::cout << tests[i].path << ": no expected output" << std::endl;
+    } else if (expected[tests[i].path] != actual[tests[i].path]) {
+      std::cout << tests[i].path << ": FAILED" << std::endl;
+      printDifference(expected[tests[i].path], actual[tests[i].path]);
+    } else {
+      passed++;
+    }
+  }
+  std::cout << passed << "/" << tests.size() << " tests passed." << std::endl;
+  return passed == (int)tests.size() ? 0 : 1;
+}
@@ -1,9 +1,301 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 int Main_main();
 
+// Objects created with new are allocated by gc_alloc and freed by a
+// mark-sweep collector. The collector is precise: the compiler emits
+// a descriptor for every class (with the offsets of its members that
+// hold objects) and a stack map for every call (the frame slots holding
+// objects when the call is made, by return address), so only real
+// object pointers are followed. Those may still point to objects the
+// compiler allocated in a frame (see escape.hpp), which have no header
+// here, so every value is checked against the set of allocated objects
+// before it is followed.
+//
+// A collection runs when the bytes allocated since the last one reach
+// the live bytes after it (or GC_MIN_HEAP), so the heap stays within
+// about twice the live data. Set LANG_GC_STATS to print the number
+// of collections and their pause times at exit.
+
+#define GC_MIN_HEAP (1 << 20)
+
+// The descriptor of a class (see CodeGenerator::genClassDescriptor):
+// the size of its objects, its pointer map (pointers[0] is the number
+// of member offsets that follow) and its vtable.
+struct GcClass {
+  int size;
+  int* pointers;
+  void* methods[];
+};
+
+// The header in front of every object. The compiled code finds the
+// vtable through type, so it must be the last word.
+struct GcObject {
+  struct GcObject* next;
+  int marked;
+  struct GcClass* type;
+};
+
+// A stack map (see CodeGenerator::genStackMap): offsets[0] is the
+// number of frame offsets that follow
+struct GcStackMap {
+  void* returnAddress;
+  int* offsets;
+};
+
+#ifndef __APPLE__
+extern struct GcStackMap __start_lang_stackmaps[] __attribute__((weak));
+extern struct GcStackMap __stop_lang_stackmaps[] __attribute__((weak));
+#endif
+
+static struct GcObject* gcObjects;
+static long gcAllocated;
+static long gcThreshold = GC_MIN_HEAP;
+static long gcLive;
+
+// The set of allocated objects (open addressing, at most half full)
+static struct GcObject** gcTable;
+static unsigned long gcTableSize;
+static unsigned long gcTableCount;
+
+// Objects marked but not yet scanned
+static struct GcObject** gcMarkStack;
+static unsigned long gcMarkStackSize;
+static unsigned long gcMarkStackCount;
+
+static int gcCollections;
+static double gcTotalPause;
+static double gcMaxPause;
+static long gcFreedObjects;
+static long gcPeakHeap;
+
+static unsigned long gcHash(struct GcObject* object) {
+  return ((unsigned long)object >> 2) * 2654435761u;
+}
+
+static void gcInsert(struct GcObject* object) {
+  unsigned long i;
+  if (2 * (gcTableCount + 1) > gcTableSize) {
+    struct GcObject** old = gcTable;
+    unsigned long oldSize = gcTableSize;
+    gcTableSize = gcTableSize ? 2 * gcTableSize : 1024;
+    gcTable = calloc(gcTableSize, sizeof(struct GcObject*));
+    gcTableCount = 0;
+    for (i = 0; i < oldSize; i++) {
+      if (old[i]) {
+        gcInsert(old[i]);
+      }
+    }
+    free(old);
+  }
+  for (i = gcHash(object) & (gcTableSize - 1); gcTable[i]; i = (i + 1) & (gcTableSize - 1)) {
+  }
+  gcTable[i] = object;
+  gcTableCount++;
+}
+
+static int gcContains(struct GcObject* object) {
+  unsigned long i;
+  if (!gcTableSize) {
+    return 0;
+  }
+  for (i = gcHash(object) & (gcTableSize - 1); gcTable[i]; i = (i + 1) & (gcTableSize - 1)) {
+    if (gcTable[i] == object) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static void gcMark(void* value) {
+  struct GcObject* object;
+  if (!value) {
+    return;
+  }
+  object = (struct GcObject*)value - 1;
+  if (!gcContains(object) || object->marked) {
+    return;
+  }
+  object->marked = 1;
+  if (gcMarkStackCount == gcMarkStackSize) {
+    gcMarkStackSize = gcMarkStackSize ? 2 * gcMarkStackSize : 1024;
+    gcMarkStack = realloc(gcMarkStack, gcMarkStackSize * sizeof(struct GcObject*));
+  }
+  gcMarkStack[gcMarkStackCount++] = object;
+}
+
+#ifndef __APPLE__
+static int gcCompareMaps(const void* a, const void* b) {
+  char* x = ((const struct GcStackMap*)a)->returnAddress;
+  char* y = ((const struct GcStackMap*)b)->returnAddress;
+  return x < y ? -1 : x > y;
+}
+
+static struct GcStackMap* gcFindMap(void* returnAddress) {
+  struct GcStackMap key;
+  key.returnAddress = returnAddress;
+  return bsearch(&key, __start_lang_stackmaps, __stop_lang_stackmaps - __start_lang_stackmaps,
+                 sizeof(struct GcStackMap), gcCompareMaps);
+}
+#endif
+
+static double gcMilliseconds() {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1000.0 + t.tv_nsec / 1000000.0;
+}
+
+// Marks everything reachable from the frames, starting at the frame
+// of the method that called gc_alloc, and frees everything else.
+static void gcCollect(void** frame, void* returnAddress) {
+#ifndef __APPLE__
+  static int sorted = 0;
+  double start = gcMilliseconds();
+  double pause;
+  struct GcStackMap* map;
+  struct GcObject** link;
+  int i;
+
+  if (!sorted) {
+    qsort(__start_lang_stackmaps, __stop_lang_stackmaps - __start_lang_stackmaps,
+          sizeof(struct GcStackMap), gcCompareMaps);
+    sorted = 1;
+  }
+
+  // the frames of the program end at the call of Main_main from main
+  while ((map = gcFindMap(returnAddress))) {
+    for (i = 1; i <= map->offsets[0]; i++) {
+      gcMark(*(void**)((char*)frame + map->offsets[i]));
+    }
+    returnAddress = frame[1];
+    frame = frame[0];
+  }
+
+  while (gcMarkStackCount) {
+    struct GcObject* object = gcMarkStack[--gcMarkStackCount];
+    for (i = 1; i <= object->type->pointers[0]; i++) {
+      gcMark(*(void**)((char*)(object + 1) + object->type->pointers[i]));
+    }
+  }
+
+  memset(gcTable, 0, gcTableSize * sizeof(struct GcObject*));
+  gcTableCount = 0;
+  gcLive = 0;
+  for (link = &gcObjects; *link;) {
+    struct GcObject* object = *link;
+    if (object->marked) {
+      object->marked = 0;
+      gcInsert(object);
+      gcLive += object->type->size;
+      link = &object->next;
+    } else {
+      *link = object->next;
+      free(object);
+      gcFreedObjects++;
+    }
+  }
+
+  gcAllocated = 0;
+  gcThreshold = gcLive > GC_MIN_HEAP ? gcLive : GC_MIN_HEAP;
+  pause = gcMilliseconds() - start;
+  gcCollections++;
+  gcTotalPause += pause;
+  if (pause > gcMaxPause) {
+    gcMaxPause = pause;
+  }
+#endif
+}
+
+// Called by the code for new with the size and descriptor of the
+// class, and the frame pointer of the method creating the object.
+void* gc_alloc(int size, struct GcClass* type, void** frame) {
+  struct GcObject* object;
+  if (gcAllocated >= gcThreshold) {
+    gcCollect(frame, __builtin_return_address(0));
+  }
+
+  object = malloc(sizeof(struct GcObject) + size);
+  if (!object) {
+    fprintf(stderr, "Out of memory\n");
+    exit(1);
+  }
+  memset(object + 1, 0, size);
+  object->type = type;
+  object->marked = 0;
+  object->next = gcObjects;
+  gcObjects = object;
+  gcInsert(object);
+
+  gcAllocated += size;
+  if (gcLive + gcAllocated > gcPeakHeap) {
+    gcPeakHeap = gcLive + gcAllocated;
+  }
+  return object + 1;
+}
+
+static void writeGcStats() {
+  if (!getenv("LANG_GC_STATS")) {
+    return;
+  }
+  fprintf(stderr, "gc: %d collections, %ld objects freed, peak heap %ld bytes, live %ld bytes\n",
+          gcCollections, gcFreedObjects, gcPeakHeap, gcLive + gcAllocated);
+  fprintf(stderr, "gc: pauses %.3f ms in total, %.3f ms at most, %.3f ms on average\n",
+          gcTotalPause, gcMaxPause, gcCollections ? gcTotalPause / gcCollections : 0.0);
+}
+
+#ifndef __APPLE__
+// Programs compiled with `lang --profile` have a profile counter
+// for every method, loop and branch. The linker collects them into
+// the lang_profile section, between the two symbols below (which
+// are null for programs compiled without --profile).
+struct ProfileCounter {
+  unsigned long long count;
+  unsigned long long cycles;
+  const char* method;
+  int line;
+  int kind;
+};
+
+extern struct ProfileCounter __start_lang_profile[] __attribute__((weak));
+extern struct ProfileCounter __stop_lang_profile[] __attribute__((weak));
+
+// Writes the profile to the file named by LANG_PROFILE, or to
+// profile.out: one line for every counter, with the method, the
+// source line, the kind of counter, the count and the cycles (which
+// are only measured for methods, with --profile=time).
+static void writeProfile() {
+  static const char* kinds[] = { "method", "loop", "then", "else" };
+  struct ProfileCounter* counter;
+  const char* path;
+  FILE* file;
+
+  if (&__start_lang_profile[0] == &__stop_lang_profile[0]) {
+    return;
+  }
+  path = getenv("LANG_PROFILE");
+  file = fopen(path ? path : "profile.out", "w");
+  if (!file) {
+    perror("profile");
+    return;
+  }
+  fprintf(file, "# method\tline\tkind\tcount\tcycles\n");
+  for (counter = __start_lang_profile; counter != __stop_lang_profile; counter++) {
+    fprintf(file, "%s\t%d\t%s\t%llu\t%llu\n", counter->method, counter->line,
+            kinds[counter->kind], counter->count, counter->cycles);
+  }
+  fclose(file);
+}
+#endif
+
 int main() {
   // Call the Main_main function from the linked assembly
   Main_main();
+#ifndef __APPLE__
+  writeProfile();
+#endif
+  writeGcStats();
   return 0;
 }
@@ -0,0 +1,247 @@
+#include "timereport.hpp"
+#include "typecheck.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <new>
+
+#include <sys/resource.h>
+
+// Every allocation made with new is counted (per thread, so the
+// counting costs nothing in the parallel compilation modes).
+static thread_local long allocationCount = 0;
+static thread_local long allocatedBytes = 0;
+
+// Every form of new and delete is replaced, and all of them allocate
+// with malloc and free with free, so memory is never released by a
+// different allocator than the one that gave it out.
+static void* countedAllocation(size_t size) {
+  allocationCount++;
+  allocatedBytes += size;
+  void* p = malloc(size ? size : 1);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+static void release(void* p) noexcept {
+  free(p);
+}
+
+void* operator new(size_t size) {
+  return countedAllocation(size);
+}
+
+void* operator new[](size_t size) {
+  return countedAllocation(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  try {
+    return countedAllocation(size);
+  } catch (const std::bad_alloc&) {
+    return NULL;
+  }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  try {
+    return countedAllocation(size);
+  } catch (const std::bad_alloc&) {
+    return NULL;
+  }
+}
+
+void operator delete(void* p) noexcept {
+  release(p);
+}
+
+void operator delete[](void* p) noexcept {
+  release(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  release(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+  release(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+  release(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+  release(p);
+}
+
+static double wallTime() {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static double cpuTime() {
+  struct timespec t;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &t);
+  return t.tv_sec * 1000.0 + t.tv_nsec / 1000000.0;
+}
+
+// Returns the peak resident set size in kilobytes. Linux keeps the
+// peak from getrusage across exec, so a compiler started by a large
+// process would report that process's peak; the peak of the current
+// program (VmHWM) is read from /proc instead where it exists.
+static long peakRss() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, 6, "VmHWM:") == 0) {
+      return atol(line.c_str() + 6);
+    }
+  }
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+void TimeReport::beginPhase() {
+  startAllocations = allocationCount;
+  startAllocatedBytes = allocatedBytes;
+  startLookups = symbolLookups;
+  startCpu = cpuTime();
+  startWall = wallTime();
+}
+
+void TimeReport::endPhase(const std::string& name) {
+  PhaseReport phase;
+  phase.wallTime = wallTime() - startWall;
+  phase.cpuTime = cpuTime() - startCpu;
+  phase.name = name;
+  phase.peakRss = peakRss();
+  phase.allocations = allocationCount - startAllocations;
+  phase.allocatedBytes = allocatedBytes - startAllocatedBytes;
+  phase.symbolLookups = symbolLookups - startLookups;
+  phases.push_back(phase);
+}
+
+// The NodeCounter visitor counts the nodes of every kind in the AST.
+class NodeCounter : public Visitor {
+public:
+  std::map<std::string, long>* counts;
+
+  void count(const char* kind, ASTNode* node) {
+    (*counts)[kind]++;
+    node->visit_children(this);
+  }
+
+  virtual void visitProgramNode(ProgramNode* node) { count("Program", node); }
+  virtual void visitClassNode(ClassNode* node) { count("Class", node); }
+  virtual void visitMethodNode(MethodNode* node) { count("Method", node); }
+  virtual void visitMethodBodyNode(MethodBodyNode* node) { count("MethodBody", node); }
+  virtual void visitParameterNode(ParameterNode* node) { count("Parameter", node); }
+  virtual void visitDeclarationNode(DeclarationNode* node) { count("Declaration", node); }
+  virtual void visitReturnStatementNode(ReturnStatementNode* node) { count("ReturnStatement", node); }
+  virtual void visitAssignmentNode(AssignmentNode* node) { count("Assignment", node); }
+  virtual void visitCallNode(CallNode* node) { count("Call", node); }
+  virtual void visitIfElseNode(IfElseNode* node) { count("IfElse", node); }
+  virtual void visitWhileNode(WhileNode* node) { count("While", node); }
+  virtual void visitDoWhileNode(DoWhileNode* node) { count("DoWhile", node); }
+  virtual void visitPrintNode(PrintNode* node) { count("Print", node); }
+  virtual void visitPlusNode(PlusNode* node) { count("Plus", node); }
+  virtual void visitMinusNode(MinusNode* node) { count("Minus", node); }
+  virtual void visitTimesNode(TimesNode* node) { count("Times", node); }
+  virtual void visitDivideNode(DivideNode* node) { count("Divide", node); }
+  virtual void visitGreaterNode(GreaterNode* node) { count("Greater", node); }
+  virtual void visitGreaterEqualNode(GreaterEqualNode* node) { count("GreaterEqual", node); }
+  virtual void visitEqualNode(EqualNode* node) { count("Equal", node); }
+  virtual void visitAndNode(AndNode* node) { count("And", node); }
+  virtual void visitOrNode(OrNode* node) { count("Or", node); }
+  virtual void visitNotNode(NotNode* node) { count("Not", node); }
+  virtual void visitNegationNode(NegationNode* node) { count("Negation", node); }
+  virtual void visitMethodCallNode(MethodCallNode* node) { count("MethodCall", node); }
+  virtual void visitMemberAccessNode(MemberAccessNode* node) { count("MemberAccess", node); }
+  virtual void visitVariableNode(VariableNode* node) { count("Variable", node); }
+  virtual void visitIntegerLiteralNode(IntegerLiteralNode* node) { count("IntegerLiteral", node); }
+  virtual void visitBooleanLiteralNode(BooleanLiteralNode* node) { count("BooleanLiteral", node); }
+  virtual void visitNewNode(NewNode* node) { count("New", node); }
+  virtual void visitIntegerTypeNode(IntegerTypeNode* node) { count("IntegerType", node); }
+  virtual void visitBooleanTypeNode(BooleanTypeNode* node) { count("BooleanType", node); }
+  virtual void visitObjectTypeNode(ObjectTypeNode* node) { count("ObjectType", node); }
+  virtual void visitNoneNode(NoneNode* node) { count("None", node); }
+  virtual void visitIdentifierNode(IdentifierNode* node) { count("Identifier", node); }
+  virtual void visitIntegerNode(IntegerNode* node) { count("Integer", node); }
+};
+
+void TimeReport::countNodes(ProgramNode* program) {
+  NodeCounter counter;
+  counter.counts = &nodeCounts;
+  program->accept(&counter);
+}
+
+static bool moreInstructions(const std::pair<std::string, int>& a, const std::pair<std::string, int>& b) {
+  return a.second > b.second;
+}
+
+void TimeReport::print(std::ostream& out) {
+  out << std::fixed << std::setprecision(3);
+  out << "phase           wall ms     cpu ms   peak rss kb  allocations      bytes    lookups" << std::endl;
+  for (size_t i = 0; i < phases.size(); i++) {
+    PhaseReport& p = phases[i];
+    out << std::left << std::setw(10) << p.name << std::right
+        << std::setw(13) << p.wallTime << std::setw(11) << p.cpuTime << std::setw(14) << p.peakRss
+        << std::setw(13) << p.allocations << std::setw(11) << p.allocatedBytes << std::setw(11) << p.symbolLookups << std::endl;
+  }
+  out << "(lexing took " << lexTime << " ms of the parse)" << std::endl;
+
+  long nodes = 0;
+  for (std::map<std::string, long>::iterator it = nodeCounts.begin(); it != nodeCounts.end(); it++) {
+    nodes += it->second;
+  }
+  out << std::endl << "AST nodes: " << nodes << std::endl;
+  for (std::map<std::string, long>::iterator it = nodeCounts.begin(); it != nodeCounts.end(); it++) {
+    out << "  " << std::left << std::setw(16) << it->first << std::right << std::setw(10) << it->second << std::endl;
+  }
+
+  // only the largest methods are listed; the JSON report has them all
+  std::vector<std::pair<std::string, int> > methods = instructionCounts;
+  std::stable_sort(methods.begin(), methods.end(), moreInstructions);
+  long instructions = 0;
+  for (size_t i = 0; i < methods.size(); i++) {
+    instructions += methods[i].second;
+  }
+  out << std::endl << "Instructions: " << instructions << " in " << methods.size() << " methods" << std::endl;
+  for (size_t i = 0; i < methods.size() && i < 10; i++) {
+    out << "  " << std::left << std::setw(30) << methods[i].first << std::right << std::setw(8) << methods[i].second << std::endl;
+  }
+}
+
+void TimeReport::printJson(std::ostream& out) {
+  out << std::fixed << std::setprecision(3);
+  out << "{" << std::endl << "  \"phases\": [";
+  for (size_t i = 0; i < phases.size(); i++) {
+    PhaseReport& p = phases[i];
+    out << (i ? "," : "") << std::endl
+        << "    {\"name\": \"" << p.name << "\", \"wall_ms\": " << p.wallTime << ", \"cpu_ms\": " << p.cpuTime
+        << ", \"peak_rss_kb\": " << p.peakRss << ", \"allocations\": " << p.allocations
+        << ", \"allocated_bytes\": " << p.allocatedBytes << ", \"symbol_lookups\": " << p.symbolLookups << "}";
+  }
+  out << std::endl << "  ]," << std::endl;
+  out << "  \"lex_ms\": " << lexTime << "," << std::endl;
+
+  out << "  \"ast_nodes\": {";
+  for (std::map<std::string, long>::iterator it = nodeCounts.begin(); it != nodeCounts.end(); it++) {
+    out << (it == nodeCounts.begin() ? "" : ",") << std::endl << "    \"" << it->first << "\": " << it->second;
+  }
+  out << std::endl << "  }," << std::endl;
+
+  // method names are identifiers, so they never need escaping
+  out << "  \"instructions\": {";
+  for (size_t i = 0; i < instructionCounts.size(); i++) {
+    out << (i ? "," : "") << std::endl << "    \"" << instructionCounts[i].first << "\": " << instructionCounts[i].second;
+  }
+  out << std::endl << "  }" << std::endl << "}" << std::endl;
+}
@@ -0,0 +1,63 @@
+#ifndef __TIMEREPORT_HPP
+#define __TIMEREPORT_HPP
+
+#include "ast.hpp"
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// This file defines the report printed by --time-report: where the
+// time and memory of a compilation go, phase by phase, along with
+// counts of the work done (AST nodes, symbol table lookups and
+// generated instructions).
+
+// Defines the measurements for one phase of the compiler. Peak RSS
+// is the process's peak resident set size when the phase ended.
+struct PhaseReport {
+  std::string name;
+  double wallTime;
+  double cpuTime;
+  long peakRss;
+  long allocations;
+  long allocatedBytes;
+  long symbolLookups;
+};
+
+class TimeReport {
+private:
+  // The counters when the current phase began
+  double startWall;
+  double startCpu;
+  long startAllocations;
+  long startAllocatedBytes;
+  long startLookups;
+
+public:
+  std::vector<PhaseReport> phases;
+
+  // The time spent in the lexer, which runs inside the parse phase
+  double lexTime;
+
+  // The number of AST nodes of every kind
+  std::map<std::string, long> nodeCounts;
+
+  // The number of instructions generated for every method
+  std::vector<std::pair<std::string, int> > instructionCounts;
+
+  TimeReport() : lexTime(0) {}
+
+  // Phases are timed between these calls, and may not overlap.
+  void beginPhase();
+  void endPhase(const std::string& name);
+
+  void countNodes(ProgramNode* program);
+
+  // Print the report as text or as a JSON object.
+  void print(std::ostream& out);
+  void printJson(std::ostream& out);
+};
+
+#endif
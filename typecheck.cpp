@@ -1,65 +1,72 @@
 #include "typecheck.hpp"
 
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
 // Defines the function used to throw type errors. The possible
 // type errors are defined as an enumeration in the header file.
 void typeError(TypeErrorCode code) {
+  throw TypeErrorException(code);
+}
+
+// Returns the message displayed for each type error.
+std::string typeErrorMessage(TypeErrorCode code) {
   switch (code) {
     case undefined_variable:
-      std::cerr << "Undefined variable." << std::endl;
-      break;
+      return "Undefined variable.";
     case undefined_method:
-      std::cerr << "Method does not exist." << std::endl;
-      break;
+      return "Method does not exist.";
     case undefined_class:
-      std::cerr << "Class does not exist." << std::endl;
-      break;
+      return "Class does not exist.";
     case undefined_member:
-      std::cerr << "Class member does not exist." << std::endl;
-      break;
+      return "Class member does not exist.";
     case not_object:
-      std::cerr << "Variable is not an object." << std::endl;
-      break;
+      return "Variable is not an object.";
     case expression_type_mismatch:
-      std::cerr << "Expression types do not match." << std::endl;
-      break;
+      return "Expression types do not match.";
     case argument_number_mismatch:
-      std::cerr << "Method called with incorrect number of arguments." << std::endl;
-      break;
+      return "Method called with incorrect number of arguments.";
     case argument_type_mismatch:
-      std::cerr << "Method called with argument of incorrect type." << std::endl;
-      break;
+      return "Method called with argument of incorrect type.";
     case while_predicate_type_mismatch:
-      std::cerr << "Predicate of while loop is not boolean." << std::endl;
-      break;
+      return "Predicate of while loop is not boolean.";
     case do_while_predicate_type_mismatch:
-      std::cerr << "Predicate of do while loop is not boolean." << std::endl;
-      break;
+      return "Predicate of do while loop is not boolean.";
     case if_predicate_type_mismatch:
-      std::cerr << "Predicate of if statement is not boolean." << std::endl;
-      break;
+      return "Predicate of if statement is not boolean.";
     case assignment_type_mismatch:
-      std::cerr << "Left and right hand sides of assignment types mismatch." << std::endl;
-      break;
+      return "Left and right hand sides of assignment types mismatch.";
     case return_type_mismatch:
-      std::cerr << "Return statement type does not match declared return type." << std::endl;
-      break;
+      return "Return statement type does not match declared return type.";
     case constructor_returns_type:
-      std::cerr << "Class constructor returns a value." << std::endl;
-      break;
+      return "Class constructor returns a value.";
     case no_main_class:
-      std::cerr << "The \"Main\" class was not found." << std::endl;
-      break;
+      return "The \"Main\" class was not found.";
     case main_class_members_present:
-      std::cerr << "The \"Main\" class has members." << std::endl;
-      break;
+      return "The \"Main\" class has members.";
     case no_main_method:
-      std::cerr << "The \"Main\" class does not have a \"main\" method." << std::endl;
-      break;
+      return "The \"Main\" class does not have a \"main\" method.";
     case main_method_incorrect_signature:
-      std::cerr << "The \"main\" method of the \"Main\" class has an incorrect signature." << std::endl;
-      break;
+      return "The \"main\" method of the \"Main\" class has an incorrect signature.";
+  }
+  return "";
+}
+
+thread_local long symbolLookups = 0;
+
+void deleteClassTable(ClassTable* classTable) {
+  for (ClassTable::iterator c = classTable->begin(); c != classTable->end(); c++) {
+    for (MethodTable::iterator m = c->second.methods->begin(); m != c->second.methods->end(); m++) {
+      delete m->second.variables;
+      delete m->second.parameters;
+    }
+    delete c->second.methods;
+    delete c->second.members;
   }
-  exit(1);
+  delete classTable;
 }
 
 static CompoundType typeMap(TypeNode* t) {
@@ -104,14 +111,15 @@ void checkArguments(std::string methodName, MethodTable* methodTable, std::list<
   }
 }
 
-bool findMethod(std::string methodName, std::string className, ClassTable* classTable, std::list<ExpressionNode*>* callParamList, ASTNode* node) {
+bool findMethod(std::string methodName, std::string className, TypeCheck* checker, std::list<ExpressionNode*>* callParamList, ASTNode* node) {
+  ClassTable* classTable = checker->classTable;
   while(className.compare("") != 0) {
-    if ((*classTable)[className].methods->count(methodName) == 1) {
-      checkArguments(methodName, (*classTable)[className].methods, callParamList);
-      updateType(node, (*classTable)[className].methods->at(methodName).returnType);
+    if (checker->methodDeclared(className, methodName)) {
+      checkArguments(methodName, classTable->at(className).methods, callParamList);
+      updateType(node, classTable->at(className).methods->at(methodName).returnType);
       return true;
     }
-    className = (*classTable)[className].superClassName;
+    className = classTable->at(className).superClassName;
   }
 
   return false;
@@ -119,11 +127,11 @@ bool findMethod(std::string methodName, std::string className, ClassTable* class
 
 bool findMember(std::string memberName, std::string className, ClassTable* classTable, IdentifierNode* node) {
   while(className.compare("")) {
-    if ((*classTable)[className].members->count(memberName)) {
-      updateType(node, (*classTable)[className].members->at(memberName).type);
+    if (classTable->at(className).members->count(memberName)) {
+      updateType(node, classTable->at(className).members->at(memberName).type);
       return true;
     }
-    className = (*classTable)[className].superClassName;
+    className = classTable->at(className).superClassName;
   }
 
   return false;
@@ -133,17 +141,39 @@ bool findMember(std::string memberName, std::string className, ClassTable* class
 // complete to build the symbol table and type check the program.
 // Not all functions must have code, many may be left empty.
 
-void TypeCheck::visitProgramNode(ProgramNode* node) {
+void TypeCheck::beginProgram() {
   classTable = new ClassTable();
+}
 
-  node->visit_children(this);
-
+void TypeCheck::endProgram() {
   if (!classTable->count("Main")) {
       typeError(no_main_class);
   }
 }
 
+void TypeCheck::visitProgramNode(ProgramNode* node) {
+  beginProgram();
+
+  node->visit_children(this);
+
+  endProgram();
+}
+
 void TypeCheck::visitClassNode(ClassNode* node) {
+  collectClass(node);
+
+  // visit methods
+  std::list<MethodNode*>* m = node->method_list;
+  if (m) {
+    for (std::list<MethodNode*>::iterator it = m->begin(); it != m->end(); it++) {
+      visitMethodNode(*it);
+    }
+  }
+
+  checkMainClass(node);
+}
+
+void TypeCheck::collectClass(ClassNode* node) {
   ClassInfo* classInfo = new ClassInfo();
 
   std::string name = node->identifier_1->name;
@@ -169,74 +199,65 @@ void TypeCheck::visitClassNode(ClassNode* node) {
     typeError(main_class_members_present);
   }
 
-  // visit local members
-  currentVariableTable = (*classTable)[name].members;
+  // Lay out the members. The superclass's members come first, at the
+  // same offsets as in the superclass, so code compiled for the
+  // superclass works on objects of every subclass. Then come the
+  // class's own integers and objects (one word each) and its booleans
+  // (one byte each, packed after the words). The size is rounded up
+  // to a whole word.
+  currentVariableTable = classTable->at(name).members;
   currentMemberOffset = 0;
-  std::list<DeclarationNode*>* d = node->declaration_list;
-  if (d) {
-    for (std::list<DeclarationNode*>::iterator it = d->begin(); it != d->end(); it++) {
-      VariableInfo* v = new VariableInfo();
-      v->type = typeMap((*it)->type);
-      v->offset = currentMemberOffset;
-      currentMemberOffset += 4;
-      v->size = 4;
-
-      std::string memberName = (*it)->identifier_list->front()->name;
-      currentVariableTable->insert(std::pair<std::string, VariableInfo>(memberName, *v));
-
-      delete v;
-    }
+  if (node->identifier_2) {
+    ClassInfo superInfo = classTable->at(node->identifier_2->name);
+    currentVariableTable->insert(superInfo.members->begin(), superInfo.members->end());
+    currentMemberOffset = superInfo.membersSize;
   }
 
-  // visit super class members 
-  if (node->identifier_2) {
-    std::string currentClassName = node->identifier_2->name;
-    while (currentClassName.compare("")) {
-      ClassInfo currentInfo = classTable->at(currentClassName);
-      for (std::map<std::string, VariableInfo>::iterator it = currentInfo.members->begin(); it != currentInfo.members->end(); it++) {
-        VariableInfo* v = new VariableInfo();
-        v->type = it->second.type;
-        v->offset = currentMemberOffset;
-        currentMemberOffset += 4;
-        v->size = 4;
-
-        std::string memberName = it->first;
-        currentVariableTable->insert(std::pair<std::string, VariableInfo>(memberName, *v));
-
-        delete v;
+  std::list<DeclarationNode*>* d = node->declaration_list;
+  for (int pass = 0; pass < 2; pass++) {
+    // the words in the first pass, the booleans in the second
+    for (std::list<DeclarationNode*>::iterator it = d->begin(); it != d->end(); it++) {
+      VariableInfo v;
+      v.type = typeMap((*it)->type);
+      bool boolean = v.type.baseType == bt_boolean;
+      if (boolean != (pass == 1)) {
+        continue;
       }
+      v.size = boolean ? 1 : 4;
+      v.offset = currentMemberOffset;
+      currentMemberOffset += v.size;
 
-      currentClassName = currentInfo.superClassName;
+      // a member declared again hides the superclass's member
+      std::string memberName = (*it)->identifier_list->front()->name;
+      (*currentVariableTable)[memberName] = v;
     }
   }
 
-  (*classTable)[name].membersSize = currentMemberOffset;
+  classTable->at(name).membersSize = (currentMemberOffset + 3) / 4 * 4;
 
-
-
-  // visit methods
   currentVariableTable = NULL;
-  std::list<MethodNode*>* m = node->method_list;
-  if (m) {
-    for (std::list<MethodNode*>::iterator it = m->begin(); it != m->end(); it++) {
-      visitMethodNode(*it);
-    }
-  }
+}
 
+void TypeCheck::checkMainClass(ClassNode* node) {
   if (!node->identifier_1->name.compare("Main")) {
-    if (!(*classTable)[node->identifier_1->name].methods->count("main")) {
+    if (!classTable->at(node->identifier_1->name).methods->count("main")) {
       typeError(no_main_method);
-    } else if ((*classTable)[node->identifier_1->name].methods->at("main").parameters->size() > 0) {
+    } else if (classTable->at(node->identifier_1->name).methods->at("main").parameters->size() > 0) {
       typeError(main_method_incorrect_signature);
     }
   }
 }
 
 void TypeCheck::visitMethodNode(MethodNode* node) {
+  collectMethod(node);
+  checkMethodBody(node);
+}
+
+void TypeCheck::collectMethod(MethodNode* node) {
   // WE NEVER SET THE BASETYPE OF METHODNODES
 
   MethodInfo* methodInfo = new MethodInfo();
-  currentMethodTable = (*classTable)[currentClassName].methods;
+  currentMethodTable = classTable->at(currentClassName).methods;
 
   std::string name = node->identifier->name;
 
@@ -246,17 +267,20 @@ void TypeCheck::visitMethodNode(MethodNode* node) {
   node->methodbody->objectClassName = x.objectClassName;
 
   methodInfo->variables = new VariableTable();
-  currentLocalOffset = -4;
   currentVariableTable = methodInfo->variables;
 
-  
-
   // need to check that parameters are of correct type
   methodInfo->parameters = new std::list<CompoundType>();
   currentParameterOffset = 12;
   std::list<ParameterNode*>* p = node->parameter_list;
 
-  node->visit_children(this);
+  node->identifier->accept(this);
+  if (p) {
+    for (std::list<ParameterNode*>::iterator it = p->begin(); it != p->end(); it++) {
+      (*it)->accept(this);
+    }
+  }
+  node->type->accept(this);
 
   CompoundType t = typeMap(node->type);
   node->basetype = t.baseType;
@@ -268,6 +292,7 @@ void TypeCheck::visitMethodNode(MethodNode* node) {
     }
   }
 
+  methodInfo->localsSize = 0;
   currentMethodTable->insert(std::pair<std::string, MethodInfo>(name, *methodInfo));
   delete methodInfo;
 
@@ -276,8 +301,135 @@ void TypeCheck::visitMethodNode(MethodNode* node) {
       typeError(constructor_returns_type);
     }
   }
+}
+
+bool TypeCheck::classDeclared(const std::string& className) {
+  if (!classTable->count(className)) {
+    return false;
+  }
+  return !declarationSteps || declarationSteps->at(className) < currentStep;
+}
 
-  (*currentMethodTable)[name].localsSize = (-1) * (currentLocalOffset + 4);// + (currentParameterOffset - 12); 
+// throws std::out_of_range for an undeclared class, as at() does
+ClassInfo& TypeCheck::declaredClass(const std::string& className) {
+  if (!classDeclared(className)) {
+    throw std::out_of_range("class " + className);
+  }
+  return classTable->at(className);
+}
+
+bool TypeCheck::methodDeclared(const std::string& className, const std::string& methodName) {
+  if (!classTable->at(className).methods->count(methodName)) {
+    return false;
+  }
+  return !declarationSteps || declarationSteps->at(className + "." + methodName) < currentStep;
+}
+
+void TypeCheck::checkMethodBody(MethodNode* node) {
+  MethodInfo& methodInfo = classTable->at(currentClassName).methods->at(node->identifier->name);
+
+  currentLocalOffset = -4;
+  currentVariableTable = methodInfo.variables;
+
+  node->methodbody->accept(this);
+
+  methodInfo.localsSize = (-1) * (currentLocalOffset + 4);// + (currentParameterOffset - 12); 
+}
+
+// Parallel type checking. The class table is first built for the
+// whole program by collecting every class and method signature in
+// source order; the method bodies are then checked concurrently, each
+// by its own TypeCheck, against the finished (and no longer modified)
+// class table. Every step is numbered in the order the sequential
+// checker performs it, so that when several steps fail, the error
+// reported is the one the sequential checker would have found first.
+// A body only sees the classes and methods collected before its step
+// (see TypeCheck::declarationSteps), so it accepts and rejects the
+// same programs the sequential checker does.
+ClassTable* typeCheckParallel(ProgramNode* program, int threads) {
+  TypeCheck collector;
+  collector.beginProgram();
+
+  struct BodyTask {
+    ClassNode* classNode;
+    MethodNode* methodNode;
+    int step;
+  };
+  std::vector<BodyTask> tasks;
+  std::map<std::string, int> declarationSteps;
+
+  int step = 0;
+  int errorStep = -1;
+  TypeErrorCode errorCode = no_main_class;
+  try {
+    for (std::list<ClassNode*>::iterator c = program->class_list->begin(); c != program->class_list->end(); c++) {
+      std::string className = (*c)->identifier_1->name;
+      declarationSteps.insert(std::make_pair(className, ++step));
+      collector.collectClass(*c);
+      if ((*c)->method_list) {
+        for (std::list<MethodNode*>::iterator m = (*c)->method_list->begin(); m != (*c)->method_list->end(); m++) {
+          declarationSteps.insert(std::make_pair(className + "." + (*m)->identifier->name, ++step));
+          collector.collectMethod(*m);
+          BodyTask task = { *c, *m, ++step };
+          tasks.push_back(task);
+        }
+      }
+      step++;
+      collector.checkMainClass(*c);
+    }
+    step++;
+    collector.endProgram();
+  } catch (TypeErrorException& e) {
+    errorStep = step;
+    errorCode = e.code;
+  }
+
+  // what each body threw: a TypeErrorException, or the
+  // std::out_of_range of a lookup of an undeclared class
+  std::vector<std::exception_ptr> taskErrors(tasks.size());
+  std::atomic<size_t> next(0);
+
+  auto worker = [&]() {
+    for (size_t i = next++; i < tasks.size(); i = next++) {
+      if (errorStep != -1 && tasks[i].step > errorStep) {
+        continue;
+      }
+      TypeCheck checker;
+      checker.classTable = collector.classTable;
+      checker.currentClassName = tasks[i].classNode->identifier_1->name;
+      checker.currentMethodTable = checker.classTable->at(checker.currentClassName).methods;
+      checker.declarationSteps = &declarationSteps;
+      checker.currentStep = tasks[i].step;
+      try {
+        checker.checkMethodBody(tasks[i].methodNode);
+      } catch (...) {
+        taskErrors[i] = std::current_exception();
+      }
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for (int i = 1; i < threads; i++) {
+    pool.push_back(std::thread(worker));
+  }
+  worker();
+  for (size_t i = 0; i < pool.size(); i++) {
+    pool[i].join();
+  }
+
+  // tasks are in source order, so the first failed body is the earliest
+  for (size_t i = 0; i < tasks.size(); i++) {
+    if (taskErrors[i] && (errorStep == -1 || tasks[i].step < errorStep)) {
+      deleteClassTable(collector.classTable);
+      std::rethrow_exception(taskErrors[i]);
+    }
+  }
+  if (errorStep != -1) {
+    deleteClassTable(collector.classTable);
+    typeError(errorCode);
+  }
+
+  return collector.classTable;
 }
 
 void TypeCheck::visitMethodBodyNode(MethodBodyNode* node) {
@@ -287,7 +439,7 @@ void TypeCheck::visitMethodBodyNode(MethodBodyNode* node) {
     if (node->basetype != node->returnstatement->basetype || node->objectClassName != node->returnstatement->objectClassName) {
       bool superClassFound = false;
       if (node->returnstatement->basetype == bt_object) {
-        std::string className = classTable->at(node->returnstatement->objectClassName).superClassName;
+        std::string className = declaredClass(node->returnstatement->objectClassName).superClassName;
         while(className.compare("") != 0) {
           if (node->objectClassName == className) {
             superClassFound = true;
@@ -308,6 +460,7 @@ void TypeCheck::visitMethodBodyNode(MethodBodyNode* node) {
 }
 
 void TypeCheck::visitParameterNode(ParameterNode* node) {
+  node->visit_children(this);
   if (classTable->count(node->type->objectClassName) != 0 || node->type->basetype == bt_boolean || node->type->basetype == bt_integer) {
     CompoundType t = typeMap(node->type);
     node->basetype = t.baseType;
@@ -328,7 +481,7 @@ void TypeCheck::visitParameterNode(ParameterNode* node) {
 
 void TypeCheck::visitDeclarationNode(DeclarationNode* node) {
   node->visit_children(this);
-  if (classTable->count(node->type->objectClassName) != 0 || node->type->basetype == bt_boolean || node->type->basetype == bt_integer) {
+  if (classDeclared(node->type->objectClassName) || node->type->basetype == bt_boolean || node->type->basetype == bt_integer) {
     CompoundType t = typeMap(node->type);
     node->basetype = t.baseType;
     node->objectClassName = t.objectClassName;
@@ -377,11 +530,11 @@ void TypeCheck::visitAssignmentNode(AssignmentNode* node) {
     }
 
     if (found) {
-      if (!classTable->count(node->identifier_1->objectClassName)) {
+      if (!classDeclared(node->identifier_1->objectClassName)) {
         typeError(not_object);
       }
       // check id 2 is a member of id 1
-      VariableTable* memberTable = (*classTable)[node->identifier_1->objectClassName].members;
+      VariableTable* memberTable = classTable->at(node->identifier_1->objectClassName).members;
       if (memberTable->count(node->identifier_2->name)) {
         updateType(node->identifier_2, memberTable->at(node->identifier_2->name).type);
         if (node->identifier_2->basetype != node->expression->basetype || node->identifier_2->objectClassName != node->expression->objectClassName) {
@@ -573,7 +726,7 @@ void TypeCheck::visitMethodCallNode(MethodCallNode* node) {
   // no dot operator
   if (node->identifier_2 == NULL) {
   	// SHOULD WE BE UPDATING THE TYPE OF ID 1 HERE OR UPDATING NODE ITSELF?
-    found = findMethod(node->identifier_1->name, currentClassName, classTable, node->expression_list, node);//->identifier_1);
+    found = findMethod(node->identifier_1->name, currentClassName, this, node->expression_list, node);//->identifier_1);
 
     if (!found) {
       typeError(undefined_method);
@@ -593,12 +746,12 @@ void TypeCheck::visitMethodCallNode(MethodCallNode* node) {
 
     if (foundVar) {
       // check variable is an object
-      if (!classTable->count(node->identifier_1->objectClassName)) {
+      if (!classDeclared(node->identifier_1->objectClassName)) {
         typeError(not_object);
       }
 
       
-      found = findMethod(node->identifier_2->name, node->identifier_1->objectClassName, classTable, node->expression_list, node);
+      found = findMethod(node->identifier_2->name, node->identifier_1->objectClassName, this, node->expression_list, node);
       if (!found) {
         typeError(undefined_method);
       }
@@ -620,36 +773,36 @@ void TypeCheck::visitMemberAccessNode(MemberAccessNode* node) {
   std::string className = currentClassName;
   if (!found) {
     while(className.compare("")) {
-      if ((*classTable)[className].members->count(node->identifier_1->name)) {
+      if (classTable->at(className).members->count(node->identifier_1->name)) {
         found = true;
-        node->identifier_1->basetype = (*classTable)[className].members->at(node->identifier_1->name).type.baseType;
-        node->identifier_1->objectClassName = (*classTable)[className].members->at(node->identifier_1->name).type.objectClassName;
+        node->identifier_1->basetype = classTable->at(className).members->at(node->identifier_1->name).type.baseType;
+        node->identifier_1->objectClassName = classTable->at(className).members->at(node->identifier_1->name).type.objectClassName;
         break;
       }
-      className = (*classTable)[className].superClassName;
+      className = classTable->at(className).superClassName;
     }
   }
 
   // found
   if (found) {
-    if (!classTable->count(node->identifier_1->objectClassName)) {
+    if (!classDeclared(node->identifier_1->objectClassName)) {
       typeError(not_object);
     }
-    if ((*classTable)[node->identifier_1->objectClassName].members->count(node->identifier_2->name)) {
-      node->identifier_2->basetype = (*classTable)[node->identifier_1->objectClassName].members->at(node->identifier_2->name).type.baseType;
-      node->identifier_2->objectClassName = (*classTable)[node->identifier_1->objectClassName].members->at(node->identifier_2->name).type.objectClassName;
+    if (classTable->at(node->identifier_1->objectClassName).members->count(node->identifier_2->name)) {
+      node->identifier_2->basetype = classTable->at(node->identifier_1->objectClassName).members->at(node->identifier_2->name).type.baseType;
+      node->identifier_2->objectClassName = classTable->at(node->identifier_1->objectClassName).members->at(node->identifier_2->name).type.objectClassName;
     }
 
     bool id2Found = false;
     std::string className = node->identifier_1->objectClassName;
     while(className.compare("")) {
-      if ((*classTable)[className].members->count(node->identifier_2->name)) {
+      if (classTable->at(className).members->count(node->identifier_2->name)) {
         id2Found = true;
-        node->identifier_2->basetype = (*classTable)[className].members->at(node->identifier_2->name).type.baseType;
-        node->identifier_2->objectClassName = (*classTable)[className].members->at(node->identifier_2->name).type.objectClassName;
+        node->identifier_2->basetype = classTable->at(className).members->at(node->identifier_2->name).type.baseType;
+        node->identifier_2->objectClassName = classTable->at(className).members->at(node->identifier_2->name).type.objectClassName;
         break;
       }
-      className = (*classTable)[className].superClassName;
+      className = classTable->at(className).superClassName;
     }
     if (!id2Found) {
       typeError(undefined_member);
@@ -680,9 +833,9 @@ void TypeCheck::visitVariableNode(VariableNode* node) {
     }
   }
   // Check member variables
-  else if ((*classTable)[className].members->count(identifier->name)) {
+  else if (classTable->at(className).members->count(identifier->name)) {
     found = true;
-    CompoundType c = (*classTable)[className].members->at(identifier->name).type;
+    CompoundType c = classTable->at(className).members->at(identifier->name).type;
     node->basetype = c.baseType;
     node->objectClassName = "";
     if (node->basetype == bt_object) {
@@ -692,11 +845,11 @@ void TypeCheck::visitVariableNode(VariableNode* node) {
 
   if (!found) {
     // Check all superclass variables
-    std::string superName = (*classTable)[className].superClassName;
+    std::string superName = classTable->at(className).superClassName;
     while(superName.compare("")) {
-      if ((*classTable)[superName].members->count(identifier->name)) {
+      if (classTable->at(superName).members->count(identifier->name)) {
         found = true;
-        CompoundType c = (*classTable)[superName].members->at(identifier->name).type;
+        CompoundType c = classTable->at(superName).members->at(identifier->name).type;
         node->basetype = c.baseType;
         node->objectClassName = "";
         if (node->basetype == bt_object) {
@@ -704,7 +857,7 @@ void TypeCheck::visitVariableNode(VariableNode* node) {
         }
         break;
       }
-      superName = (*classTable)[superName].superClassName;
+      superName = classTable->at(superName).superClassName;
     }
   }
 
@@ -724,7 +877,7 @@ void TypeCheck::visitBooleanLiteralNode(BooleanLiteralNode* node) {
 }
 
 void TypeCheck::visitNewNode(NewNode* node) {
-  if ((*classTable).count(node->identifier->name)) {
+  if (classDeclared(node->identifier->name)) {
     node->visit_children(this);
     node->basetype = bt_object;
     node->objectClassName = node->identifier->name;
@@ -849,3 +1002,159 @@ void print(ClassTable classTable, int indent) {
 void print(ClassTable classTable) {
   print(classTable, 0);
 }
+
+void printLayout(ClassTable* classTable, std::ostream& out) {
+  for (ClassTable::iterator it = classTable->begin(); it != classTable->end(); it++) {
+    std::map<int, std::pair<std::string, VariableInfo> > members;
+    for (VariableTable::iterator m = it->second.members->begin(); m != it->second.members->end(); m++) {
+      members[m->second.offset] = *m;
+    }
+    out << it->first << ": " << it->second.membersSize << " bytes (" << 4 * members.size()
+        << " with a word per member)" << std::endl;
+    for (std::map<int, std::pair<std::string, VariableInfo> >::iterator m = members.begin(); m != members.end(); m++) {
+      out << "  " << m->first << "\t" << m->second.second.size << "\t" << m->second.first
+          << " " << string(m->second.second.type) << std::endl;
+    }
+  }
+}
+
+// The following functions write and read class table entries in a
+// line based text format, used to store them outside the compiler.
+// Types are written as integer, boolean, none or object:ClassName.
+
+static void writeType(std::ostream& out, CompoundType type) {
+  switch (type.baseType) {
+    case bt_integer:
+      out << "integer";
+      break;
+    case bt_boolean:
+      out << "boolean";
+      break;
+    case bt_none:
+      out << "none";
+      break;
+    case bt_object:
+      out << "object:" << type.objectClassName;
+      break;
+  }
+}
+
+static bool readType(std::istream& in, CompoundType& type) {
+  std::string word;
+  if (!(in >> word)) {
+    return false;
+  }
+  type.objectClassName = "";
+  if (word == "integer") {
+    type.baseType = bt_integer;
+  } else if (word == "boolean") {
+    type.baseType = bt_boolean;
+  } else if (word == "none") {
+    type.baseType = bt_none;
+  } else if (word.compare(0, 7, "object:") == 0) {
+    type.baseType = bt_object;
+    type.objectClassName = word.substr(7);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+static void writeVariable(std::ostream& out, const std::string& name, const VariableInfo& info) {
+  out << name << " ";
+  writeType(out, info.type);
+  out << " " << info.offset << " " << info.size << std::endl;
+}
+
+static bool readVariable(std::istream& in, VariableTable* table) {
+  std::string name;
+  VariableInfo info;
+  if (!(in >> name) || !readType(in, info.type) || !(in >> info.offset >> info.size)) {
+    return false;
+  }
+  table->insert(std::pair<std::string, VariableInfo>(name, info));
+  return true;
+}
+
+void writeClassInfo(std::ostream& out, const std::string& name, const ClassInfo& info, bool withVariables) {
+  out << "class " << name << " " << (info.superClassName.empty() ? "-" : info.superClassName) << " " << info.membersSize << std::endl;
+  for (VariableTable::iterator it = info.members->begin(); it != info.members->end(); it++) {
+    out << "member ";
+    writeVariable(out, it->first, it->second);
+  }
+  for (MethodTable::iterator it = info.methods->begin(); it != info.methods->end(); it++) {
+    out << "method " << it->first << " ";
+    writeType(out, it->second.returnType);
+    out << " " << it->second.localsSize << " " << it->second.parameters->size();
+    for (std::list<CompoundType>::iterator p = it->second.parameters->begin(); p != it->second.parameters->end(); p++) {
+      out << " ";
+      writeType(out, *p);
+    }
+    out << std::endl;
+    if (withVariables) {
+      for (VariableTable::iterator v = it->second.variables->begin(); v != it->second.variables->end(); v++) {
+        out << "variable ";
+        writeVariable(out, v->first, v->second);
+      }
+    }
+  }
+  out << "end" << std::endl;
+}
+
+bool readClassInfo(std::istream& in, std::string& name, ClassInfo& info) {
+  std::string word;
+  if (!(in >> word) || word != "class" || !(in >> name >> info.superClassName >> info.membersSize)) {
+    return false;
+  }
+  if (info.superClassName == "-") {
+    info.superClassName = "";
+  }
+  info.members = new VariableTable();
+  info.methods = new MethodTable();
+
+  MethodInfo* method = NULL;
+  while (in >> word) {
+    if (word == "end") {
+      return true;
+    } else if (word == "member") {
+      if (!readVariable(in, info.members)) {
+        break;
+      }
+    } else if (word == "method") {
+      std::string methodName;
+      MethodInfo methodInfo;
+      size_t numParams;
+      if (!(in >> methodName) || !readType(in, methodInfo.returnType) || !(in >> methodInfo.localsSize >> numParams)) {
+        break;
+      }
+      methodInfo.parameters = new std::list<CompoundType>();
+      methodInfo.variables = new VariableTable();
+      for (size_t i = 0; i < numParams; i++) {
+        CompoundType type;
+        if (!readType(in, type)) {
+          break;
+        }
+        methodInfo.parameters->push_back(type);
+      }
+      method = &(*info.methods)[methodName];
+      *method = methodInfo;
+      if (method->parameters->size() != numParams) {
+        break;
+      }
+    } else if (word == "variable") {
+      if (!method || !readVariable(in, method->variables)) {
+        break;
+      }
+    } else {
+      break;
+    }
+  }
+
+  for (MethodTable::iterator it = info.methods->begin(); it != info.methods->end(); it++) {
+    delete it->second.variables;
+    delete it->second.parameters;
+  }
+  delete info.methods;
+  delete info.members;
+  return false;
+}
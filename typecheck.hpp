@@ -17,16 +17,40 @@ typedef struct compoundtype {
 // Defines the information for a variable. This will be the
 // data in the variable table (each variable will map to one
 // of these). Includes the type, the offset, and the size
-// (always 4 bytes or 1 word in our language).
+// (4 bytes or 1 word, except for boolean members of objects,
+// which take 1 byte).
 typedef struct variableinfo {
   CompoundType type;
   int offset;
   int size;
 } VariableInfo;
 
+// Counts the lookups made in the symbol tables on the current
+// thread (reported by the compiler's --time-report).
+extern thread_local long symbolLookups;
+
+// All the symbol tables below are maps from a name to the
+// information for that name, which count their lookups.
+template<typename Info>
+class SymbolTable : public std::map<std::string, Info> {
+public:
+  Info& at(const std::string& name) {
+    symbolLookups++;
+    return std::map<std::string, Info>::at(name);
+  }
+  const Info& at(const std::string& name) const {
+    symbolLookups++;
+    return std::map<std::string, Info>::at(name);
+  }
+  size_t count(const std::string& name) const {
+    symbolLookups++;
+    return std::map<std::string, Info>::count(name);
+  }
+};
+
 // Defines a variable table. Maps from a string (variable
 // name) to a variable info.
-typedef std::map<std::string, VariableInfo> VariableTable;
+typedef SymbolTable<VariableInfo> VariableTable;
 
 // Defines the information for a method. This will be the
 // data in the method table (each method will map to one
@@ -44,7 +68,7 @@ typedef struct methodinfo {
 
 // Defines a method table. Maps from a string (method name)
 // to a method info.
-typedef std::map<std::string, MethodInfo> MethodTable;
+typedef SymbolTable<MethodInfo> MethodTable;
 
 // Defines the information for a class. This will be the
 // data in the class table (each class will map to one
@@ -61,12 +85,27 @@ typedef struct classinfo {
 
 // Defines a class table. Maps from a string (class name)
 // to a class info.
-typedef std::map<std::string, ClassInfo> ClassTable;
+typedef SymbolTable<ClassInfo> ClassTable;
+
+// Write and read one class table entry in a text format (used to
+// store class table entries in files). writeClassInfo omits the
+// methods' variable tables unless withVariables is set. readClassInfo
+// allocates the entry's tables and returns false if the input is
+// not a well formed entry.
+void writeClassInfo(std::ostream& out, const std::string& name, const ClassInfo& info, bool withVariables);
+bool readClassInfo(std::istream& in, std::string& name, ClassInfo& info);
+
+// Frees a class table along with all of the tables it owns.
+void deleteClassTable(ClassTable* classTable);
 
 // This function will print the symbol table. The functions are
 // at the bottom of this file, and do not need modification.
 void print(ClassTable classTable);
 
+// Prints the layout of every class: its size, and the offset and size
+// of every member (booleans take a byte, everything else a word).
+void printLayout(ClassTable* classTable, std::ostream& out);
+
 // Defines all the possible type errors that can be thrown
 // by the type checker. These are used to print strings out
 // that describe the error.
@@ -91,11 +130,22 @@ typedef enum {
   main_method_incorrect_signature
 } TypeErrorCode;
 
-// Declares a a function which will display type errors, then
-// terminate the program with an error status code. The
+// Type errors are reported by throwing a TypeErrorException
+// carrying the error code. Whoever runs the type checker catches
+// it and displays typeErrorMessage(code); the main program then
+// terminates with an error status code.
+struct TypeErrorException {
+  TypeErrorCode code;
+  TypeErrorException(TypeErrorCode code) : code(code) {}
+};
+
+// Declares a a function which will throw type errors. The
 // possible type errors are defined as an enumeration above.
 void typeError(TypeErrorCode code);
 
+// Returns the message to display for a type error.
+std::string typeErrorMessage(TypeErrorCode code);
+
 // This defines the TypeCheck visitor, which will visit the AST
 // and construct the symbol table. You will do all your
 // implementation of the symbol table construction in the
@@ -146,6 +196,43 @@ public:
   // This member allows you to keep track of the name of the
   // current class. This is necessary for type checking.
   std::string currentClassName;
+
+  // These functions start and finish the type checking of a
+  // whole program. visitProgramNode calls them around its
+  // children; the streaming pipeline in main.cpp calls them
+  // around the classes it checks one at a time with
+  // visitClassNode.
+  void beginProgram();
+  void endProgram();
+
+  // Type checking a class is split into the steps below.
+  // collectClass adds the class and its members to the class
+  // table, collectMethod adds a method's signature (return type
+  // and parameters) and checkMethodBody checks a method's body
+  // and adds its local variables. checkMainClass checks the
+  // requirements on the Main class once its methods are known.
+  // visitClassNode runs these steps for one class in order;
+  // typeCheckParallel collects every class first and then checks
+  // the method bodies concurrently.
+  void collectClass(ClassNode* node);
+  void collectMethod(MethodNode* node);
+  void checkMethodBody(MethodNode* node);
+  void checkMainClass(ClassNode* node);
+
+  // When typeCheckParallel checks a body, the class table already
+  // holds the classes and methods declared after it. It records the
+  // step at which each was collected (by name, and by Class.method),
+  // and the lookups below then only find what the sequential checker
+  // would have collected before the body's step. Without
+  // declarationSteps they find everything in the class table.
+  const std::map<std::string, int>* declarationSteps;
+  int currentStep;
+
+  TypeCheck() : declarationSteps(NULL), currentStep(0) {}
+
+  bool classDeclared(const std::string& className);
+  ClassInfo& declaredClass(const std::string& className);
+  bool methodDeclared(const std::string& className, const std::string& methodName);
   
   // All the visitor functions. You will need to write
   // appropriate implementation in the typecheck.cpp file.
@@ -187,6 +274,12 @@ public:
   virtual void visitIntegerNode(IntegerNode* node);
 };
 
+// Type checks the program, checking method bodies concurrently on
+// the given number of threads, and returns the class table. Throws
+// the same TypeErrorException the sequential TypeCheck visitor would
+// (the first error in source order).
+ClassTable* typeCheckParallel(ProgramNode* program, int threads);
+
 // The following functions are used to print the Symbol Table.
 // They do not need to be modified at all.
 